@@ -0,0 +1,39 @@
+// frame.hpp
+//
+// @brief Immutable, encoded message that can be shared
+//        by every client it is sent to.
+//
+// 17 October 2026
+
+#pragma once
+
+#include "protocol.hpp"
+
+#include <cstddef>
+#include <memory>
+#include <string_view>
+
+struct frame_t {
+    size_t len;                     // bytes of data in use
+    char data[MSG_FRAME_MAX_SIZE];  // message as it goes on the wire
+
+    ////
+    // @brief type of the encoded message
+    MsgType type() const
+    {
+        auto target_len = static_cast<unsigned char>(data[offsetof(wire_header_t, target_len)]);
+        return static_cast<MsgType>(target_len >> WIRE_TYPE_SHIFT);
+    }
+
+    ////
+    // @brief target of the encoded message, empty for a broadcast
+    std::string_view target() const
+    {
+        auto target_len = data[offsetof(wire_header_t, target_len)] & WIRE_TARGET_LEN_MASK;
+        return std::string_view(data + WIRE_HEADER_SIZE, target_len);
+    }
+};
+
+using frame_ptr_t = std::shared_ptr<const frame_t>;
+
+frame_ptr_t make_frame(const message_t &msg);
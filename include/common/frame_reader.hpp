@@ -0,0 +1,177 @@
+// frame_reader.hpp
+//
+// @brief Incremental decoder for messages read off
+//        of a non-blocking socket.
+//
+// 17 October 2026
+
+#pragma once
+
+#include "protocol.hpp"
+
+#include <cstddef>
+#include <cstring>
+#include <utility>
+
+#include <errno.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+
+constexpr auto FRAME_READ_BUFFER_SIZE = 4096;
+
+// Outcome of draining a socket with FrameReader::read_frames
+enum class ReadStatus : int {
+    AGAIN,      // socket drained -- wait for the next readiness event
+    END,        // peer closed the connection
+    ERROR,      // read error or malformed frame
+};
+
+// FrameReader keeps the partially decoded header/body of one
+// connection so that bytes can be consumed as they arrive instead
+// of blocking until a whole message is on the socket.
+class FrameReader final {
+public:
+    FrameReader():
+        state_(State::HEADER),
+        have_(0),
+        target_len_(0),
+        frame_{} {}
+
+    FrameReader(const FrameReader &rhs) = delete;
+    FrameReader& operator=(const FrameReader &rhs) = delete;
+
+    ////
+    // @brief read everything currently available on sock_fd and
+    //        hand each complete frame to on_frame
+    //
+    // @param[in]   sock_fd     socket to read from
+    // @param[in]   on_frame    callable taking a message_t&&
+    //
+    // @return ReadStatus describing why reading stopped
+    template<typename Handler>
+    ReadStatus read_frames(int sock_fd, Handler &&on_frame);
+
+    ////
+    // @brief consume n_bytes of input, emitting any completed frames
+    //
+    // @param[in]   data        bytes to consume
+    // @param[in]   n_bytes     number of bytes in data
+    // @param[in]   on_frame    callable taking a message_t&&
+    //
+    // @return  0 on success
+    //         -1 if a malformed frame was found
+    template<typename Handler>
+    int consume(const char *data, size_t n_bytes, Handler &&on_frame);
+
+    ////
+    // @brief true if part of a frame has been buffered
+    bool in_frame() const { return state_ != State::HEADER || have_ != 0; }
+
+private:
+    enum class State : int {
+        HEADER,
+        TARGET,
+        BODY,
+    };
+
+    template<typename Handler>
+    int next_state(Handler &&on_frame);
+
+    State state_;
+    size_t have_;       // bytes of the current state already decoded
+    size_t target_len_; // length of the target of the current frame
+    message_t frame_;   // frame currently being decoded
+    char header_[WIRE_HEADER_SIZE];
+    char buffer_[FRAME_READ_BUFFER_SIZE];
+};
+
+template<typename Handler>
+ReadStatus FrameReader::read_frames(int sock_fd, Handler &&on_frame)
+{
+    for (;;) {
+        ssize_t bytes_read = recv(sock_fd, buffer_, sizeof(buffer_), MSG_DONTWAIT);
+        if (bytes_read > 0) {
+            if (consume(buffer_, bytes_read, on_frame)) {
+                return ReadStatus::ERROR;
+            }
+        } else if (bytes_read == 0) {
+            return ReadStatus::END;
+        } else if (errno == EINTR) {
+            continue;
+        } else if (errno == EAGAIN || errno == EWOULDBLOCK) {
+            return ReadStatus::AGAIN;
+        } else {
+            return ReadStatus::ERROR;
+        }
+    }
+}
+
+template<typename Handler>
+int FrameReader::consume(const char *data, size_t n_bytes, Handler &&on_frame)
+{
+    while (n_bytes > 0) {
+        char *dest = nullptr;
+        size_t need = 0;
+        switch (state_) {
+            case State::HEADER:
+                dest = header_ + have_;
+                need = WIRE_HEADER_SIZE - have_;
+                break;
+            case State::TARGET:
+                dest = frame_.header.target + have_;
+                need = target_len_ - have_;
+                break;
+            case State::BODY:
+                dest = frame_.message + have_;
+                need = frame_.header.msg_len - have_;
+                break;
+        }
+
+        size_t n_copy = need < n_bytes ? need : n_bytes;
+        memcpy(dest, data, n_copy);
+        data += n_copy;
+        n_bytes -= n_copy;
+        have_ += n_copy;
+        if (n_copy < need) {
+            // wait for the rest of this header/target/body
+            break;
+        }
+
+        have_ = 0;
+        if (next_state(on_frame)) {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+// Advance past a completed state, skipping empty targets and
+// bodies and emitting the frame once the body is complete
+template<typename Handler>
+int FrameReader::next_state(Handler &&on_frame)
+{
+    if (state_ == State::HEADER) {
+        int target_len = decode_header(header_, frame_.header);
+        if (target_len == -1) {
+            return -1;
+        }
+        target_len_ = target_len;
+        state_ = State::TARGET;
+    } else if (state_ == State::TARGET) {
+        state_ = State::BODY;
+    } else {
+        state_ = State::HEADER;
+    }
+
+    if (state_ == State::TARGET && target_len_ == 0) {
+        state_ = State::BODY;
+    }
+    if (state_ == State::BODY && frame_.header.msg_len == 0) {
+        state_ = State::HEADER;
+    }
+    if (state_ == State::HEADER) {
+        on_frame(std::move(frame_));
+        frame_ = {};
+    }
+    return 0;
+}
@@ -1,4 +1,4 @@
-// log_util.hpp 
+// log_util.hpp
 //
 // @brief Logging utility functions.
 //
@@ -6,6 +6,9 @@
 
 #pragma once
 
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
 #include <type_traits>
 
 #include <sstream>
@@ -25,6 +28,129 @@ enum class LogPriority: int {
     DEBUG       = LOG_DEBUG
 };
 
+// Calls with a less urgent priority than this are compiled out,
+// build with -DLOG_COMPILED_PRIORITY=LOG_DEBUG to keep them
+#ifndef LOG_COMPILED_PRIORITY
+#define LOG_COMPILED_PRIORITY LOG_INFO
+#endif
+
+// Messages a single call site may log each second, the rest are counted
+// and reported with the next message that gets through
+constexpr uint32_t LOG_SITE_MAX_PER_SECOND = 20;
+
+// Size of an encoded record, arguments that do not fit are left out
+// and strings are truncated to fit
+constexpr size_t LOG_RECORD_SIZE = 256;
+
+// Records each thread can have waiting before new ones are dropped
+constexpr size_t LOG_RING_SIZE = 1024;
+
+// State of a single log call site, constant initialized so that
+// it costs no guard
+struct log_site_t {
+    constexpr log_site_t(const char *site_fmt, LogPriority site_priority):
+        fmt(site_fmt),
+        priority(site_priority),
+        window(0),
+        count(0),
+        suppressed(0) {}
+
+    const char *fmt;                    // lives as long as the program
+    LogPriority priority;
+    std::atomic<uint64_t> window;       // second that count is for
+    std::atomic<uint32_t> count;        // messages in the window
+    std::atomic<uint32_t> suppressed;   // dropped since the last message
+};
+
+// A record holds the call site and the arguments in binary. Nothing is
+// formatted on the caller's thread, strings are copied since they may
+// not outlive the call.
+struct log_record_t {
+    const log_site_t *site;
+    uint32_t suppressed;                // messages dropped before this one
+    uint16_t len;                       // bytes of args in use
+    char args[LOG_RECORD_SIZE - sizeof(const log_site_t *) - sizeof(uint32_t) - sizeof(uint16_t)];
+};
+
+static_assert(sizeof(log_record_t) == LOG_RECORD_SIZE, "log record must not contain padding");
+
+// Encodes arguments into a record, following the format so that a
+// string with a '*' precision copies no more than it will print
+class LogEncoder final {
+public:
+    LogEncoder(log_record_t &record);
+
+    void add_int(long long value);
+    void add_uint(unsigned long long value);
+    void add_double(double value);
+    void add_pointer(const void *value);
+    void add_string(const char *value);
+
+    ////
+    // @brief add one argument of any printf compatible type
+    template<typename T>
+    void add(T value)
+    {
+        if constexpr (std::is_same<T, char *>::value || std::is_same<T, const char *>::value) {
+            add_string(value);
+        } else if constexpr (std::is_floating_point<T>::value) {
+            add_double(value);
+        } else if constexpr (std::is_pointer<T>::value || std::is_null_pointer<T>::value) {
+            add_pointer(value);
+        } else if constexpr (std::is_enum<T>::value) {
+            add_int(static_cast<long long>(value));
+        } else if constexpr (std::is_signed<T>::value) {
+            add_int(value);
+        } else {
+            static_assert(std::is_integral<T>::value, "argument cannot be logged");
+            add_uint(value);
+        }
+    }
+
+private:
+    bool next_arg();
+    void done_arg();
+    bool put(char tag, const void *data, size_t len);
+
+    log_record_t &record_;
+    const char *fmt_;           // just after the conversion being filled
+    bool in_conversion_;        // a conversion has been found for the args
+    int stars_;                 // '*' arguments the conversion still needs
+    bool star_precision_;       // the conversion's precision is a '*'
+    long long precision_;       // -1 unless given by a '*'
+};
+
+bool log_admit(log_site_t &site);
+void log_submit(log_record_t &&record);
+void log_flush();
+void log_set_sink(void (*sink)(int priority, const char *message));
+
+////
+// @brief encode a message and hand it to the background thread
+//
+// @param[in]   site    call site of the message
+// @param[in]   args    arguments for the site's format
+//
+// @note never blocks. Messages over the site's rate or that find the
+//       thread's ring full are dropped.
+template<typename... Args>
+void log_write(log_site_t &site, Args... args)
+{
+    if (!log_admit(site)) {
+        return;
+    }
+    log_record_t record;
+    record.site = &site;
+    record.suppressed = site.suppressed.exchange(0, std::memory_order_relaxed);
+    LogEncoder encoder(record);
+    (encoder.add(args), ...);
+    log_submit(std::move(record));
+}
+
+// never called, it only has the compiler check arguments against the format
+inline void log_check_format(const char *, ...) __attribute__((format(printf, 1, 2)));
+inline void log_check_format(const char *, ...) {}
+
 #define log(_priority_, _fmt_, ...)         \
     do {                                    \
         static_assert(std::is_same<         \
@@ -32,5 +158,11 @@ enum class LogPriority: int {
                             decltype((_priority_)) \
                         >::type, LogPriority>::value, \
                     "priority is not a LogPriority");\
-        syslog(static_cast<int>((_priority_)), (_fmt_), ##__VA_ARGS__); \
+        if constexpr (static_cast<int>((_priority_)) <= LOG_COMPILED_PRIORITY) { \
+            static log_site_t _log_site_((_fmt_), (_priority_)); \
+            if (false) {                    \
+                log_check_format((_fmt_), ##__VA_ARGS__); \
+            }                               \
+            log_write(_log_site_, ##__VA_ARGS__); \
+        }                                   \
     } while (0)
@@ -0,0 +1,161 @@
+// metrics.hpp
+//
+// Counters, gauges and latency histograms that are
+// cheap to update from any thread.
+//
+// 17 October 2026
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Threads are spread over this many copies of each metric so that
+// updates from different threads rarely share a cache line. Reads add
+// the copies up.
+constexpr size_t METRICS_SHARDS = 8;
+
+// Histogram buckets split each power of two into 2^HISTOGRAM_SUB_BITS
+// equal parts, so a recorded value is known to within about 3%
+constexpr unsigned HISTOGRAM_SUB_BITS = 5;
+
+// Values from 2^HISTOGRAM_MAX_BITS up are counted in the last bucket
+constexpr unsigned HISTOGRAM_MAX_BITS = 48;
+
+constexpr size_t HISTOGRAM_BUCKETS = (HISTOGRAM_MAX_BITS - HISTOGRAM_SUB_BITS + 1) << HISTOGRAM_SUB_BITS;
+
+unsigned metrics_assign_shard();
+
+////
+// @brief copy of a metric updated by the calling thread
+inline unsigned metrics_shard()
+{
+    static thread_local const unsigned shard = metrics_assign_shard();
+    return shard;
+}
+
+// Total that only goes up, such as messages received
+class Counter final {
+public:
+    Counter() = default;
+    Counter(const Counter &rhs) = delete;
+    Counter& operator=(const Counter &rhs) = delete;
+
+    void add(uint64_t n = 1)
+    {
+        shards_[metrics_shard()].value.fetch_add(n, std::memory_order_relaxed);
+    }
+
+    uint64_t value() const;
+
+private:
+    struct alignas(64) shard_t {
+        std::atomic<uint64_t> value{0};
+    };
+    std::array<shard_t, METRICS_SHARDS> shards_;
+};
+
+// Level that goes up and down, such as open connections. A thread may
+// add and another subtract, only the sum over every shard has meaning.
+class Gauge final {
+public:
+    Gauge() = default;
+    Gauge(const Gauge &rhs) = delete;
+    Gauge& operator=(const Gauge &rhs) = delete;
+
+    void add(int64_t n = 1)
+    {
+        shards_[metrics_shard()].value.fetch_add(n, std::memory_order_relaxed);
+    }
+
+    void sub(int64_t n = 1) { add(-n); }
+
+    int64_t value() const;
+
+private:
+    struct alignas(64) shard_t {
+        std::atomic<int64_t> value{0};
+    };
+    std::array<shard_t, METRICS_SHARDS> shards_;
+};
+
+// Distribution of integer values, usually latencies in nanoseconds.
+// Buckets are log linear as in an HDR histogram so that small and large
+// values are both recorded with the same relative precision.
+class Histogram final {
+public:
+    Histogram() = default;
+    Histogram(const Histogram &rhs) = delete;
+    Histogram& operator=(const Histogram &rhs) = delete;
+
+    void record(uint64_t value)
+    {
+        auto &shard = shards_[metrics_shard()];
+        shard.buckets[bucket_of(value)].fetch_add(1, std::memory_order_relaxed);
+        shard.sum.fetch_add(value, std::memory_order_relaxed);
+    }
+
+    uint64_t count() const;
+    uint64_t sum() const;
+    uint64_t percentile(double percent) const;
+    uint64_t count_below(uint64_t limit) const;
+    uint64_t max() const;
+    std::vector<uint64_t> buckets() const;
+
+    static size_t bucket_of(uint64_t value);
+    static uint64_t bucket_low(size_t bucket);
+    static uint64_t bucket_high(size_t bucket);
+
+private:
+    struct alignas(64) shard_t {
+        std::atomic<uint64_t> sum{0};
+        std::array<std::atomic<uint64_t>, HISTOGRAM_BUCKETS> buckets{};
+    };
+    std::array<shard_t, METRICS_SHARDS> shards_;
+};
+
+// Named metrics, rendered in the Prometheus text format. Metrics are
+// created on first use and live as long as the registry, so callers
+// look them up once and keep the reference.
+class MetricsRegistry final {
+public:
+    MetricsRegistry() = default;
+    MetricsRegistry(const MetricsRegistry &rhs) = delete;
+    MetricsRegistry& operator=(const MetricsRegistry &rhs) = delete;
+
+    static MetricsRegistry &instance();
+
+    Counter &counter(const std::string &name, const std::string &help);
+    Gauge &gauge(const std::string &name, const std::string &help);
+    Histogram &histogram(const std::string &name, const std::string &help, double scale = 1.0);
+
+    std::string render() const;
+
+private:
+    enum class MetricType : int {
+        COUNTER,
+        GAUGE,
+        HISTOGRAM,
+    };
+
+    struct metric_t {
+        MetricType type;
+        std::string help;
+        double scale;                           // histogram unit in the output
+        std::unique_ptr<Counter> counter;
+        std::unique_ptr<Gauge> gauge;
+        std::unique_ptr<Histogram> histogram;
+    };
+
+    metric_t &find_or_add(const std::string &name, const std::string &help, MetricType type);
+
+    mutable std::mutex mutex_;                  // guards the map, not the values
+    std::map<std::string, metric_t> metrics_;   // sorted so output is stable
+};
@@ -0,0 +1,130 @@
+// mpsc_queue.hpp
+//
+// @brief Bounded, lock-free queue for many producers
+//        and a single consumer.
+//
+// 17 October 2026
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+// Each slot carries a sequence number that says whose turn it is:
+//      sequence == position        free for the producer claiming position
+//      sequence == position + 1    filled, ready for the consumer
+// Producers claim positions with a CAS on tail_ and never take a lock.
+// The consumer owns head_ outright.
+template<typename T>
+class MpscQueue final {
+public:
+    MpscQueue(size_t capacity);
+    ~MpscQueue() = default;
+
+    MpscQueue(const MpscQueue &rhs) = delete;
+    MpscQueue& operator=(const MpscQueue &rhs) = delete;
+
+    bool try_push(T &&value);
+    bool try_pop(T &value);
+    bool empty() const;
+
+    size_t capacity() const { return mask_ + 1; }
+
+private:
+    struct slot_t {
+        std::atomic<size_t> sequence;
+        T value;
+    };
+
+    std::unique_ptr<slot_t []> slots_;
+    size_t mask_;
+    alignas(64) std::atomic<size_t> tail_;  // next position for producers
+    alignas(64) size_t head_;               // next position for the consumer
+};
+
+////
+// @brief create a queue holding at least capacity values
+//
+// @param[in]   capacity    minimum capacity, rounded up to a power of two
+template<typename T>
+MpscQueue<T>::MpscQueue(size_t capacity):
+    mask_(0),
+    tail_(0),
+    head_(0)
+{
+    size_t size = 1;
+    while (size < capacity) {
+        size <<= 1;
+    }
+    slots_.reset(new slot_t[size]);
+    mask_ = size - 1;
+    for (size_t i = 0; i < size; i++) {
+        slots_[i].sequence.store(i, std::memory_order_relaxed);
+    }
+}
+
+////
+// @brief add a value to the queue, safe from any thread
+//
+// @param[in]   value   value to add -- only moved from on success
+//
+// @return true if value was queued
+//         false if the queue is full
+template<typename T>
+bool MpscQueue<T>::try_push(T &&value)
+{
+    size_t position = tail_.load(std::memory_order_relaxed);
+    slot_t *slot = nullptr;
+    for (;;) {
+        slot = &slots_[position & mask_];
+        size_t sequence = slot->sequence.load(std::memory_order_acquire);
+        auto diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position);
+        if (diff == 0) {
+            if (tail_.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                break;
+            }
+        } else if (diff < 0) {
+            // the consumer has not freed this slot yet
+            return false;
+        } else {
+            position = tail_.load(std::memory_order_relaxed);
+        }
+    }
+    slot->value = std::move(value);
+    slot->sequence.store(position + 1, std::memory_order_release);
+    return true;
+}
+
+////
+// @brief take the oldest value off the queue, consumer thread only
+//
+// @param[out]  value   value taken off the queue
+//
+// @return true if a value was taken
+//         false if the queue is empty
+template<typename T>
+bool MpscQueue<T>::try_pop(T &value)
+{
+    slot_t &slot = slots_[head_ & mask_];
+    size_t sequence = slot.sequence.load(std::memory_order_acquire);
+    if (sequence != head_ + 1) {
+        return false;
+    }
+    value = std::move(slot.value);
+    slot.value = T();
+    slot.sequence.store(head_ + mask_ + 1, std::memory_order_release);
+    head_++;
+    return true;
+}
+
+////
+// @brief true if there is nothing for the consumer, consumer thread only
+template<typename T>
+bool MpscQueue<T>::empty() const
+{
+    const slot_t &slot = slots_[head_ & mask_];
+    return slot.sequence.load(std::memory_order_acquire) != head_ + 1;
+}
@@ -9,21 +9,38 @@
 
 #include "protocol.hpp"
 
+#include <netinet/in.h>
 #include <sys/socket.h>
 
 #include <utility>
 #include <string>
 
-int bind_socket(const char *address, const char *port, bool is_blocking);
+int bind_socket(const char *address, const char *port, bool is_blocking, bool reuse_port);
 
 int listen_socket(int socket_fd, int backlog);
 
+int set_nonblocking(int socket_fd);
+
+int set_keepalive(int socket_fd, int idle_s, int interval_s, int probes);
+
+int accept_socket(int socket_fd, struct sockaddr_storage *addr, socklen_t *addrlen);
+
 int connect_socket(const char *address, const char *port, bool is_blocking);
 
-int write_message(int sock_fd, message_t &msg);
+// Maximum number of messages written with a single writev
+constexpr size_t MAX_WRITE_BATCH = 64;
+
+int write_message(int sock_fd, const message_t &msg);
+
+int write_messages(int sock_fd, const message_t *const *msgs, size_t n_msgs);
 
 int read_message(int sock_fd, message_t &msg);
 
+// Longest address formatted by format_address, "[IPv6]:port" and a null
+constexpr size_t ADDRESS_MAX_SIZE = INET6_ADDRSTRLEN + 8;
+
+int format_address(const struct sockaddr_storage *addr_storage, char *buffer, size_t size, bool with_port);
+
 std::pair<std::string, bool> get_hostname(struct sockaddr_storage *addr_storage, socklen_t addrlen, int flags);
 
 int terminate_connection(int sock_fd, int flags);
@@ -7,17 +7,112 @@
 
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
 #include <string>
 
 constexpr auto MSG_DATA_MAX_SIZE = 400;
 
+// Maximum size of a target name including the terminating null
+constexpr auto MSG_TARGET_MAX_SIZE = 64;
+
+// Version written by encode_header. Version 1 frames, which have no
+// type, are still accepted.
+constexpr uint8_t PROTOCOL_VERSION = 2;
+constexpr uint8_t PROTOCOL_MIN_VERSION = 1;
+
+// Control frames carry no target or data. The server pings a client
+// that has been idle and a client answers a ping with a pong. A room
+// frame targets a room and its single byte of data is a RoomOp.
+enum class MsgType : uint8_t {
+    DATA = 0,
+    PING = 1,
+    PONG = 2,
+    ROOM = 3,
+};
+
+// Room frames sent by a client. The server answers LIST with a room
+// frame whose data is RoomOp::LIST followed by the names of the rooms
+// the client is in, each ended by a newline.
+enum class RoomOp : uint8_t {
+    JOIN = 1,
+    LEAVE = 2,
+    LIST = 3,
+};
+
+// A target starting with ROOM_PREFIX names a room. Data sent to a room
+// is delivered to its members other than the sender.
+constexpr char ROOM_PREFIX = '#';
+
 struct msg_header_t {
-    unsigned int   msg_len;
-    unsigned long  time_stamp;
-    const char    *target;
+    uint16_t msg_len;
+    uint64_t time_stamp;
+    char     target[MSG_TARGET_MAX_SIZE];  // empty for a broadcast
+    MsgType  type = MsgType::DATA;
 };
 
 struct message_t {
     msg_header_t header;
     char message[MSG_DATA_MAX_SIZE];
 };
+
+// Header as it is laid out on the wire. All fields are little-endian
+// and the header is followed by target_len bytes of target name (not
+// null terminated) and then msg_len bytes of message data. From version
+// 2 the top bits of target_len hold the MsgType.
+struct __attribute__((packed)) wire_header_t {
+    uint8_t  version;
+    uint16_t msg_len;
+    uint64_t time_stamp;
+    uint8_t  target_len;
+};
+
+constexpr uint8_t WIRE_TARGET_LEN_MASK = 0x3f;
+constexpr unsigned WIRE_TYPE_SHIFT = 6;
+
+static_assert(sizeof(wire_header_t) == 12, "wire header must not contain padding");
+static_assert(offsetof(wire_header_t, version) == 0, "unexpected wire header layout");
+static_assert(offsetof(wire_header_t, msg_len) == 1, "unexpected wire header layout");
+static_assert(offsetof(wire_header_t, time_stamp) == 3, "unexpected wire header layout");
+static_assert(offsetof(wire_header_t, target_len) == 11, "unexpected wire header layout");
+static_assert(MSG_DATA_MAX_SIZE <= UINT16_MAX, "message length must fit in msg_len");
+static_assert(MSG_TARGET_MAX_SIZE - 1 <= WIRE_TARGET_LEN_MASK, "target length must fit in target_len");
+
+constexpr size_t WIRE_HEADER_SIZE = sizeof(wire_header_t);
+constexpr size_t MSG_FRAME_MAX_SIZE = WIRE_HEADER_SIZE + (MSG_TARGET_MAX_SIZE - 1) + MSG_DATA_MAX_SIZE;
+
+// encode_header    encode the wire header and target of header into buffer
+//
+// @param[in]   header      header to encode
+// @param[out]  buffer      destination, at least WIRE_HEADER_SIZE + target length bytes
+// @param[in]   size        size of buffer
+//
+// @return  number of bytes encoded
+//         -1 if header is invalid or buffer is too small
+int encode_header(const msg_header_t &header, char *buffer, size_t size);
+
+// encode_message   encode a complete frame (header, target and data) into buffer
+//
+// @param[in]   msg         message to encode
+// @param[out]  buffer      destination, MSG_FRAME_MAX_SIZE bytes is always enough
+// @param[in]   size        size of buffer
+//
+// @return  number of bytes encoded
+//         -1 if msg is invalid or buffer is too small
+int encode_message(const message_t &msg, char *buffer, size_t size);
+
+// decode_header    decode WIRE_HEADER_SIZE bytes from buffer into header
+//
+// @param[in]   buffer      encoded wire header
+// @param[out]  header      msg_len, time_stamp and type are filled in
+//
+// @return  length of the target that follows the header
+//         -1 if the header is malformed
+int decode_header(const char *buffer, msg_header_t &header);
+
+// frame_size   number of bytes header will take up on the wire
+//
+// @param[in]   header      header to size
+//
+// @return size of the encoded frame
+size_t frame_size(const msg_header_t &header);
@@ -0,0 +1,32 @@
+// test_util.hpp
+//
+// Helpers shared by the tests and benchmarks
+//
+// 17 October 2026
+
+#pragma once
+
+#include <common/net_common.hpp>
+
+#include <catch2/catch_all.hpp>
+
+#include <string>
+
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+////
+// @brief find a port on 127.0.0.1 that nothing is listening on
+//
+// @return the port number as a string
+inline std::string free_port()
+{
+    int sock_fd = bind_socket("127.0.0.1", "0", true, false);
+    REQUIRE(sock_fd != -1);
+    struct sockaddr_in addr{};
+    socklen_t addrlen = sizeof(addr);
+    REQUIRE(getsockname(sock_fd, reinterpret_cast<struct sockaddr *>(&addr), &addrlen) == 0);
+    close(sock_fd);
+    return std::to_string(ntohs(addr.sin_port));
+}
@@ -17,6 +17,12 @@
 // @return none
 #define memzero(_addr_, _size_) memset((_addr_), 0, (_size_))
 
+// raise_fd_limit  allow as many open files as the hard limit
+//
+// @return the number of files the process may now have open,
+//         0 if the limit cannot be read
+auto raise_fd_limit() -> size_t;
+
 
 // Channel struct to provide RAII access to pipe
 // handles in a cleaner manner
@@ -36,3 +42,23 @@ private:
     int read_pipe;
     int write_pipe;
 };
+
+
+// Notifier used to wake a thread that is parked in an IoMultiplexor.
+// Backed by an eventfd on Linux and a non-blocking pipe elsewhere.
+class EventNotifier {
+public:
+    EventNotifier();
+    ~EventNotifier();
+    EventNotifier(const EventNotifier &rhs) = delete;
+    EventNotifier(EventNotifier &&rhs) = delete;
+    EventNotifier& operator=(const EventNotifier &rhs) = delete;
+
+    auto get_fd() -> int { return read_fd; }
+    auto notify() -> int;
+    auto drain() -> void;
+
+private:
+    int read_fd;
+    int write_fd;
+};
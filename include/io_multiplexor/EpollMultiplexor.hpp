@@ -5,24 +5,38 @@
 //
 // 25-April-2021
 
+#pragma once
+
 #include "IoMultiplexor.hpp"
 
+#include <memory>
+
+struct epoll_event;
+
 class EpollMultiplexor final: public IoMultiplexor  {
 public: 
     EpollMultiplexor(unsigned max_events);
     ~EpollMultiplexor();
     
     virtual int wait(struct timespec *timeout, std::vector<io_mplex_fd_info_t> &events) override;
+    virtual int wait(struct timespec *timeout, io_mplex_event_t *events, unsigned max_events) override;
 
     virtual int add(const io_mplex_fd_info_t &fd_info) override;
     virtual int add(const std::vector<io_mplex_fd_info_t> &fd_list) override;
     virtual int add(std::vector<io_mplex_fd_info_t> &&fd_list) override ;
 
+    virtual int modify(const io_mplex_fd_info_t &fd_info) override;
+
     virtual int remove(const int fd) override;
     virtual int remove(const std::vector<int> &fd_list) override;
     virtual int remove(std::vector<int> &&fd_list) override;
 
 private:
+    int wait_ready(struct timespec *timeout, unsigned max_events);
+
     virtual int flags_from_mplex(io_mplex_flags_t mplex_values) override;
     virtual io_mplex_flags_t flags_to_mplex(int epoll_values) override;
+
+    std::unique_ptr<struct epoll_event []> event_list_;  // reused by every wait
+    bool has_pwait2_;                                     // kernel supports epoll_pwait2
 };
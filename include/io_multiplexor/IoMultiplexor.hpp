@@ -8,7 +8,13 @@
 
 #pragma once
 
+#include "TimerWheel.hpp"
+
+#include <errno.h>
 #include <time.h>
+#include <sys/uio.h>
+
+#include <cstdint>
 
 #include <vector>
 #include <utility>
@@ -21,39 +27,99 @@ enum IoMultiplexorFlags : io_mplex_flags_t
    MPLEX_OUT       = 0x02,
    MPLEX_ONESHOT   = 0x04,
    MPLEX_EOF       = 0x08,
-   MPLEX_ERR       = 0x10 
+   MPLEX_ERR       = 0x10,
+   MPLEX_EDGE      = 0x20,     // report readiness once per change, drain until EAGAIN
+   MPLEX_EXCLUSIVE = 0x40,     // wake one of the waiters sharing an fd, add only
+   MPLEX_TIMER     = 0x80,     // reported by wait for a timer that expired
+   // completions, only from multiplexors where has_completions is true
+   MPLEX_ACCEPT    = 0x100,    // result is the accepted fd or -errno
+   MPLEX_RECV      = 0x200,    // result bytes are in buffer, 0 at end of file
+   MPLEX_SEND      = 0x400,    // result is the bytes sent or -errno
+   MPLEX_MORE      = 0x800     // the multishot operation is still armed
+};
+
+// Multiplexor implementations that can be asked for at runtime
+enum class MplexBackend : int {
+    NATIVE,     // epoll or kqueue
+    URING,      // io_uring, falls back to NATIVE if the kernel lacks it
 };
 
 struct io_mplex_fd_info_t {
     io_mplex_flags_t flags;
     io_mplex_flags_t filters;
     int fd;
+    void *data = nullptr;   // reported with each event for fd, see io_mplex_event_t
+};
+
+// A readiness event. An fd added with data is reported by its data so
+// that the caller can dispatch straight to the object it belongs to.
+// Otherwise it is reported by fd and data is nullptr.
+struct io_mplex_event_t {
+    io_mplex_flags_t filters;
+    int fd;         // may be -1 for an fd added with data
+    void *data;
+    int result;     // completions only
+    char *buffer;   // MPLEX_RECV only, hand back with release_buffer
 };
 
+// Timers started on a multiplexor are kept in a TimerWheel with
+// millisecond ticks. wait sleeps no longer than the next timer and
+// reports each one that expires as an MPLEX_TIMER event, with fd -1
+// and the timer's data. Timers belong to the thread that waits.
 class IoMultiplexor {
 public:
     IoMultiplexor(unsigned max_events):
         instance_fd_(0),
         max_events_(max_events),
-        n_events_(0) {}
+        n_events_(0),
+        timers_(clock_ms()) {}
     virtual ~IoMultiplexor() {}
     
     IoMultiplexor(const IoMultiplexor &rhs) = delete;
     IoMultiplexor& operator()(const IoMultiplexor& rhs) = delete;
 
     virtual unsigned get_events() const { return n_events_.load(); }
+    unsigned get_max_events() const { return max_events_; }
 
     virtual int wait(struct timespec *timeout, std::vector<io_mplex_fd_info_t> &events) = 0;
+
+    // fill at most max_events caller owned events without allocating,
+    // only one thread may wait on a multiplexor at a time
+    virtual int wait(struct timespec *timeout, io_mplex_event_t *events, unsigned max_events) = 0;
     
     virtual int add(const io_mplex_fd_info_t &fd_info)              = 0;
     virtual int add(const std::vector<io_mplex_fd_info_t> &fd_list) = 0;
     virtual int add(std::vector<io_mplex_fd_info_t> &&fd_list)      = 0;
    
+    // change the flags and filters of an fd that was already added,
+    // also used to re-arm an MPLEX_ONESHOT fd
+    virtual int modify(const io_mplex_fd_info_t &fd_info)           = 0;
+
     virtual int remove(const int fd)                                = 0;
     virtual int remove(const std::vector<int> &fd_list)             = 0;
     virtual int remove(std::vector<int> &&fd_list)                  = 0;
 
+    // Completion based operations. Their results are reported by wait
+    // with the operation's data. Backends without them fail with ENOTSUP.
+    virtual bool has_completions() const { return false; }
+    virtual int accept_multishot(int listen_fd, void *data)
+        { (void)listen_fd; (void)data; errno = ENOTSUP; return -1; }
+    virtual int recv_multishot(int fd, void *data)
+        { (void)fd; (void)data; errno = ENOTSUP; return -1; }
+    virtual int send(int fd, const struct iovec *iov, int iovcnt, void *data)
+        { (void)fd; (void)iov; (void)iovcnt; (void)data; errno = ENOTSUP; return -1; }
+    virtual void release_buffer(const io_mplex_event_t &event) { (void)event; }
+
+    void start_timer(mplex_timer_t &timer, uint64_t timeout_ms);
+    void stop_timer(mplex_timer_t &timer) { timers_.cancel(timer); }
+
+    static uint64_t clock_ms();
+
 protected:
+    struct timespec *timer_timeout(struct timespec *timeout, struct timespec &shortened);
+    int report_timers(io_mplex_event_t *events, int n_events, unsigned max_events);
+    int report_timers(std::vector<io_mplex_fd_info_t> &events);
+
     virtual int flags_from_mplex(io_mplex_flags_t mplex_values) = 0;
     virtual io_mplex_flags_t flags_to_mplex(int flags) = 0; 
 
@@ -61,4 +127,5 @@ protected:
     int instance_fd_;
     unsigned max_events_;
     std::atomic<unsigned> n_events_;
+    TimerWheel timers_;
 };
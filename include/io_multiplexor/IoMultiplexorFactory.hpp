@@ -5,6 +5,8 @@
 // 
 // 02-May-2021
 
+#pragma once
+
 #include "IoMultiplexor.hpp"
 #include "KqueueMultiplexor.hpp"
 #include "EpollMultiplexor.hpp"
@@ -16,18 +18,6 @@ public:
     IoMultiplexorFactory() = delete;
     ~IoMultiplexorFactory() = delete;
 
-    static std::unique_ptr<IoMultiplexor> get_multiplexor(unsigned max_events);
+    static std::unique_ptr<IoMultiplexor> get_multiplexor(unsigned max_events,
+                                                          MplexBackend backend = MplexBackend::NATIVE);
 };
-
-
-std::unique_ptr<IoMultiplexor> IoMultiplexorFactory::get_multiplexor(unsigned max_events)
-{
-#if __linux__
-    return std::unique_ptr<EpollMultiplexor>(new EpollMultiplexor(max_events));
-#elif __FreeBSD__
-    return std::unique_ptr<KqueueMultiplexor>(new KqueueMultiplexor(max_events));
-#else
-    #error UNSUPPORTED_PLATFORM
-#endif
-}
-
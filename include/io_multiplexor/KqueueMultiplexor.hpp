@@ -5,21 +5,29 @@
 //
 // 25-April-2021
 
+#pragma once
+
 #include "IoMultiplexor.hpp"
 
+#include <memory>
 #include <utility>
 
+struct kevent;
+
 class KqueueMultiplexor final: public IoMultiplexor  {
 public: 
     KqueueMultiplexor(unsigned max_events);
     ~KqueueMultiplexor();
     
     virtual int wait(struct timespec *timeout, std::vector<io_mplex_fd_info_t> &events) override;
+    virtual int wait(struct timespec *timeout, io_mplex_event_t *events, unsigned max_events) override;
     
     virtual int add(const io_mplex_fd_info_t &fd_info) override;
     virtual int add(const std::vector<io_mplex_fd_info_t> &fd_list) override;
     virtual int add(std::vector<io_mplex_fd_info_t> &&fd_list) override;
     
+    virtual int modify(const io_mplex_fd_info_t &fd_info) override;
+
     virtual int remove(const int fd) override;
     virtual int remove(const std::vector<int> &fd_list) override;
     virtual int remove(std::vector<int> &&fd_list) override;
@@ -27,4 +35,6 @@ public:
 private:
     virtual int flags_from_mplex(io_mplex_flags_t mplex_values) override;
     virtual io_mplex_flags_t flags_to_mplex(int kqueue_values) override;
+
+    std::unique_ptr<struct kevent []> event_list_;  // reused by every wait
 };
@@ -0,0 +1,70 @@
+// TimerWheel.hpp
+//
+// Hierarchical timer wheel used by IoMultiplexor
+// to report timers alongside readiness events.
+//
+// 17 October 2026
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// Timers are intrusive so that starting and stopping one never
+// allocates. The owner keeps the timer alive while it is scheduled.
+struct mplex_timer_t {
+    mplex_timer_t():
+        prev(nullptr),
+        next(nullptr),
+        expires(0),
+        data(nullptr) {}
+
+    bool is_active() const { return next != nullptr; }
+
+    mplex_timer_t *prev;
+    mplex_timer_t *next;
+    uint64_t expires;   // in ticks
+    void *data;         // reported with the timer's event
+};
+
+// Number of levels, each with 2^TIMER_WHEEL_BITS slots. With millisecond
+// ticks a timer can be up to 2^30 ms, about 12 days, away.
+constexpr unsigned TIMER_WHEEL_LEVELS = 5;
+constexpr unsigned TIMER_WHEEL_BITS = 6;
+constexpr unsigned TIMER_WHEEL_SLOTS = 1 << TIMER_WHEEL_BITS;
+constexpr uint64_t TIMER_WHEEL_MAX_TICKS = (uint64_t(1) << (TIMER_WHEEL_LEVELS * TIMER_WHEEL_BITS)) - 1;
+
+// Level 0 holds timers due within TIMER_WHEEL_SLOTS ticks, one slot per
+// tick. Each level above covers TIMER_WHEEL_SLOTS times as much time per
+// slot and is cascaded into the levels below as the wheel reaches it.
+// Starting and stopping a timer is O(1), and advancing costs O(1) per
+// timer per level plus a scan of the slots that are skipped over.
+class TimerWheel final {
+public:
+    TimerWheel(uint64_t now);
+    ~TimerWheel();
+
+    TimerWheel(const TimerWheel &rhs) = delete;
+    TimerWheel& operator=(const TimerWheel &rhs) = delete;
+
+    void schedule(mplex_timer_t &timer, uint64_t ticks);
+    void cancel(mplex_timer_t &timer);
+    void advance(uint64_t now);
+    mplex_timer_t *pop_expired();
+    int64_t next_timeout() const;
+
+    uint64_t now() const { return now_; }
+    size_t size() const { return size_; }
+
+private:
+    void insert(mplex_timer_t &timer);
+    void cascade(unsigned level);
+    void step();
+    uint64_t ticks_to_next() const;
+
+    uint64_t now_;
+    size_t size_;                   // scheduled or expired, not yet popped
+    // each slot and the expired list is a circular list around a sentinel
+    mplex_timer_t slots_[TIMER_WHEEL_LEVELS][TIMER_WHEEL_SLOTS];
+    mplex_timer_t expired_;
+};
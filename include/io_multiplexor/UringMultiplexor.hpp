@@ -0,0 +1,133 @@
+// UringMultiplexor.hpp
+//
+// Concrete multiplexor class for io_uring based
+// io multiplexing and completions on Linux.
+//
+// 17 October 2026
+
+#pragma once
+
+#include "IoMultiplexor.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <vector>
+
+#include <sys/uio.h>
+
+struct io_uring_sqe;
+struct io_uring_cqe;
+
+// Submission queue entries, completions may queue up to
+// URING_CQ_FACTOR times as many before they are reaped
+constexpr unsigned URING_SQ_ENTRIES = 256;
+constexpr unsigned URING_CQ_FACTOR = 8;
+
+// Buffers provided to the kernel for multishot recv
+constexpr unsigned URING_BUFFER_COUNT = 256;
+constexpr unsigned URING_BUFFER_SIZE = 4096;
+
+// Most iovecs taken by a single send
+constexpr int URING_SEND_MAX_IOV = 16;
+
+// Readiness is built on poll requests: a level triggered fd is re-armed
+// after each event, MPLEX_EDGE uses a multishot poll and MPLEX_ONESHOT is
+// armed again by modify. Everything queued is submitted by the next wait
+// together with reaping completions, so a batch of sends to many clients
+// costs a single io_uring_enter.
+//
+// Needs a kernel with timed waits and multishot recv (6.0 or later),
+// the constructor throws without them.
+class UringMultiplexor final: public IoMultiplexor {
+public:
+    UringMultiplexor(unsigned max_events);
+    ~UringMultiplexor();
+
+    virtual int wait(struct timespec *timeout, std::vector<io_mplex_fd_info_t> &events) override;
+    virtual int wait(struct timespec *timeout, io_mplex_event_t *events, unsigned max_events) override;
+
+    virtual int add(const io_mplex_fd_info_t &fd_info) override;
+    virtual int add(const std::vector<io_mplex_fd_info_t> &fd_list) override;
+    virtual int add(std::vector<io_mplex_fd_info_t> &&fd_list) override;
+
+    virtual int modify(const io_mplex_fd_info_t &fd_info) override;
+
+    virtual int remove(const int fd) override;
+    virtual int remove(const std::vector<int> &fd_list) override;
+    virtual int remove(std::vector<int> &&fd_list) override;
+
+    virtual bool has_completions() const override { return true; }
+    virtual int accept_multishot(int listen_fd, void *data) override;
+    virtual int recv_multishot(int fd, void *data) override;
+    virtual int send(int fd, const struct iovec *iov, int iovcnt, void *data) override;
+    virtual void release_buffer(const io_mplex_event_t &event) override;
+
+private:
+    enum class OpType : uint8_t {
+        POLL,
+        ACCEPT,
+        RECV,
+        SEND,
+    };
+
+    // An operation owns its slot until the kernel posts its final
+    // completion. A poll added with add keeps its slot while disarmed.
+    struct op_t {
+        OpType type;
+        bool armed;             // the kernel holds a request for this op
+        bool orphaned;          // replaced by modify, drop its completions
+        int fd;
+        uint32_t generation;    // of fd when the op was started
+        io_mplex_flags_t flags;
+        io_mplex_flags_t filters;
+        void *data;
+        struct iovec iov[URING_SEND_MAX_IOV];   // SEND only
+    };
+
+    struct fd_state_t {
+        uint32_t generation;    // bumped by remove to drop stale completions
+        int poll_op;            // op added for readiness, -1 if none
+    };
+
+    void teardown();
+    int setup_buffers();
+    fd_state_t &fd_state(int fd);
+    int new_op(OpType type, int fd, void *data);
+    void free_op(int index);
+    struct io_uring_sqe *get_sqe();
+    int arm_poll(int index);
+    void cancel(int fd, int index);
+    int submit(unsigned min_complete, struct timespec *timeout);
+    int reap(io_mplex_event_t *events, unsigned max_events);
+    bool complete(const struct io_uring_cqe &cqe, io_mplex_event_t &event);
+    void recycle_buffer(unsigned buffer_id);
+
+    virtual int flags_from_mplex(io_mplex_flags_t mplex_values) override;
+    virtual io_mplex_flags_t flags_to_mplex(int poll_values) override;
+
+    // rings shared with the kernel
+    void *sq_ring_;
+    size_t sq_ring_size_;
+    void *cq_ring_;
+    struct io_uring_sqe *sqes_;
+    size_t sqes_size_;
+    unsigned *sq_head_;
+    unsigned *sq_tail_;
+    unsigned sq_mask_;
+    unsigned *sq_array_;
+    unsigned sq_entries_;
+    unsigned *cq_head_;
+    unsigned *cq_tail_;
+    unsigned cq_mask_;
+    struct io_uring_cqe *cqes_;
+
+    // buffers handed to the kernel for multishot recv
+    std::unique_ptr<char []> buffers_;
+
+    std::deque<op_t> ops_;          // never moves, sends point into it
+    std::vector<int> free_ops_;
+    std::vector<fd_state_t> fds_;   // indexed by fd
+    std::unique_ptr<io_mplex_event_t []> event_list_;   // for the vector wait
+};
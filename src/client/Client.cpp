@@ -12,18 +12,47 @@
 #include <common/net_common.hpp>
 #include <io_multiplexor/IoMultiplexorFactory.hpp>
 
+#include <ctime>
 #include <exception>
+#include <stdexcept>
 #include <thread>
 
 #include <unistd.h>
 
 constexpr auto MAX_CLIENT_CONNECTIONS = 2;
 
-Client::Client(std::string address, std::string port):
+// Build a message to send to the server
+//
+// @param[in]   type        type of the frame
+// @param[in]   target      client name, room or empty for a broadcast
+// @param[in]   data        message data
+// @param[in]   size        bytes of data
+// @param[out]  msg         message to fill in
+//
+// @return  0 on success
+//         -1 if the target or data is too long
+int make_message(MsgType type, const std::string &target, const char *data, size_t size, message_t &msg)
+{
+    if (target.size() >= MSG_TARGET_MAX_SIZE || size > MSG_DATA_MAX_SIZE) {
+        return -1;
+    }
+    msg.header = {};
+    msg.header.type = type;
+    msg.header.msg_len = size;
+    msg.header.time_stamp = time(nullptr);
+    memcpy(msg.header.target, target.c_str(), target.size() + 1);
+    if (size > 0) {
+        memcpy(msg.message, data, size);
+    }
+    return 0;
+}
+
+Client::Client(std::string address, std::string port, message_handler_t on_message):
     address_{address},
     port_{port},
     client_socket_{0},
-    is_connected_{false} 
+    is_connected_{false},
+    on_message_{std::move(on_message)}
 {
     
     // The client only has two descriptors it waits on:
@@ -58,8 +87,9 @@ Client::~Client()
 //         non-zero on error
 auto Client::connect(const std::string &address, const std::string &port) -> int
 {
-     
-    auto sock_fd = connect_socket(address.c_str(), port.c_str(), false);
+    // blocking, so that writes wait for room in the socket. The
+    // receiving thread reads with MSG_DONTWAIT.
+    auto sock_fd = connect_socket(address.c_str(), port.c_str(), true);
     if (sock_fd == -1) {
         return sock_fd;
     }
@@ -79,29 +109,61 @@ auto Client::disconnect() -> int
 {
     if (is_connected_) {
         log(LogPriority::INFO, "shutting down client\n");
-        auto rc = terminate_connection(client_socket_, SHUT_WR);
-        if (rc != 0) {
-            log(LogPriority::ERROR, "failed to terminate client connection\n");
-            return rc;
-        }
         
         // the receiving thread must be running / joinable 
         // for there to be something to stop
         if (handler_.joinable()) {
             if (stop_channel_.write("0") != 1) {
-                rc = -1;
                 log(LogPriority::ERROR, "failed to stop server\n");
-                return rc;
+                return -1;
             }
             handler_.join();
         }
+
+        is_connected_ = false;
+        auto rc = terminate_connection(client_socket_, SHUT_WR);
+        if (rc != 0) {
+            log(LogPriority::ERROR, "failed to terminate client connection\n");
+            return rc;
+        }
     }
     return 0;
 }
 
-auto Client::send_message() -> int
+// Send data to a client, a room or, with an empty target, everyone
+//
+// @param[in]   target      name of the recipient
+// @param[in]   data        message data
+//
+// @return  0 on success
+//         -1 on error
+auto Client::send_message(const std::string &target, const std::string &data) -> int
+{
+    message_t msg;
+    if (make_message(MsgType::DATA, target, data.data(), data.size(), msg)) {
+        return -1;
+    }
+    return write_frame(msg);
+}
+
+auto Client::join_room(const std::string &room) -> int
 {
-    return -1;
+    message_t msg;
+    auto op = static_cast<char>(RoomOp::JOIN);
+    if (make_message(MsgType::ROOM, room, &op, 1, msg)) {
+        return -1;
+    }
+    return write_frame(msg);
+}
+
+auto Client::leave_room(const std::string &room) -> int
+{
+    message_t msg;
+    auto op = static_cast<char>(RoomOp::LEAVE);
+    if (make_message(MsgType::ROOM, room, &op, 1, msg)) {
+        return -1;
+    }
+    return write_frame(msg);
 }
 
 auto Client::get_members() -> int
@@ -114,8 +176,45 @@ auto Client::help() -> int
     return -1;
 }
 
-auto Client::receive_messages() -> void
+auto Client::write_frame(const message_t &msg) -> int
 {
+    if (!is_connected_) {
+        return -1;
+    }
+    std::lock_guard<std::mutex> lock(write_mutex_);
+    return write_message(client_socket_, msg);
 }
 
-
+// Hand every frame from the server to the message handler until the
+// client is stopped or the server closes the connection
+auto Client::receive_messages() -> void
+{
+    io_mplex_event_t events[MAX_CLIENT_CONNECTIONS];
+    message_t pong;
+    make_message(MsgType::PONG, "", nullptr, 0, pong);
+
+    for (;;) {
+        int n_events = io_mplex_->wait(nullptr, events, MAX_CLIENT_CONNECTIONS);
+        if (n_events == -1 && errno != EINTR) {
+            log(LogPriority::ERROR, "io_mplex wait error: %s\n", strerror(errno));
+            return;
+        }
+        for (int i = 0; i < n_events; i++) {
+            if (events[i].fd == stop_channel_.get_read_end()) {
+                return;
+            }
+            auto status = reader_.read_frames(client_socket_, [this, &pong](message_t &&message) {
+                if (message.header.type == MsgType::PING) {
+                    write_frame(pong);
+                } else if (message.header.type != MsgType::PONG && on_message_) {
+                    on_message_(message);
+                }
+            });
+            if (status != ReadStatus::AGAIN) {
+                log(LogPriority::INFO, "server closed the connection\n");
+                io_mplex_->remove(client_socket_);
+                break;
+            }
+        }
+    }
+}
@@ -5,16 +5,29 @@
 // 22 August 2021
 //
 
+#pragma once
+
+#include <common/frame_reader.hpp>
+#include <common/protocol.hpp>
 #include <common/utilities.hpp>
 #include <io_multiplexor/IoMultiplexor.hpp>
 
+#include <functional>
+#include <memory>
+#include <mutex>
 #include <string>
 #include <thread>
 
+// Called on the receiving thread with each data or room frame from the
+// server. Pings are answered by the client and never handed on.
+using message_handler_t = std::function<void(const message_t &message)>;
+
+// fill in msg as a frame of type to target carrying data
+int make_message(MsgType type, const std::string &target, const char *data, size_t size, message_t &msg);
 
 class Client final {
 public:
-    Client(std::string address, std::string port);
+    Client(std::string address, std::string port, message_handler_t on_message = nullptr);
     ~Client();
     Client(const Client &rhs) = delete;
     Client(Client &&rhs) = delete;
@@ -22,7 +35,9 @@ public:
 
     int connect(const std::string &address, const std::string &port);
     int disconnect();
-    int send_message();
+    int send_message(const std::string &target, const std::string &data);
+    int join_room(const std::string &room);
+    int leave_room(const std::string &room);
     int get_members();
     int help();
 
@@ -30,12 +45,16 @@ private:
     std::string address_;
     std::string port_;
     std::thread handler_;
-    
+
     int client_socket_;
     bool is_connected_;
-    
+
     std::unique_ptr<IoMultiplexor> io_mplex_;
     Channel stop_channel_;
+    message_handler_t on_message_;
+    FrameReader reader_;            // only used by the receiving thread
+    std::mutex write_mutex_;        // pongs are written by the receiving thread
 
+    int write_frame(const message_t &msg);
     void receive_messages();
 };
@@ -0,0 +1,379 @@
+// LoadGenerator.cpp
+//
+// Connections, send schedule and latency
+// measurement of the load generator.
+//
+// 17 October 2026
+
+#include "LoadGenerator.hpp"
+#include "Client.hpp"
+
+#include <common/log_util.hpp>
+#include <common/net_common.hpp>
+#include <io_multiplexor/IoMultiplexorFactory.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <stdexcept>
+#include <thread>
+
+#include <errno.h>
+#include <unistd.h>
+#include <sys/socket.h>
+
+// Events handled by a worker for each wait
+constexpr unsigned BENCH_MAX_EVENTS = 256;
+
+// Most messages a worker sends before it reads again when it is behind
+constexpr int BENCH_SEND_BURST = 64;
+
+static uint64_t clock_ns()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+////
+// @brief check the configuration
+//
+// @param[in]   config      connections, traffic and schedule
+//
+// @note throws std::runtime_error if the configuration is not usable
+LoadGenerator::LoadGenerator(const load_config_t &config):
+    config_(config),
+    start_ns_(0),
+    measure_ns_(0),
+    end_ns_(0)
+{
+    if (config_.connections == 0) {
+        throw std::runtime_error("at least one connection is needed");
+    }
+    if (config_.senders > config_.connections) {
+        throw std::runtime_error("more senders than connections");
+    }
+    if (config_.payload < BENCH_STAMP_SIZE || config_.payload > MSG_DATA_MAX_SIZE) {
+        throw std::runtime_error("payload must hold the send time and fit in a message");
+    }
+    if (config_.rate <= 0) {
+        throw std::runtime_error("rate must be positive");
+    }
+    if (config_.pattern == TrafficPattern::ROOM && config_.room_size < 2) {
+        throw std::runtime_error("rooms need at least two members");
+    }
+    if (config_.duration_s == 0) {
+        throw std::runtime_error("duration must be at least a second");
+    }
+    config_.threads = std::clamp(config_.threads, 1u, config_.connections);
+    if (config_.senders == 0) {
+        config_.senders = config_.connections;
+    }
+}
+
+LoadGenerator::~LoadGenerator()
+{
+    for (auto &conn : conns_) {
+        if (conn->fd != -1) {
+            close(conn->fd);
+        }
+    }
+}
+
+////
+// @brief connect, run the load and measure it
+//
+// @param[out]  report      what was sent and delivered in the measured
+//                          window
+//
+// @return  0 on success
+//         -1 if the connections could not be opened
+int LoadGenerator::run(load_report_t &report)
+{
+    if (open_connections()) {
+        return -1;
+    }
+
+    start_ns_ = clock_ns();
+    measure_ns_ = start_ns_ + config_.warmup_s * 1000000000ull;
+    end_ns_ = measure_ns_ + config_.duration_s * 1000000000ull;
+    std::vector<std::thread> threads;
+    for (auto &worker : workers_) {
+        threads.emplace_back(&LoadGenerator::run_worker, this, std::ref(worker));
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+
+    report = {};
+    report.connections = conns_.size();
+    report.seconds = config_.duration_s;
+    report.sent = sent_.value();
+    report.delivered = delivered_.value();
+    report.expected = expected_.value();
+    report.blocked = blocked_.value();
+    report.closed = closed_.value();
+    report.p50_ns = latency_.percentile(50);
+    report.p99_ns = latency_.percentile(99);
+    report.p999_ns = latency_.percentile(99.9);
+    report.max_ns = latency_.max();
+    return 0;
+}
+
+////
+// @brief open every connection, join rooms and hand the connections
+//        out to the workers
+//
+// @return  0 on success
+//         -1 on error
+//
+// @note connections are named by the server after their address, so
+//       the name a direct message is sent to is the next connection's
+//       local address
+int LoadGenerator::open_connections()
+{
+    std::vector<std::string> names;
+    for (unsigned i = 0; i < config_.connections; i++) {
+        auto conn = std::make_unique<bench_conn_t>();
+        conn->fd = connect_socket(config_.address.c_str(), config_.port.c_str(), true);
+        if (conn->fd == -1) {
+            log(LogPriority::ERROR, "unable to open connection %u\n", i);
+            return -1;
+        }
+        conns_.push_back(std::move(conn));
+
+        struct sockaddr_storage addr;
+        socklen_t addrlen = sizeof(addr);
+        char name[ADDRESS_MAX_SIZE];
+        if (getsockname(conns_.back()->fd, reinterpret_cast<struct sockaddr *>(&addr), &addrlen) ||
+                format_address(&addr, name, sizeof(name), true) == -1) {
+            log(LogPriority::ERROR, "unable to name connection %u\n", i);
+            return -1;
+        }
+        names.push_back(name);
+    }
+
+    unsigned n_conns = config_.connections;
+    workers_.resize(config_.threads);
+    for (unsigned i = 0; i < n_conns; i++) {
+        auto &conn = *conns_[i];
+        switch (config_.pattern) {
+            case TrafficPattern::BROADCAST:
+                conn.fan_out = n_conns - 1;
+                break;
+            case TrafficPattern::DIRECT:
+                conn.target = names[(i + 1) % n_conns];
+                conn.fan_out = 1;
+                break;
+            case TrafficPattern::ROOM:
+            {
+                unsigned first = i / config_.room_size * config_.room_size;
+                conn.target = "#bench" + std::to_string(i / config_.room_size);
+                conn.fan_out = std::min(config_.room_size, n_conns - first) - 1;
+
+                message_t join;
+                auto op = static_cast<char>(RoomOp::JOIN);
+                if (make_message(MsgType::ROOM, conn.target, &op, 1, join) || write_message(conn.fd, join)) {
+                    log(LogPriority::ERROR, "unable to join %s\n", conn.target.c_str());
+                    return -1;
+                }
+            }
+            break;
+        }
+        conn.is_sender = i < config_.senders;
+        if (set_nonblocking(conn.fd)) {
+            return -1;
+        }
+
+        auto &worker = workers_[i % config_.threads];
+        worker.conns.push_back(&conn);
+        if (conn.is_sender) {
+            worker.senders.push_back(&conn);
+        }
+    }
+
+    for (auto &worker : workers_) {
+        worker.io_mplex = IoMultiplexorFactory::get_multiplexor(BENCH_MAX_EVENTS);
+        if (worker.io_mplex == nullptr) {
+            log(LogPriority::ERROR, "unable to allocate multiplexor\n");
+            return -1;
+        }
+        for (auto conn : worker.conns) {
+            if (worker.io_mplex->add({0, MPLEX_IN, conn->fd, conn})) {
+                return -1;
+            }
+        }
+    }
+    return 0;
+}
+
+////
+// @brief send the worker's share of the rate and read its connections
+//        until the last message had time to arrive
+//
+// @param[in]   worker      connections of this thread
+//
+// @note a message is sent when it is due, however far behind that
+//       makes the worker. Between bursts of late messages it reads.
+void LoadGenerator::run_worker(worker_t &worker)
+{
+    io_mplex_event_t events[BENCH_MAX_EVENTS];
+    double rate = config_.rate * worker.senders.size() / config_.senders;
+    uint64_t interval_ns = std::max<uint64_t>(1, 1e9 / std::max(rate, 1e-9));
+    uint64_t due_ns = start_ns_;
+    uint64_t stop_ns = end_ns_ + BENCH_DRAIN_MS * 1000000;
+
+    for (;;) {
+        uint64_t now = clock_ns();
+        if (now >= stop_ns) {
+            break;
+        }
+        bool sending = !worker.senders.empty() && due_ns < end_ns_;
+        for (int i = 0; sending && due_ns <= now && i < BENCH_SEND_BURST; i++) {
+            send_next(worker, due_ns);
+            due_ns += interval_ns;
+            sending = due_ns < end_ns_;
+        }
+
+        uint64_t wake_ns = sending ? std::min(due_ns, stop_ns) : stop_ns;
+        uint64_t wait_ns = wake_ns > now ? wake_ns - now : 0;
+        struct timespec timeout{static_cast<time_t>(wait_ns / 1000000000),
+                                static_cast<long>(wait_ns % 1000000000)};
+        int n_events = worker.io_mplex->wait(&timeout, events, BENCH_MAX_EVENTS);
+        if (n_events == -1 && errno != EINTR) {
+            log(LogPriority::ERROR, "io_mplex wait error: %s\n", strerror(errno));
+            break;
+        }
+        for (int i = 0; i < n_events; i++) {
+            auto &conn = *static_cast<bench_conn_t *>(events[i].data);
+            if (conn.fd == -1) {
+                continue;
+            }
+            if ((events[i].filters & MPLEX_OUT) && flush(worker, conn)) {
+                close_conn(worker, conn);
+                continue;
+            }
+            if ((events[i].filters & (MPLEX_IN | MPLEX_EOF | MPLEX_ERR)) && read_conn(worker, conn)) {
+                close_conn(worker, conn);
+            }
+        }
+    }
+}
+
+////
+// @brief send a message from the next sender of the worker
+//
+// @param[in]   worker      connections of this thread
+// @param[in]   due_ns      time the message is due, stamped in its data
+void LoadGenerator::send_next(worker_t &worker, uint64_t due_ns)
+{
+    auto &conn = *worker.senders[worker.next_sender];
+    worker.next_sender = (worker.next_sender + 1) % worker.senders.size();
+    bool measured = due_ns >= measure_ns_;
+    if (conn.fd == -1) {
+        return;
+    }
+    if (!conn.pending.empty()) {
+        // the server is not keeping up with this connection
+        if (measured) {
+            blocked_.add();
+        }
+        return;
+    }
+
+    char data[MSG_DATA_MAX_SIZE] = {};
+    memcpy(data, &due_ns, BENCH_STAMP_SIZE);
+    message_t msg;
+    make_message(MsgType::DATA, conn.target, data, config_.payload, msg);
+    char frame[MSG_FRAME_MAX_SIZE];
+    int len = encode_message(msg, frame, sizeof(frame));
+    if (len == -1) {
+        return;
+    }
+    conn.pending.assign(frame, len);
+    if (measured) {
+        sent_.add();
+        expected_.add(conn.fan_out);
+    }
+    if (flush(worker, conn)) {
+        close_conn(worker, conn);
+    }
+}
+
+////
+// @brief write what is pending on a connection, watching for it to
+//        become writable if the socket is full
+//
+// @return  0 on success
+//         -1 if the connection failed
+int LoadGenerator::flush(worker_t &worker, bench_conn_t &conn)
+{
+    while (!conn.pending.empty()) {
+        ssize_t n = send(conn.fd, conn.pending.data(), conn.pending.size(), MSG_DONTWAIT | MSG_NOSIGNAL);
+        if (n > 0) {
+            conn.pending.erase(0, n);
+        } else if (n == -1 && errno == EINTR) {
+            continue;
+        } else if (n == -1 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            if (!conn.out_registered) {
+                conn.out_registered = true;
+                return worker.io_mplex->modify({0, MPLEX_IN | MPLEX_OUT, conn.fd, &conn});
+            }
+            return 0;
+        } else {
+            return -1;
+        }
+    }
+    if (conn.out_registered) {
+        conn.out_registered = false;
+        return worker.io_mplex->modify({0, MPLEX_IN, conn.fd, &conn});
+    }
+    return 0;
+}
+
+////
+// @brief read the frames that arrived on a connection, timing the
+//        messages sent in the measured window and answering pings
+//
+// @return  0 on success
+//         -1 if the connection failed or was closed
+int LoadGenerator::read_conn(worker_t &worker, bench_conn_t &conn)
+{
+    bool ping = false;
+    auto status = conn.reader.read_frames(conn.fd, [this, &ping](message_t &&message) {
+        if (message.header.type == MsgType::PING) {
+            ping = true;
+        }
+        if (message.header.type != MsgType::DATA || message.header.msg_len < BENCH_STAMP_SIZE) {
+            return;
+        }
+        uint64_t due_ns = 0;
+        memcpy(&due_ns, message.message, BENCH_STAMP_SIZE);
+        if (due_ns >= measure_ns_ && due_ns < end_ns_) {
+            delivered_.add();
+            latency_.record(clock_ns() - due_ns);
+        }
+    });
+    if (status != ReadStatus::AGAIN) {
+        return -1;
+    }
+    if (ping) {
+        message_t pong;
+        char frame[MSG_FRAME_MAX_SIZE];
+        make_message(MsgType::PONG, "", nullptr, 0, pong);
+        int len = encode_message(pong, frame, sizeof(frame));
+        if (len == -1) {
+            return -1;
+        }
+        conn.pending.append(frame, len);
+        return flush(worker, conn);
+    }
+    return 0;
+}
+
+void LoadGenerator::close_conn(worker_t &worker, bench_conn_t &conn)
+{
+    log(LogPriority::ERROR, "connection %d closed during the run\n", conn.fd);
+    worker.io_mplex->remove(conn.fd);
+    close(conn.fd);
+    conn.fd = -1;
+    closed_.add();
+}
@@ -0,0 +1,114 @@
+// LoadGenerator.hpp
+//
+// Headless clients that load a server with
+// chat traffic and measure its latency.
+//
+// 17 October 2026
+
+#pragma once
+
+#include <common/frame_reader.hpp>
+#include <common/metrics.hpp>
+#include <io_multiplexor/IoMultiplexor.hpp>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Who each message is sent to
+enum class TrafficPattern : int {
+    BROADCAST,      // every other connection
+    DIRECT,         // the next connection
+    ROOM,           // the other members of the sender's room
+};
+
+// Every message carries the monotonic time it was due to be sent in
+// its first bytes, so payloads are never shorter than this
+constexpr size_t BENCH_STAMP_SIZE = sizeof(uint64_t);
+
+// Messages still arriving this long after the last is sent are counted
+constexpr uint64_t BENCH_DRAIN_MS = 1000;
+
+struct load_config_t {
+    std::string address;
+    std::string port;
+    unsigned connections = 100;
+    unsigned threads = 2;
+    TrafficPattern pattern = TrafficPattern::BROADCAST;
+    double rate = 1000;             // messages a second from all senders together
+    unsigned senders = 0;           // connections that send, 0 for all of them
+    size_t payload = 64;            // bytes of data in each message
+    unsigned room_size = 10;        // members of each room
+    unsigned warmup_s = 1;          // seconds of load before measuring
+    unsigned duration_s = 10;       // seconds measured
+};
+
+// Messages due to be sent inside the measured window and what became
+// of them. Latency is from when a message was due, so a sender that
+// falls behind does not hide the delay.
+struct load_report_t {
+    unsigned connections;           // connections that were opened
+    double seconds;                 // length of the measured window
+    uint64_t sent;
+    uint64_t delivered;             // copies received by any connection
+    uint64_t expected;              // copies the pattern should deliver
+    uint64_t blocked;               // not sent as the socket was full
+    uint64_t closed;                // connections the server closed
+    uint64_t p50_ns;
+    uint64_t p99_ns;
+    uint64_t p999_ns;
+    uint64_t max_ns;
+};
+
+// LoadGenerator opens every connection up front and spreads them over
+// a few threads, each waiting on all of its connections with one
+// multiplexor. Each thread sends its share of the rate on a fixed
+// schedule, round robin over its senders, whatever the server does.
+class LoadGenerator final {
+public:
+    LoadGenerator(const load_config_t &config);
+    ~LoadGenerator();
+    LoadGenerator(const LoadGenerator &rhs) = delete;
+    LoadGenerator& operator=(const LoadGenerator &rhs) = delete;
+
+    int run(load_report_t &report);
+
+private:
+    struct bench_conn_t {
+        int fd = -1;
+        bool is_sender = false;
+        bool out_registered = false;
+        unsigned fan_out = 0;       // copies the server should deliver
+        std::string target;         // where its messages go
+        std::string pending;        // bytes the socket had no room for
+        FrameReader reader;
+    };
+
+    struct worker_t {
+        std::vector<bench_conn_t *> conns;
+        std::vector<bench_conn_t *> senders;
+        size_t next_sender = 0;
+        std::unique_ptr<IoMultiplexor> io_mplex;
+    };
+
+    int open_connections();
+    void run_worker(worker_t &worker);
+    void send_next(worker_t &worker, uint64_t due_ns);
+    int flush(worker_t &worker, bench_conn_t &conn);
+    int read_conn(worker_t &worker, bench_conn_t &conn);
+    void close_conn(worker_t &worker, bench_conn_t &conn);
+
+    load_config_t config_;
+    std::vector<std::unique_ptr<bench_conn_t>> conns_;
+    std::vector<worker_t> workers_;
+    uint64_t start_ns_;             // load starts
+    uint64_t measure_ns_;           // measured window starts
+    uint64_t end_ns_;               // last message is due
+    Counter sent_;
+    Counter delivered_;
+    Counter expected_;
+    Counter blocked_;
+    Counter closed_;
+    Histogram latency_;
+};
@@ -0,0 +1,145 @@
+// bench_main.cpp
+//
+// Load generator main. Loads a running server with
+// broadcast, direct or room traffic and reports the
+// message rates and latency it saw.
+//
+// 17 October 2026
+
+#include "LoadGenerator.hpp"
+
+#include <common/log_util.hpp>
+#include <common/utilities.hpp>
+
+#include <cpp/parse_flags.hpp>
+
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <exception>
+#include <memory>
+#include <string>
+
+using namespace parse_flags;
+
+// @brief parse the name of a traffic pattern
+//
+// @param[in]   name        broadcast, direct or room
+// @param[out]  pattern     parsed pattern
+//
+// @return true if name is a known pattern
+static bool parse_pattern(const std::string &name, TrafficPattern &pattern)
+{
+    if (name == "broadcast") {
+        pattern = TrafficPattern::BROADCAST;
+    } else if (name == "direct") {
+        pattern = TrafficPattern::DIRECT;
+    } else if (name == "room") {
+        pattern = TrafficPattern::ROOM;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+// @brief Load generator argument processing and report
+int main(int argc, char *argv[])
+{
+    std::string address = "127.0.0.1";
+    std::string port;
+    std::string connections;
+    std::string threads;
+    std::string pattern;
+    std::string rate;
+    std::string senders;
+    std::string size;
+    std::string room_size;
+    std::string warmup;
+    std::string duration;
+
+    ParseFlags parser;
+    parser.add_flag("address", address, "address of the server");
+    parser.add_flag("port", port, "port of the server");
+    parser.add_flag("connections", connections, "connections to open");
+    parser.add_flag("threads", threads, "threads the connections are spread over");
+    parser.add_flag("pattern", pattern, "broadcast, direct or room");
+    parser.add_flag("rate", rate, "messages a second from all senders together");
+    parser.add_flag("senders", senders, "connections that send, 0 for all of them");
+    parser.add_flag("size", size, "bytes of data in each message");
+    parser.add_flag("room-size", room_size, "members of each room");
+    parser.add_flag("warmup", warmup, "seconds of load before measuring");
+    parser.add_flag("duration", duration, "seconds measured");
+
+    int rc = parser.parse_args(argc, argv);
+    if (rc) {
+        log(LogPriority::ERROR, "Unable to parse arguments: %d\n", rc);
+        exit(EXIT_FAILURE);
+    }
+    if (port.empty()) {
+        fprintf(stderr, "port of the server is needed\n");
+        exit(EXIT_FAILURE);
+    }
+
+    load_config_t config;
+    config.address = address;
+    config.port = port;
+    if (!connections.empty()) {
+        config.connections = std::strtoul(connections.c_str(), nullptr, 10);
+    }
+    if (!threads.empty()) {
+        config.threads = std::strtoul(threads.c_str(), nullptr, 10);
+    }
+    if (!pattern.empty() && !parse_pattern(pattern, config.pattern)) {
+        fprintf(stderr, "Unknown traffic pattern: %s\n", pattern.c_str());
+        exit(EXIT_FAILURE);
+    }
+    if (!rate.empty()) {
+        config.rate = std::strtod(rate.c_str(), nullptr);
+    }
+    if (!senders.empty()) {
+        config.senders = std::strtoul(senders.c_str(), nullptr, 10);
+    }
+    if (!size.empty()) {
+        config.payload = std::strtoul(size.c_str(), nullptr, 10);
+    }
+    if (!room_size.empty()) {
+        config.room_size = std::strtoul(room_size.c_str(), nullptr, 10);
+    }
+    if (!warmup.empty()) {
+        config.warmup_s = std::strtoul(warmup.c_str(), nullptr, 10);
+    }
+    if (!duration.empty()) {
+        config.duration_s = std::strtoul(duration.c_str(), nullptr, 10);
+    }
+
+    signal(SIGPIPE, SIG_IGN);
+
+    // every connection needs a descriptor
+    raise_fd_limit();
+
+    std::unique_ptr<LoadGenerator> generator;
+    try {
+        generator = std::make_unique<LoadGenerator>(config);
+    } catch (const std::exception &e) {
+        fprintf(stderr, "%s\n", e.what());
+        exit(EXIT_FAILURE);
+    }
+    load_report_t report;
+    if (generator->run(report)) {
+        fprintf(stderr, "unable to connect to %s:%s\n", address.c_str(), port.c_str());
+        exit(EXIT_FAILURE);
+    }
+
+    printf("%s, %u connections, %zu byte messages, %.0f s measured\n",
+           pattern.empty() ? "broadcast" : pattern.c_str(), report.connections, config.payload, report.seconds);
+    printf("sent       %12.1f msgs/s  (%lu messages, %lu not sent as the socket was full)\n",
+           report.sent / report.seconds, report.sent, report.blocked);
+    printf("delivered  %12.1f msgs/s  (%lu of %lu copies expected)\n",
+           report.delivered / report.seconds, report.delivered, report.expected);
+    printf("latency us p50 %.1f  p99 %.1f  p999 %.1f  max %.1f\n",
+           report.p50_ns / 1e3, report.p99_ns / 1e3, report.p999_ns / 1e3, report.max_ns / 1e3);
+    if (report.closed > 0) {
+        printf("%lu connections were closed by the server\n", report.closed);
+    }
+    return 0;
+}
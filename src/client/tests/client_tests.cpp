@@ -0,0 +1,84 @@
+// Test cases for Client class
+//
+// 17 October 2026
+
+#define CATCH_CONFIG_MAIN
+
+#include "../Client.hpp"
+
+#include <common/net_common.hpp>
+
+#include <catch2/catch_all.hpp>
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+TEST_CASE("client sends and receives frames", "[client]") {
+    int listen_fd = bind_socket("127.0.0.1", "0", true, false);
+    REQUIRE(listen_fd != -1);
+    REQUIRE(listen_socket(listen_fd, 1) == 0);
+    struct sockaddr_in addr{};
+    socklen_t addrlen = sizeof(addr);
+    REQUIRE(getsockname(listen_fd, reinterpret_cast<struct sockaddr *>(&addr), &addrlen) == 0);
+    auto port = std::to_string(ntohs(addr.sin_port));
+
+    std::mutex mutex;
+    std::condition_variable received_cv;
+    std::vector<std::string> received;
+    Client client("127.0.0.1", port, [&](const message_t &message) {
+        std::lock_guard<std::mutex> lock(mutex);
+        received.emplace_back(message.message, message.header.msg_len);
+        received_cv.notify_one();
+    });
+    REQUIRE(client.connect("127.0.0.1", port) == 0);
+    int server_fd = accept(listen_fd, nullptr, nullptr);
+    REQUIRE(server_fd != -1);
+
+    SECTION("messages are written in the wire format") {
+        REQUIRE(client.send_message("someone", "hello") == 0);
+        REQUIRE(client.join_room("#room") == 0);
+        REQUIRE(client.send_message(std::string(MSG_TARGET_MAX_SIZE, 'x'), "hello") == -1);
+        REQUIRE(client.send_message("", std::string(MSG_DATA_MAX_SIZE + 1, 'x')) == -1);
+
+        message_t message;
+        REQUIRE(read_message(server_fd, message) == 0);
+        REQUIRE(message.header.type == MsgType::DATA);
+        REQUIRE(std::string(message.header.target) == "someone");
+        REQUIRE(std::string(message.message, message.header.msg_len) == "hello");
+        REQUIRE(read_message(server_fd, message) == 0);
+        REQUIRE(message.header.type == MsgType::ROOM);
+        REQUIRE(std::string(message.header.target) == "#room");
+        REQUIRE(message.header.msg_len == 1);
+        REQUIRE(message.message[0] == static_cast<char>(RoomOp::JOIN));
+    }
+
+    SECTION("pings are answered and data is handed on") {
+        message_t ping;
+        REQUIRE(make_message(MsgType::PING, "", nullptr, 0, ping) == 0);
+        message_t data;
+        REQUIRE(make_message(MsgType::DATA, "", "hi", 2, data) == 0);
+        REQUIRE(write_message(server_fd, ping) == 0);
+        REQUIRE(write_message(server_fd, data) == 0);
+
+        message_t pong;
+        REQUIRE(read_message(server_fd, pong) == 0);
+        REQUIRE(pong.header.type == MsgType::PONG);
+
+        std::unique_lock<std::mutex> lock(mutex);
+        REQUIRE(received_cv.wait_for(lock, std::chrono::seconds(5), [&received]() { return !received.empty(); }));
+        REQUIRE(received == std::vector<std::string>{"hi"});
+    }
+
+    REQUIRE(client.disconnect() == 0);
+    message_t message;
+    REQUIRE(read_message(server_fd, message) == EOF);
+    close(server_fd);
+    close(listen_fd);
+}
@@ -0,0 +1,71 @@
+// Test cases for LoadGenerator class
+//
+// 17 October 2026
+
+#include "../LoadGenerator.hpp"
+#include "../../server/Reactor.hpp"
+
+#include <common/net_common.hpp>
+#include <common/test_util.hpp>
+
+#include <catch2/catch_all.hpp>
+
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+TEST_CASE("load generator rejects unusable configurations", "[load-config]") {
+    load_config_t config;
+    config.payload = BENCH_STAMP_SIZE - 1;
+    REQUIRE_THROWS_AS(LoadGenerator(config), std::runtime_error);
+    config = {};
+    config.payload = MSG_DATA_MAX_SIZE + 1;
+    REQUIRE_THROWS_AS(LoadGenerator(config), std::runtime_error);
+    config = {};
+    config.senders = config.connections + 1;
+    REQUIRE_THROWS_AS(LoadGenerator(config), std::runtime_error);
+    config = {};
+    config.pattern = TrafficPattern::ROOM;
+    config.room_size = 1;
+    REQUIRE_THROWS_AS(LoadGenerator(config), std::runtime_error);
+}
+
+TEST_CASE("load generator measures direct messages through a reactor", "[load-direct]") {
+    auto port = free_port();
+    BroadCaster broadcaster;
+    std::vector<BroadCaster *> shards{&broadcaster};
+    server_config_t server_config{"127.0.0.1", port, 64, DEFAULT_OUT_BUFFER_SIZE,
+                                  SlowConsumerPolicy::DROP_OLDEST, 1, DEFAULT_LISTEN_BACKLOG, 0,
+                                  MplexBackend::NATIVE};
+    auto reactor = std::make_unique<Reactor>(server_config, 0, shards, nullptr);
+
+    load_config_t config;
+    config.address = "127.0.0.1";
+    config.port = port;
+    config.connections = 8;
+    config.pattern = TrafficPattern::DIRECT;
+    config.rate = 200;
+    config.warmup_s = 1;
+    config.duration_s = 1;
+    auto generator = std::make_unique<LoadGenerator>(config);
+    load_report_t report;
+    REQUIRE(generator->run(report) == 0);
+
+    REQUIRE(report.connections == 8);
+    REQUIRE(report.closed == 0);
+    REQUIRE(report.blocked == 0);
+    REQUIRE(report.sent >= 190);
+    REQUIRE(report.sent <= 200);
+    REQUIRE(report.expected == report.sent);
+    REQUIRE(report.delivered == report.expected);
+    REQUIRE(report.p50_ns > 0);
+    REQUIRE(report.p50_ns <= report.p99_ns);
+    REQUIRE(report.p99_ns <= report.p999_ns);
+    REQUIRE(report.p999_ns <= report.max_ns);
+}
@@ -0,0 +1,77 @@
+// Benchmarks for reading and writing messages
+//
+// Messages are written and read back on the same thread
+// over a pipe and a unix socketpair, so the time is the
+// encoding, the system calls and the kernel's copies. The
+// cost should grow slowly with the payload and batching
+// writes should share the system call between messages.
+//
+// 17 October 2026
+
+#define CATCH_CONFIG_MAIN
+
+#include <common/net_common.hpp>
+
+#include <catch2/catch_all.hpp>
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+#include <sys/socket.h>
+
+// a connected pair of descriptors, the first for writing
+struct bench_pair_t {
+    int fds[2];
+
+    bench_pair_t(bool is_socket)
+    {
+        int rc = is_socket ? socketpair(AF_UNIX, SOCK_STREAM, 0, fds) : pipe(fds);
+        REQUIRE(rc == 0);
+    }
+
+    ~bench_pair_t()
+    {
+        close(fds[0]);
+        close(fds[1]);
+    }
+};
+
+static message_t bench_message(int size)
+{
+    message_t message{{static_cast<uint16_t>(size), 1, "someone"}, ""};
+    memset(message.message, 'x', size);
+    return message;
+}
+
+TEST_CASE("write and read a message by payload size", "[!benchmark][net-common]") {
+    auto is_socket = GENERATE(false, true);
+    auto size = GENERATE(0, 16, 64, 256, MSG_DATA_MAX_SIZE);
+    bench_pair_t pair(is_socket);
+    auto message = bench_message(size);
+    message_t received_msg;
+
+    std::string over = is_socket ? " bytes over a socketpair" : " bytes over a pipe";
+    BENCHMARK("write and read " + std::to_string(size) + over) {
+        write_message(pair.fds[0], message);
+        read_message(pair.fds[1], received_msg);
+        return received_msg.header.msg_len;
+    };
+}
+
+TEST_CASE("write a batch of messages with one writev", "[!benchmark][net-common]") {
+    auto size = GENERATE(16, MSG_DATA_MAX_SIZE);
+    bench_pair_t pair(true);
+    auto message = bench_message(size);
+    std::vector<const message_t *> batch(MAX_WRITE_BATCH, &message);
+    message_t received_msg;
+
+    BENCHMARK(std::to_string(MAX_WRITE_BATCH) + " messages of " + std::to_string(size) + " bytes") {
+        write_messages(pair.fds[0], batch.data(), batch.size());
+        for (size_t i = 0; i < batch.size(); i++) {
+            read_message(pair.fds[1], received_msg);
+        }
+        return received_msg.header.msg_len;
+    };
+}
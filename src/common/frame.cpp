@@ -0,0 +1,24 @@
+// frame.cpp
+//
+// Creation of shared, encoded frames
+//
+// 17 October 2026
+
+#include <common/frame.hpp>
+
+// make_frame   encode msg once into a frame that can be shared
+//
+// @param[in]   msg     message to encode
+//
+// @return encoded frame
+//         nullptr if msg is invalid
+frame_ptr_t make_frame(const message_t &msg)
+{
+    auto frame = std::make_shared<frame_t>();
+    int frame_len = encode_message(msg, frame->data, sizeof(frame->data));
+    if (frame_len == -1) {
+        return nullptr;
+    }
+    frame->len = frame_len;
+    return frame;
+}
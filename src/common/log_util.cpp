@@ -0,0 +1,632 @@
+// log_util.cpp
+//
+// Background thread that formats and writes the
+// records queued by log on every thread.
+//
+// 17 October 2026
+
+#include <common/log_util.hpp>
+#include <common/mpsc_queue.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <time.h>
+
+// How long the background thread sleeps when every ring is empty
+constexpr auto LOG_FLUSH_INTERVAL = std::chrono::milliseconds(10);
+
+// Longest formatted message, longer ones are truncated
+constexpr size_t LOG_MESSAGE_MAX_SIZE = 1024;
+
+// Type tags of the encoded arguments
+constexpr char LOG_ARG_INT = 'i';
+constexpr char LOG_ARG_UINT = 'u';
+constexpr char LOG_ARG_DOUBLE = 'f';
+constexpr char LOG_ARG_POINTER = 'p';
+constexpr char LOG_ARG_STRING = 's';
+
+// A printf conversion, from its '%' to its conversion character
+struct log_conversion_t {
+    const char *start;
+    const char *length;     // first length modifier, or the conversion
+    const char *end;        // just after the conversion character
+    int stars;              // '*' widths and precisions it takes
+    bool star_precision;
+    char type;
+};
+
+// find the next conversion at or after fmt, skipping "%%"
+static bool find_conversion(const char *fmt, log_conversion_t &conv)
+{
+    for (const char *pos = strchr(fmt, '%'); pos != nullptr; pos = strchr(pos, '%')) {
+        if (pos[1] == '%') {
+            pos += 2;
+            continue;
+        }
+        conv.start = pos++;
+        conv.stars = 0;
+        conv.star_precision = false;
+        pos += strspn(pos, "-+ #0'");
+        if (*pos == '*') {
+            conv.stars++;
+            pos++;
+        } else {
+            pos += strspn(pos, "0123456789");
+        }
+        if (*pos == '.') {
+            pos++;
+            if (*pos == '*') {
+                conv.stars++;
+                conv.star_precision = true;
+                pos++;
+            } else {
+                pos += strspn(pos, "0123456789");
+            }
+        }
+        conv.length = pos;
+        pos += strspn(pos, "hlLqjzt");
+        if (*pos == '\0') {
+            return false;
+        }
+        conv.type = *pos;
+        conv.end = pos + 1;
+        return true;
+    }
+    return false;
+}
+
+LogEncoder::LogEncoder(log_record_t &record):
+    record_(record),
+    fmt_(record.site->fmt),
+    in_conversion_(false),
+    stars_(0),
+    star_precision_(false),
+    precision_(-1)
+{
+    record_.len = 0;
+}
+
+////
+// @brief find the conversion the next argument belongs to
+//
+// @return false if the format has no conversion left for it
+bool LogEncoder::next_arg()
+{
+    if (in_conversion_) {
+        return true;
+    }
+    log_conversion_t conv;
+    if (!find_conversion(fmt_, conv)) {
+        return false;
+    }
+    fmt_ = conv.end;
+    in_conversion_ = true;
+    stars_ = conv.stars;
+    star_precision_ = conv.star_precision;
+    precision_ = -1;
+    return true;
+}
+
+// an argument has been added, move on once the conversion has them all
+void LogEncoder::done_arg()
+{
+    if (stars_ > 0) {
+        stars_--;
+    } else {
+        in_conversion_ = false;
+    }
+}
+
+// append a tagged argument, false if it does not fit
+bool LogEncoder::put(char tag, const void *data, size_t len)
+{
+    if (record_.len + 1 + len > sizeof(record_.args)) {
+        return false;
+    }
+    record_.args[record_.len] = tag;
+    memcpy(record_.args + record_.len + 1, data, len);
+    record_.len += 1 + len;
+    return true;
+}
+
+void LogEncoder::add_int(long long value)
+{
+    if (!next_arg()) {
+        return;
+    }
+    if (stars_ == 1 && star_precision_) {
+        precision_ = value;
+    }
+    put(LOG_ARG_INT, &value, sizeof(value));
+    done_arg();
+}
+
+void LogEncoder::add_uint(unsigned long long value)
+{
+    if (!next_arg()) {
+        return;
+    }
+    if (stars_ == 1 && star_precision_) {
+        precision_ = static_cast<long long>(value);
+    }
+    put(LOG_ARG_UINT, &value, sizeof(value));
+    done_arg();
+}
+
+void LogEncoder::add_double(double value)
+{
+    if (next_arg()) {
+        put(LOG_ARG_DOUBLE, &value, sizeof(value));
+        done_arg();
+    }
+}
+
+void LogEncoder::add_pointer(const void *value)
+{
+    if (next_arg()) {
+        put(LOG_ARG_POINTER, &value, sizeof(value));
+        done_arg();
+    }
+}
+
+////
+// @brief copy a string argument, no further than a '*' precision
+//        lets it be printed
+void LogEncoder::add_string(const char *value)
+{
+    if (!next_arg()) {
+        return;
+    }
+    if (value == nullptr) {
+        value = "(null)";
+    }
+    // tag and length come first
+    size_t room = sizeof(record_.args) - record_.len;
+    if (room > 1 + sizeof(uint16_t)) {
+        size_t max_len = room - 1 - sizeof(uint16_t);
+        if (precision_ >= 0) {
+            max_len = std::min(max_len, static_cast<size_t>(precision_));
+        }
+        auto len = static_cast<uint16_t>(strnlen(value, max_len));
+        char *dest = record_.args + record_.len;
+        dest[0] = LOG_ARG_STRING;
+        memcpy(dest + 1, &len, sizeof(len));
+        memcpy(dest + 1 + sizeof(len), value, len);
+        record_.len += 1 + sizeof(len) + len;
+    }
+    done_arg();
+}
+
+// Reads the arguments of a record back in order
+class LogDecoder final {
+public:
+    LogDecoder(const log_record_t &record):
+        record_(record),
+        pos_(0) {}
+
+    // false once the arguments run out
+    bool next(char &tag, const char *&data, size_t &len)
+    {
+        if (pos_ >= record_.len) {
+            return false;
+        }
+        tag = record_.args[pos_++];
+        data = record_.args + pos_;
+        if (tag == LOG_ARG_STRING) {
+            uint16_t str_len;
+            memcpy(&str_len, data, sizeof(str_len));
+            data += sizeof(str_len);
+            len = str_len;
+            pos_ += sizeof(str_len) + len;
+        } else {
+            len = 8;
+            pos_ += len;
+        }
+        return true;
+    }
+
+    long long as_int()
+    {
+        char tag;
+        const char *data;
+        size_t len;
+        if (!next(tag, data, len)) {
+            return 0;
+        }
+        return to_int(tag, data);
+    }
+
+    static long long to_int(char tag, const char *data)
+    {
+        if (tag == LOG_ARG_DOUBLE) {
+            double value;
+            memcpy(&value, data, sizeof(value));
+            return static_cast<long long>(value);
+        }
+        long long value = 0;
+        if (tag != LOG_ARG_STRING) {
+            memcpy(&value, data, sizeof(value));
+        }
+        return value;
+    }
+
+private:
+    const log_record_t &record_;
+    size_t pos_;
+};
+
+// append with snprintf semantics, keeping used within size
+template<typename... Args>
+static void append(char *out, size_t size, size_t &used, const char *fmt, Args... args)
+{
+    if (used + 1 >= size) {
+        return;
+    }
+    int n = snprintf(out + used, size - used, fmt, args...);
+    if (n > 0) {
+        used = std::min(size - 1, used + static_cast<size_t>(n));
+    }
+}
+
+////
+// @brief format a record as printf would have formatted the call
+//
+// @param[in]   record  record taken off a ring
+// @param[out]  out     formatted message, always null terminated
+// @param[in]   size    size of out
+static void format_record(const log_record_t &record, char *out, size_t size)
+{
+    LogDecoder decoder(record);
+    const char *fmt = record.site->fmt;
+    size_t used = 0;
+    out[0] = '\0';
+
+    for (;;) {
+        log_conversion_t conv;
+        bool found = find_conversion(fmt, conv);
+        // literal text up to the conversion, with "%%" unescaped
+        const char *literal_end = found ? conv.start : fmt + strlen(fmt);
+        for (const char *pos = fmt; pos < literal_end && used + 1 < size; pos++) {
+            out[used++] = *pos;
+            if (pos[0] == '%' && pos[1] == '%') {
+                pos++;
+            }
+        }
+        out[used] = '\0';
+        if (!found) {
+            break;
+        }
+        fmt = conv.end;
+
+        // rebuild the conversion with '*' filled in and a length
+        // modifier to match how the argument was stored
+        char spec[64];
+        size_t spec_len = 0;
+        for (const char *pos = conv.start; pos < conv.length && spec_len < 32; pos++) {
+            if (*pos == '*') {
+                spec_len += snprintf(spec + spec_len, sizeof(spec) - spec_len, "%lld", decoder.as_int());
+            } else {
+                spec[spec_len++] = *pos;
+            }
+        }
+        char tag;
+        const char *data;
+        size_t len;
+        if (!decoder.next(tag, data, len)) {
+            append(out, size, used, "%s", "?");
+            continue;
+        }
+        switch (conv.type) {
+            case 'd':
+            case 'i':
+                snprintf(spec + spec_len, sizeof(spec) - spec_len, "ll%c", conv.type);
+                append(out, size, used, spec, LogDecoder::to_int(tag, data));
+                break;
+            case 'u':
+            case 'o':
+            case 'x':
+            case 'X':
+                snprintf(spec + spec_len, sizeof(spec) - spec_len, "ll%c", conv.type);
+                append(out, size, used, spec, static_cast<unsigned long long>(LogDecoder::to_int(tag, data)));
+                break;
+            case 'c':
+                snprintf(spec + spec_len, sizeof(spec) - spec_len, "%c", conv.type);
+                append(out, size, used, spec, static_cast<int>(LogDecoder::to_int(tag, data)));
+                break;
+            case 'e':
+            case 'E':
+            case 'f':
+            case 'F':
+            case 'g':
+            case 'G':
+            case 'a':
+            case 'A':
+            {
+                double value = 0;
+                if (tag == LOG_ARG_DOUBLE) {
+                    memcpy(&value, data, sizeof(value));
+                } else {
+                    value = static_cast<double>(LogDecoder::to_int(tag, data));
+                }
+                snprintf(spec + spec_len, sizeof(spec) - spec_len, "%c", conv.type);
+                append(out, size, used, spec, value);
+            }
+            break;
+            case 's':
+            {
+                char str[LOG_RECORD_SIZE];
+                size_t str_len = tag == LOG_ARG_STRING ? std::min(len, sizeof(str) - 1) : 0;
+                memcpy(str, data, str_len);
+                str[str_len] = '\0';
+                snprintf(spec + spec_len, sizeof(spec) - spec_len, "s");
+                append(out, size, used, spec, str);
+            }
+            break;
+            case 'p':
+            {
+                const void *value = nullptr;
+                if (tag == LOG_ARG_POINTER) {
+                    memcpy(&value, data, sizeof(value));
+                }
+                append(out, size, used, "%p", value);
+            }
+            break;
+            default:
+                // %n and anything unknown print nothing
+                break;
+        }
+    }
+
+    if (record.suppressed > 0) {
+        // keep a trailing newline at the end
+        bool newline = used > 0 && out[used - 1] == '\n';
+        if (newline) {
+            used--;
+        }
+        append(out, size, used, " (%u earlier messages suppressed)%s", record.suppressed,
+               newline ? "\n" : "");
+    }
+}
+
+static void syslog_sink(int priority, const char *message)
+{
+    syslog(priority, "%s", message);
+}
+
+// Records written by one thread. The ring outlives the thread
+// until the background thread has drained it.
+struct log_ring_t {
+    log_ring_t():
+        records(LOG_RING_SIZE),
+        dropped(0),
+        closed(false) {}
+
+    MpscQueue<log_record_t> records;    // only ever one producer
+    std::atomic<uint64_t> dropped;      // records that found the ring full
+    std::atomic<bool> closed;           // the thread has exited
+};
+
+// Owns the rings of every thread that has logged and the thread that
+// drains them. Producers only take the lock the first time they log.
+class LogBackend final {
+public:
+    static LogBackend &instance()
+    {
+        static LogBackend backend;
+        return backend;
+    }
+
+    std::shared_ptr<log_ring_t> add_ring();
+    void flush();
+    void set_sink(void (*sink)(int priority, const char *message)) { sink_ = sink; }
+
+    static std::atomic<bool> alive;     // false once destroyed at exit
+
+private:
+    LogBackend();
+    ~LogBackend();
+
+    void process();
+    bool drain(log_ring_t &ring);
+
+    std::mutex mutex_;                  // guards everything below
+    std::condition_variable wake_;
+    std::condition_variable flushed_;
+    bool running_;
+    uint64_t flush_requested_;
+    uint64_t flush_done_;
+    std::vector<std::shared_ptr<log_ring_t>> rings_;
+    std::atomic<void (*)(int, const char *)> sink_;
+    std::thread thread_;
+};
+
+std::atomic<bool> LogBackend::alive(false);
+
+// the ring of the current thread, closed when the thread exits
+struct log_ring_holder_t {
+    ~log_ring_holder_t()
+    {
+        if (ring != nullptr) {
+            ring->closed = true;
+        }
+    }
+
+    std::shared_ptr<log_ring_t> ring;
+};
+
+static thread_local log_ring_holder_t this_thread_ring;
+
+LogBackend::LogBackend():
+    running_(true),
+    flush_requested_(0),
+    flush_done_(0),
+    sink_(syslog_sink)
+{
+    thread_ = std::thread(&LogBackend::process, this);
+    alive = true;
+}
+
+LogBackend::~LogBackend()
+{
+    alive = false;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        running_ = false;
+    }
+    wake_.notify_one();
+    thread_.join();
+}
+
+std::shared_ptr<log_ring_t> LogBackend::add_ring()
+{
+    auto ring = std::make_shared<log_ring_t>();
+    std::lock_guard<std::mutex> lock(mutex_);
+    rings_.push_back(ring);
+    return ring;
+}
+
+////
+// @brief wait until everything logged before the call has been written
+void LogBackend::flush()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    uint64_t target = ++flush_requested_;
+    wake_.notify_one();
+    flushed_.wait(lock, [this, target]() { return flush_done_ >= target || !running_; });
+}
+
+// format and write everything in a ring, true if anything was written
+bool LogBackend::drain(log_ring_t &ring)
+{
+    auto sink = sink_.load();
+    char message[LOG_MESSAGE_MAX_SIZE];
+    uint64_t dropped = ring.dropped.exchange(0);
+    if (dropped > 0) {
+        snprintf(message, sizeof(message), "log ring full -- dropped %lu messages\n",
+                 static_cast<unsigned long>(dropped));
+        sink(LOG_WARNING, message);
+    }
+    bool busy = false;
+    log_record_t record;
+    for (size_t i = 0; i < LOG_RING_SIZE && ring.records.try_pop(record); i++) {
+        format_record(record, message, sizeof(message));
+        sink(static_cast<int>(record.site->priority), message);
+        busy = true;
+    }
+    return busy || dropped > 0;
+}
+
+void LogBackend::process()
+{
+    std::vector<std::shared_ptr<log_ring_t>> rings;
+    std::unique_lock<std::mutex> lock(mutex_);
+    for (;;) {
+        bool running = running_;
+        uint64_t requested = flush_requested_;
+        rings = rings_;
+        lock.unlock();
+
+        bool busy = false;
+        for (auto &ring : rings) {
+            // a closed ring gets no more records once it is seen closed
+            bool closed = ring->closed;
+            busy |= drain(*ring);
+            if (closed && ring->records.empty()) {
+                ring.reset();
+            }
+        }
+
+        lock.lock();
+        // only this thread removes rings, so they are still in order
+        size_t kept = 0;
+        for (size_t i = 0; i < rings_.size(); i++) {
+            if (i >= rings.size() || rings[i] != nullptr) {
+                rings_[kept++] = std::move(rings_[i]);
+            }
+        }
+        rings_.resize(kept);
+        rings.clear();
+        flush_done_ = requested;
+        flushed_.notify_all();
+        if (!running) {
+            break;
+        }
+        if (!busy && flush_requested_ == requested && running_) {
+            wake_.wait_for(lock, LOG_FLUSH_INTERVAL);
+        }
+    }
+}
+
+////
+// @brief count a message against its call site's rate
+//
+// @param[in]   site    call site of the message
+//
+// @return true if the message should be logged
+bool log_admit(log_site_t &site)
+{
+    struct timespec now;
+#ifdef CLOCK_MONOTONIC_COARSE
+    clock_gettime(CLOCK_MONOTONIC_COARSE, &now);
+#else
+    clock_gettime(CLOCK_MONOTONIC, &now);
+#endif
+    auto second = static_cast<uint64_t>(now.tv_sec) + 1;
+    if (site.window.load(std::memory_order_relaxed) != second) {
+        site.window.store(second, std::memory_order_relaxed);
+        site.count.store(0, std::memory_order_relaxed);
+    }
+    if (site.count.fetch_add(1, std::memory_order_relaxed) < LOG_SITE_MAX_PER_SECOND) {
+        return true;
+    }
+    site.suppressed.fetch_add(1, std::memory_order_relaxed);
+    return false;
+}
+
+////
+// @brief queue a record on the calling thread's ring
+//
+// @param[in]   record  encoded message
+//
+// @note dropped and counted if the ring is full, so a flood of
+//       messages never blocks the caller
+void log_submit(log_record_t &&record)
+{
+    auto &holder = this_thread_ring;
+    if (holder.ring == nullptr) {
+        holder.ring = LogBackend::instance().add_ring();
+    }
+    if (!LogBackend::alive) {
+        // shutting down, nothing is left to write it
+        return;
+    }
+    if (!holder.ring->records.try_push(std::move(record))) {
+        holder.ring->dropped.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+////
+// @brief wait until every message logged before the call is written
+void log_flush()
+{
+    LogBackend::instance().flush();
+}
+
+////
+// @brief write messages somewhere other than syslog
+//
+// @param[in]   sink    called from the background thread with the
+//                      priority and formatted message
+void log_set_sink(void (*sink)(int priority, const char *message))
+{
+    LogBackend::instance().set_sink(sink == nullptr ? syslog_sink : sink);
+}
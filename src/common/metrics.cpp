@@ -0,0 +1,293 @@
+// metrics.cpp
+//
+// Aggregation and Prometheus output of the
+// server's metrics.
+//
+// 17 October 2026
+
+#include <common/metrics.hpp>
+
+#include <algorithm>
+#include <cstdio>
+#include <stdexcept>
+#include <vector>
+
+////
+// @brief pick the shard for a thread the first time it updates a metric
+//
+// @note threads are dealt out round robin, so with no more threads than
+//       shards no two threads share one
+unsigned metrics_assign_shard()
+{
+    static std::atomic<unsigned> next_shard{0};
+    return next_shard.fetch_add(1, std::memory_order_relaxed) % METRICS_SHARDS;
+}
+
+uint64_t Counter::value() const
+{
+    uint64_t total = 0;
+    for (const auto &shard : shards_) {
+        total += shard.value.load(std::memory_order_relaxed);
+    }
+    return total;
+}
+
+int64_t Gauge::value() const
+{
+    int64_t total = 0;
+    for (const auto &shard : shards_) {
+        total += shard.value.load(std::memory_order_relaxed);
+    }
+    return total;
+}
+
+////
+// @brief bucket a value is counted in
+size_t Histogram::bucket_of(uint64_t value)
+{
+    constexpr uint64_t max_value = (uint64_t(1) << HISTOGRAM_MAX_BITS) - 1;
+    if (value > max_value) {
+        value = max_value;
+    }
+    if (value < (uint64_t(1) << HISTOGRAM_SUB_BITS)) {
+        return value;
+    }
+    // the top HISTOGRAM_SUB_BITS + 1 bits of the value pick the bucket
+    unsigned high_bit = 63 - __builtin_clzll(value);
+    unsigned shift = high_bit - HISTOGRAM_SUB_BITS;
+    return ((shift + 1) << HISTOGRAM_SUB_BITS) + (value >> shift) - (size_t(1) << HISTOGRAM_SUB_BITS);
+}
+
+////
+// @brief smallest value counted in a bucket
+uint64_t Histogram::bucket_low(size_t bucket)
+{
+    if (bucket < (size_t(1) << HISTOGRAM_SUB_BITS)) {
+        return bucket;
+    }
+    unsigned shift = (bucket >> HISTOGRAM_SUB_BITS) - 1;
+    uint64_t offset = bucket & ((size_t(1) << HISTOGRAM_SUB_BITS) - 1);
+    return ((uint64_t(1) << HISTOGRAM_SUB_BITS) + offset) << shift;
+}
+
+////
+// @brief largest value counted in a bucket
+uint64_t Histogram::bucket_high(size_t bucket)
+{
+    if (bucket < (size_t(1) << HISTOGRAM_SUB_BITS)) {
+        return bucket;
+    }
+    unsigned shift = (bucket >> HISTOGRAM_SUB_BITS) - 1;
+    return bucket_low(bucket) + (uint64_t(1) << shift) - 1;
+}
+
+////
+// @brief count of each bucket over every shard
+std::vector<uint64_t> Histogram::buckets() const
+{
+    std::vector<uint64_t> totals(HISTOGRAM_BUCKETS, 0);
+    for (const auto &shard : shards_) {
+        for (size_t i = 0; i < HISTOGRAM_BUCKETS; i++) {
+            totals[i] += shard.buckets[i].load(std::memory_order_relaxed);
+        }
+    }
+    return totals;
+}
+
+uint64_t Histogram::count() const
+{
+    uint64_t total = 0;
+    for (const auto &shard : shards_) {
+        for (const auto &bucket : shard.buckets) {
+            total += bucket.load(std::memory_order_relaxed);
+        }
+    }
+    return total;
+}
+
+uint64_t Histogram::sum() const
+{
+    uint64_t total = 0;
+    for (const auto &shard : shards_) {
+        total += shard.sum.load(std::memory_order_relaxed);
+    }
+    return total;
+}
+
+////
+// @brief value that percent of the recorded values are at or below
+//
+// @param[in]   percent     0 to 100
+//
+// @return the largest value of the bucket the percentile falls in, or 0
+//         if nothing has been recorded
+uint64_t Histogram::percentile(double percent) const
+{
+    auto buckets = this->buckets();
+    uint64_t total = 0;
+    for (auto count : buckets) {
+        total += count;
+    }
+    if (total == 0) {
+        return 0;
+    }
+    auto target = static_cast<uint64_t>(percent / 100.0 * total + 0.5);
+    target = std::max<uint64_t>(1, std::min(target, total));
+    uint64_t seen = 0;
+    for (size_t i = 0; i < buckets.size(); i++) {
+        seen += buckets[i];
+        if (seen >= target) {
+            return bucket_high(i);
+        }
+    }
+    return bucket_high(buckets.size() - 1);
+}
+
+////
+// @brief number of recorded values less than limit
+//
+// @note exact when limit is the start of a bucket, such as a power of two
+uint64_t Histogram::count_below(uint64_t limit) const
+{
+    auto buckets = this->buckets();
+    uint64_t total = 0;
+    for (size_t i = 0; i < buckets.size() && bucket_high(i) < limit; i++) {
+        total += buckets[i];
+    }
+    return total;
+}
+
+////
+// @brief largest value of the highest bucket in use, 0 if none is
+uint64_t Histogram::max() const
+{
+    auto buckets = this->buckets();
+    for (size_t i = buckets.size(); i > 0; i--) {
+        if (buckets[i - 1] > 0) {
+            return bucket_high(i - 1);
+        }
+    }
+    return 0;
+}
+
+////
+// @brief registry the server's own metrics are kept in
+MetricsRegistry &MetricsRegistry::instance()
+{
+    static MetricsRegistry registry;
+    return registry;
+}
+
+////
+// @brief find a metric, creating it the first time it is asked for
+//
+// @throws std::runtime_error if the name is taken by a metric of another type
+MetricsRegistry::metric_t &MetricsRegistry::find_or_add(const std::string &name, const std::string &help,
+                                                        MetricType type)
+{
+    auto [metric, added] = metrics_.try_emplace(name);
+    if (added) {
+        metric->second.type = type;
+        metric->second.help = help;
+        metric->second.scale = 1.0;
+    } else if (metric->second.type != type) {
+        throw std::runtime_error("Metric " + name + " already has another type\n");
+    }
+    return metric->second;
+}
+
+Counter &MetricsRegistry::counter(const std::string &name, const std::string &help)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto &metric = find_or_add(name, help, MetricType::COUNTER);
+    if (metric.counter == nullptr) {
+        metric.counter = std::make_unique<Counter>();
+    }
+    return *metric.counter;
+}
+
+Gauge &MetricsRegistry::gauge(const std::string &name, const std::string &help)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto &metric = find_or_add(name, help, MetricType::GAUGE);
+    if (metric.gauge == nullptr) {
+        metric.gauge = std::make_unique<Gauge>();
+    }
+    return *metric.gauge;
+}
+
+////
+// @brief find or create a histogram
+//
+// @param[in]   name    metric name
+// @param[in]   help    description for the HELP line
+// @param[in]   scale   multiplies recorded values in the output, 1e-9 to
+//                      record nanoseconds and report seconds
+Histogram &MetricsRegistry::histogram(const std::string &name, const std::string &help, double scale)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto &metric = find_or_add(name, help, MetricType::HISTOGRAM);
+    if (metric.histogram == nullptr) {
+        metric.histogram = std::make_unique<Histogram>();
+        metric.scale = scale;
+    }
+    return *metric.histogram;
+}
+
+// format a number the way Prometheus parses it
+static std::string format_value(double value)
+{
+    char buffer[32];
+    snprintf(buffer, sizeof(buffer), "%.9g", value);
+    return buffer;
+}
+
+////
+// @brief every metric in the Prometheus text exposition format
+//
+// @note histogram buckets are cumulative and bounded by powers of two,
+//       up to the first that holds every recorded value. Each bound is
+//       one less than the power of two so that the counts are exact.
+std::string MetricsRegistry::render() const
+{
+    static const char *type_names[] = {"counter", "gauge", "histogram"};
+    std::string out;
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (const auto &[name, metric] : metrics_) {
+        out += "# HELP " + name + " " + metric.help + "\n";
+        out += "# TYPE " + name + " " + type_names[static_cast<int>(metric.type)] + "\n";
+        switch (metric.type) {
+            case MetricType::COUNTER:
+                out += name + " " + std::to_string(metric.counter->value()) + "\n";
+                break;
+            case MetricType::GAUGE:
+                out += name + " " + std::to_string(metric.gauge->value()) + "\n";
+                break;
+            case MetricType::HISTOGRAM:
+            {
+                // a single copy of the counts so that the buckets agree
+                // with the total even while values are being recorded
+                auto buckets = metric.histogram->buckets();
+                uint64_t total = 0;
+                for (auto count : buckets) {
+                    total += count;
+                }
+                uint64_t below = 0;
+                size_t bucket = 0;
+                for (unsigned bits = 0; bits <= HISTOGRAM_MAX_BITS && below < total; bits++) {
+                    uint64_t limit = uint64_t(1) << bits;
+                    for (; bucket < buckets.size() && Histogram::bucket_high(bucket) < limit; bucket++) {
+                        below += buckets[bucket];
+                    }
+                    out += name + "_bucket{le=\"" + format_value((limit - 1) * metric.scale) + "\"} " +
+                           std::to_string(below) + "\n";
+                }
+                out += name + "_bucket{le=\"+Inf\"} " + std::to_string(total) + "\n";
+                out += name + "_sum " + format_value(metric.histogram->sum() * metric.scale) + "\n";
+                out += name + "_count " + std::to_string(total) + "\n";
+            }
+            break;
+        }
+    }
+    return out;
+}
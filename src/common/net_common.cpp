@@ -11,28 +11,33 @@
 
 #include <sys/types.h>
 #include <sys/socket.h>
+#include <sys/uio.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
 #include <netdb.h>
+#include <fcntl.h>
 #include <unistd.h>
 
+#include <cstdio>
 #include <utility>
 
-// Write n bytes to a socket in a reliable manner
+// Write a set of buffers to a socket in a reliable manner
 //
 // @param[in]   sock_fd     file descriptor for socket to write to
-// @param[in]   buffer      buffer containing data to write
-// @param[in]   n_bytes     bytes to write 
+// @param[in]   iov         buffers to write -- advanced past written data
+// @param[in]   iovcnt      number of buffers in iov
 //
-// @return  total bytes written 
-static int sock_writen(int sock_fd, const void *buffer, size_t n_bytes)
+// @return  total bytes written
+static size_t sock_writev(int sock_fd, struct iovec *iov, int iovcnt)
 {
-    int bytes_written = 0;
-    int total_written = 0;
-    const char *buf = static_cast<const char *>(buffer);
+    size_t total_written = 0;
 
-    while ((bytes_written = write(sock_fd, buf, n_bytes))) {
+    while (iovcnt > 0) {
+        ssize_t bytes_written = writev(sock_fd, iov, iovcnt);
         if (bytes_written <= 0) {
             if (bytes_written == -1 && errno == EINTR) {
-                // on signal interupts we restart the write syscal
+                // on signal interupts we restart the write syscall
                 continue;
             } else {
                 // an actual error occured
@@ -40,11 +45,19 @@ static int sock_writen(int sock_fd, const void *buffer, size_t n_bytes)
                 return total_written;
             }
         }
-        buf += bytes_written;
         total_written += bytes_written;
-        n_bytes -= bytes_written;
-        if (n_bytes == 0) {
-            break;
+
+        // skip the buffers that were completely written and
+        // advance into the one that was partially written
+        size_t remaining = bytes_written;
+        while (iovcnt > 0 && remaining >= iov->iov_len) {
+            remaining -= iov->iov_len;
+            iov++;
+            iovcnt--;
+        }
+        if (iovcnt > 0) {
+            iov->iov_base = static_cast<char *>(iov->iov_base) + remaining;
+            iov->iov_len -= remaining;
         }
     }
     return total_written;
@@ -87,13 +100,17 @@ static int sock_readn(int sock_fd, void *buffer, size_t n_bytes)
 // Attempt passive open and bind a socket
 // at address,port
 //
-// @param[in] port      port to bind
+// @param[in] address       address to bind
+// @param[in] port          port to bind
+// @param[in] is_blocking   is the socket blocking
+// @param[in] reuse_port    set SO_REUSEPORT so that several sockets
+//                          can listen on the same port
 //
-// @return listening socket on success
-//         nonzero error code on error
+// @return bound socket on success
+//         -1 on error
 //
 // @note intended for server use
-int bind_socket(const char *address, const char *port, bool is_blocking)
+int bind_socket(const char *address, const char *port, bool is_blocking, bool reuse_port)
 {
     struct addrinfo hints;
     struct addrinfo *result = nullptr;
@@ -114,16 +131,22 @@ int bind_socket(const char *address, const char *port, bool is_blocking)
     rc = getaddrinfo(address, port, &hints, &result);
     if (rc) {
         log(LogPriority::ERROR, "getaddrinfo error: %s\n", gai_strerror(rc));
-        return rc;
+        return -1;
     }
 
     for (rp = result; rp != nullptr; rp = rp->ai_next) {
         // set O_NONBLOCK 
         auto sock_type = is_blocking ? rp->ai_socktype : rp->ai_socktype|SOCK_NONBLOCK;
         socket_fd = socket(rp->ai_family, sock_type, rp->ai_protocol);
-        if (socket_fd == 1) {
+        if (socket_fd == -1) {
             continue; 
         }
+        int enable = 1;
+        if (reuse_port && setsockopt(socket_fd, SOL_SOCKET, SO_REUSEPORT, &enable, sizeof(enable))) {
+            log(LogPriority::ERROR, "unable to set SO_REUSEPORT: %s\n", strerror(errno));
+            close(socket_fd);
+            continue;
+        }
         rc = bind(socket_fd, rp->ai_addr, rp->ai_addrlen);
         if (rc == 0) {
             // successfully bound socket
@@ -136,7 +159,7 @@ int bind_socket(const char *address, const char *port, bool is_blocking)
     
     if (rp == nullptr) {
         log(LogPriority::ERROR, "unable to bind any results for %s:%s\n", address, port);
-        return 1;
+        return -1;
     }
     return socket_fd;
 }
@@ -157,6 +180,76 @@ int listen_socket(int socket_fd, int backlog)
     return rc;
 }
 
+// Put a socket into non-blocking mode
+//
+// @param[in] socket_fd     socket to modify
+//
+// @return  0 on success
+//         -1 on error
+int set_nonblocking(int socket_fd)
+{
+    int flags = fcntl(socket_fd, F_GETFL);
+    if (flags == -1 || fcntl(socket_fd, F_SETFL, flags | O_NONBLOCK) == -1) {
+        log(LogPriority::ERROR, "unable to make socket non-blocking: %s\n", strerror(errno));
+        return -1;
+    }
+    return 0;
+}
+
+// Turn on TCP keepalive so that a peer that vanished without a FIN
+// is noticed by the kernel
+//
+// @param[in] socket_fd     socket to modify, a listening socket passes
+//                          the settings on to the sockets it accepts
+// @param[in] idle_s        seconds of silence before the first probe
+// @param[in] interval_s    seconds between probes
+// @param[in] probes        unanswered probes before the connection is reset
+//
+// @return  0 on success
+//         -1 on error
+int set_keepalive(int socket_fd, int idle_s, int interval_s, int probes)
+{
+    int enable = 1;
+    if (setsockopt(socket_fd, SOL_SOCKET, SO_KEEPALIVE, &enable, sizeof(enable)) ||
+        setsockopt(socket_fd, IPPROTO_TCP, TCP_KEEPIDLE, &idle_s, sizeof(idle_s)) ||
+        setsockopt(socket_fd, IPPROTO_TCP, TCP_KEEPINTVL, &interval_s, sizeof(interval_s)) ||
+        setsockopt(socket_fd, IPPROTO_TCP, TCP_KEEPCNT, &probes, sizeof(probes))) {
+        log(LogPriority::ERROR, "unable to set keepalive: %s\n", strerror(errno));
+        return -1;
+    }
+    return 0;
+}
+
+// Accept a connection as a non-blocking, close-on-exec socket
+//
+// @param[in]   socket_fd   listening socket
+// @param[out]  addr        address of the peer
+// @param[in,out] addrlen   size of addr, set to the size of the peer address
+//
+// @return  accepted socket on success
+//         -1 on error with errno set -- EAGAIN once the queue is empty
+int accept_socket(int socket_fd, struct sockaddr_storage *addr, socklen_t *addrlen)
+{
+    auto peer = reinterpret_cast<struct sockaddr *>(addr);
+#if __linux__
+    return accept4(socket_fd, peer, addrlen, SOCK_NONBLOCK | SOCK_CLOEXEC);
+#else
+    int client_fd = accept(socket_fd, peer, addrlen);
+    if (client_fd == -1) {
+        return -1;
+    }
+    int flags = fcntl(client_fd, F_GETFL);
+    if (flags == -1 || fcntl(client_fd, F_SETFL, flags | O_NONBLOCK) == -1 ||
+            fcntl(client_fd, F_SETFD, FD_CLOEXEC) == -1) {
+        int err = errno;
+        close(client_fd);
+        errno = err;
+        return -1;
+    }
+    return client_fd;
+#endif
+}
+
 // Attempt to connect to addres,port
 //
 // @param[in]   address         address to attempt connection
@@ -223,14 +316,62 @@ int connect_socket(const char *address, const char *port, bool is_blocking)
 //
 // @return   0 on success
 //          -1 on error
-int write_message(int sock_fd, message_t &msg)
+//
+// @note the encoded header and the message data are written
+//       with a single writev
+int write_message(int sock_fd, const message_t &msg)
 {
-    size_t write_len = sizeof(msg.header) + msg.header.msg_len; 
-    size_t bytes_written = sock_writen(sock_fd, &msg, write_len);
-    if (bytes_written < write_len) {
-        log(LogPriority::ERROR, "failure to write message: wrote: %lu, expected: %lu",
-                bytes_written, write_len);
-        return -1;
+    const message_t *msgs[] = {&msg};
+    return write_messages(sock_fd, msgs, 1);
+}
+
+// Write several messages to a socket
+//
+// @param[in] sock_fd   socket to write to
+// @param[in] msgs      messages to write, in order
+// @param[in] n_msgs    number of messages in msgs
+//
+// @return   0 on success
+//          -1 on error
+//
+// @note messages are written MAX_WRITE_BATCH at a time with one
+//       writev per batch instead of one write per message
+int write_messages(int sock_fd, const message_t *const *msgs, size_t n_msgs)
+{
+    char headers[MAX_WRITE_BATCH][WIRE_HEADER_SIZE + MSG_TARGET_MAX_SIZE];
+    struct iovec iov[2 * MAX_WRITE_BATCH];
+
+    while (n_msgs > 0) {
+        size_t batch = n_msgs < MAX_WRITE_BATCH ? n_msgs : MAX_WRITE_BATCH;
+        size_t write_len = 0;
+        int iovcnt = 0;
+
+        for (size_t i = 0; i < batch; i++) {
+            const message_t &msg = *msgs[i];
+            int header_len = encode_header(msg.header, headers[i], sizeof(headers[i]));
+            if (header_len == -1) {
+                log(LogPriority::ERROR, "failure to encode message\n");
+                return -1;
+            }
+            iov[iovcnt].iov_base = headers[i];
+            iov[iovcnt].iov_len = header_len;
+            iovcnt++;
+            if (msg.header.msg_len != 0) {
+                iov[iovcnt].iov_base = const_cast<char *>(msg.message);
+                iov[iovcnt].iov_len = msg.header.msg_len;
+                iovcnt++;
+            }
+            write_len += header_len + msg.header.msg_len;
+        }
+
+        size_t bytes_written = sock_writev(sock_fd, iov, iovcnt);
+        if (bytes_written < write_len) {
+            log(LogPriority::ERROR, "failure to write message: wrote: %lu, expected: %lu",
+                    bytes_written, write_len);
+            return -1;
+        }
+        msgs += batch;
+        n_msgs -= batch;
     }
     return 0;
 }
@@ -245,18 +386,29 @@ int write_message(int sock_fd, message_t &msg)
 //             -1         error  
 int read_message(int sock_fd, message_t &msg)
 {
-    memzero(&msg, sizeof(msg));
+    msg = message_t{};
 
-    size_t bytes_read = sock_readn(sock_fd, &(msg.header), sizeof(msg.header));
+    char header[WIRE_HEADER_SIZE];
+    size_t bytes_read = sock_readn(sock_fd, header, sizeof(header));
     if (bytes_read == 0) {
         return EOF;
-    } else if (bytes_read < sizeof(msg.header)) {
+    } else if (bytes_read < sizeof(header)) {
+        return -1;
+    }
+
+    int target_len = decode_header(header, msg.header);
+    if (target_len == -1) {
+        log(LogPriority::ERROR, "malformed message header\n");
+        return -1;
+    }
+
+    bytes_read = sock_readn(sock_fd, msg.header.target, target_len);
+    if (bytes_read < static_cast<size_t>(target_len)) {
+        return -1;
+    }
+    bytes_read = sock_readn(sock_fd, msg.message, msg.header.msg_len);
+    if (bytes_read < msg.header.msg_len) {
         return -1;
-    } else {
-        bytes_read = sock_readn(sock_fd, &msg.message, msg.header.msg_len);
-        if (bytes_read < msg.header.msg_len) {
-            return -1;
-        }
     }
     return 0; 
 }
@@ -288,6 +440,52 @@ std::pair<std::string, bool> get_hostname(struct sockaddr_storage *addr_storage,
 }
 
 
+// Format the numeric address of a peer without calling the resolver
+//
+// @param[in]   addr_storage    address of the peer
+// @param[out]  buffer          null terminated address
+// @param[in]   size            size of buffer, ADDRESS_MAX_SIZE is always enough
+// @param[in]   with_port       append the port as host:port, or [host]:port for IPv6
+//
+// @return  length of the formatted address
+//         -1 if the address family is unknown or buffer is too small
+int format_address(const struct sockaddr_storage *addr_storage, char *buffer, size_t size, bool with_port)
+{
+    char host[INET6_ADDRSTRLEN];
+    uint16_t port = 0;
+    bool is_ipv6 = false;
+
+    if (addr_storage->ss_family == AF_INET) {
+        auto addr = reinterpret_cast<const struct sockaddr_in *>(addr_storage);
+        if (inet_ntop(AF_INET, &addr->sin_addr, host, sizeof(host)) == nullptr) {
+            return -1;
+        }
+        port = ntohs(addr->sin_port);
+    } else if (addr_storage->ss_family == AF_INET6) {
+        auto addr = reinterpret_cast<const struct sockaddr_in6 *>(addr_storage);
+        if (inet_ntop(AF_INET6, &addr->sin6_addr, host, sizeof(host)) == nullptr) {
+            return -1;
+        }
+        port = ntohs(addr->sin6_port);
+        is_ipv6 = true;
+    } else {
+        return -1;
+    }
+
+    int len = 0;
+    if (!with_port) {
+        len = snprintf(buffer, size, "%s", host);
+    } else if (is_ipv6) {
+        len = snprintf(buffer, size, "[%s]:%u", host, port);
+    } else {
+        len = snprintf(buffer, size, "%s:%u", host, port);
+    }
+    if (len < 0 || static_cast<size_t>(len) >= size) {
+        return -1;
+    }
+    return len;
+}
+
 // Shutdown and close a socket
 //
 // @param[in]   socket_fd   socket file descriptor to shutdown and close
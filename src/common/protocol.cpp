@@ -0,0 +1,108 @@
+// protocol.cpp
+//
+// Encoding and decoding of the on-wire message
+// format shared between client and server
+//
+// 17 October 2026
+
+#include <common/protocol.hpp>
+
+#include <cstring>
+
+// Store and load little-endian integers one byte at a time so that
+// the wire format does not depend on host byte order or alignment
+
+static inline void store_le16(char *dest, uint16_t value)
+{
+    auto out = reinterpret_cast<unsigned char *>(dest);
+    out[0] = value & 0xff;
+    out[1] = (value >> 8) & 0xff;
+}
+
+static inline void store_le64(char *dest, uint64_t value)
+{
+    auto out = reinterpret_cast<unsigned char *>(dest);
+    for (int i = 0; i < 8; i++) {
+        out[i] = (value >> (8 * i)) & 0xff;
+    }
+}
+
+static inline uint16_t load_le16(const char *src)
+{
+    auto in = reinterpret_cast<const unsigned char *>(src);
+    return static_cast<uint16_t>(in[0] | (in[1] << 8));
+}
+
+static inline uint64_t load_le64(const char *src)
+{
+    auto in = reinterpret_cast<const unsigned char *>(src);
+    uint64_t value = 0;
+    for (int i = 0; i < 8; i++) {
+        value |= static_cast<uint64_t>(in[i]) << (8 * i);
+    }
+    return value;
+}
+
+static inline size_t target_length(const msg_header_t &header)
+{
+    return strnlen(header.target, MSG_TARGET_MAX_SIZE);
+}
+
+int encode_header(const msg_header_t &header, char *buffer, size_t size)
+{
+    size_t target_len = target_length(header);
+    if (header.msg_len > MSG_DATA_MAX_SIZE || target_len >= MSG_TARGET_MAX_SIZE ||
+        header.type > MsgType::ROOM) {
+        return -1;
+    }
+    if (size < WIRE_HEADER_SIZE + target_len) {
+        return -1;
+    }
+
+    buffer[offsetof(wire_header_t, version)] = PROTOCOL_VERSION;
+    store_le16(buffer + offsetof(wire_header_t, msg_len), header.msg_len);
+    store_le64(buffer + offsetof(wire_header_t, time_stamp), header.time_stamp);
+    auto type = static_cast<uint8_t>(header.type);
+    buffer[offsetof(wire_header_t, target_len)] = static_cast<char>(target_len | (type << WIRE_TYPE_SHIFT));
+    memcpy(buffer + WIRE_HEADER_SIZE, header.target, target_len);
+
+    return WIRE_HEADER_SIZE + target_len;
+}
+
+int encode_message(const message_t &msg, char *buffer, size_t size)
+{
+    int header_len = encode_header(msg.header, buffer, size);
+    if (header_len == -1 || size - header_len < msg.header.msg_len) {
+        return -1;
+    }
+    memcpy(buffer + header_len, msg.message, msg.header.msg_len);
+    return header_len + msg.header.msg_len;
+}
+
+int decode_header(const char *buffer, msg_header_t &header)
+{
+    auto version = static_cast<uint8_t>(buffer[offsetof(wire_header_t, version)]);
+    if (version < PROTOCOL_MIN_VERSION || version > PROTOCOL_VERSION) {
+        return -1;
+    }
+
+    uint16_t msg_len = load_le16(buffer + offsetof(wire_header_t, msg_len));
+    auto target_byte = static_cast<uint8_t>(buffer[offsetof(wire_header_t, target_len)]);
+    uint8_t target_len = target_byte & WIRE_TARGET_LEN_MASK;
+    uint8_t type = target_byte >> WIRE_TYPE_SHIFT;
+    // version 1 has no type bits, so a set bit is an oversized target
+    if (msg_len > MSG_DATA_MAX_SIZE || target_len >= MSG_TARGET_MAX_SIZE ||
+        (version == 1 && type != 0)) {
+        return -1;
+    }
+
+    header.msg_len = msg_len;
+    header.type = static_cast<MsgType>(type);
+    header.time_stamp = load_le64(buffer + offsetof(wire_header_t, time_stamp));
+    return target_len;
+}
+
+size_t frame_size(const msg_header_t &header)
+{
+    return WIRE_HEADER_SIZE + target_length(header) + header.msg_len;
+}
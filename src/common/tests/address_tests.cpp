@@ -0,0 +1,69 @@
+// Test cases for formatting peer addresses
+//
+// 17 October 2026
+
+#include <common/net_common.hpp>
+
+#include <catch2/catch_all.hpp>
+
+#include <cstring>
+#include <string>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+
+static struct sockaddr_storage make_ipv4(const char *host, uint16_t port)
+{
+    struct sockaddr_storage storage{};
+    auto addr = reinterpret_cast<struct sockaddr_in *>(&storage);
+    addr->sin_family = AF_INET;
+    addr->sin_port = htons(port);
+    REQUIRE(inet_pton(AF_INET, host, &addr->sin_addr) == 1);
+    return storage;
+}
+
+static struct sockaddr_storage make_ipv6(const char *host, uint16_t port)
+{
+    struct sockaddr_storage storage{};
+    auto addr = reinterpret_cast<struct sockaddr_in6 *>(&storage);
+    addr->sin6_family = AF_INET6;
+    addr->sin6_port = htons(port);
+    REQUIRE(inet_pton(AF_INET6, host, &addr->sin6_addr) == 1);
+    return storage;
+}
+
+TEST_CASE("format address of an IPv4 peer", "[format-address-ipv4]") {
+    auto addr = make_ipv4("192.168.1.20", 54321);
+    char buffer[ADDRESS_MAX_SIZE];
+
+    REQUIRE(format_address(&addr, buffer, sizeof(buffer), true) == 18);
+    REQUIRE(std::string(buffer) == "192.168.1.20:54321");
+    REQUIRE(format_address(&addr, buffer, sizeof(buffer), false) == 12);
+    REQUIRE(std::string(buffer) == "192.168.1.20");
+}
+
+TEST_CASE("format address of an IPv6 peer", "[format-address-ipv6]") {
+    auto addr = make_ipv6("fe80::1", 80);
+    char buffer[ADDRESS_MAX_SIZE];
+
+    REQUIRE(format_address(&addr, buffer, sizeof(buffer), true) > 0);
+    REQUIRE(std::string(buffer) == "[fe80::1]:80");
+    REQUIRE(format_address(&addr, buffer, sizeof(buffer), false) > 0);
+    REQUIRE(std::string(buffer) == "fe80::1");
+
+    // the longest address still fits
+    auto longest = make_ipv6("ffff:ffff:ffff:ffff:ffff:ffff:255.255.255.255", 65535);
+    REQUIRE(format_address(&longest, buffer, sizeof(buffer), true) > 0);
+}
+
+TEST_CASE("format address rejects what it cannot format", "[format-address-errors]") {
+    auto addr = make_ipv4("10.0.0.1", 1234);
+    char small[8];
+    REQUIRE(format_address(&addr, small, sizeof(small), true) == -1);
+
+    struct sockaddr_storage unix_addr{};
+    unix_addr.ss_family = AF_UNIX;
+    char buffer[ADDRESS_MAX_SIZE];
+    REQUIRE(format_address(&unix_addr, buffer, sizeof(buffer), true) == -1);
+}
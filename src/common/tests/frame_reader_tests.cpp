@@ -0,0 +1,134 @@
+// Test cases for FrameReader class
+//
+// 17 October 2026
+
+#define CATCH_CONFIG_MAIN
+
+#include <common/frame_reader.hpp>
+#include <common/protocol.hpp>
+
+#include <catch2/catch_all.hpp>
+
+#include <cstring>
+#include <vector>
+
+#include <sys/socket.h>
+#include <unistd.h>
+
+using frame_container_t = std::vector<message_t>;
+
+// socketpair that is closed on scope exit
+struct SocketPair {
+    SocketPair()
+    {
+        REQUIRE(socketpair(AF_UNIX, SOCK_STREAM, 0, fds) == 0);
+    }
+    ~SocketPair()
+    {
+        close(fds[0]);
+        close(fds[1]);
+    }
+    int fds[2];
+};
+
+// encode text as a frame into buffer and return the frame length
+static size_t make_frame(const char *text, const char *target, char *buffer)
+{
+    message_t message{};
+    message.header.msg_len = strlen(text);
+    strncpy(message.header.target, target, MSG_TARGET_MAX_SIZE - 1);
+    memcpy(message.message, text, message.header.msg_len);
+    int frame_len = encode_message(message, buffer, MSG_FRAME_MAX_SIZE);
+    REQUIRE(frame_len > 0);
+    return frame_len;
+}
+
+TEST_CASE("frame reader decodes a whole frame", "[whole-frame]") {
+    SocketPair sockets;
+    FrameReader reader;
+    frame_container_t frames;
+
+    char frame[MSG_FRAME_MAX_SIZE];
+    size_t frame_len = make_frame("moo", "", frame);
+    REQUIRE(write(sockets.fds[0], frame, frame_len) == static_cast<ssize_t>(frame_len));
+
+    auto status = reader.read_frames(sockets.fds[1], [&frames](message_t &&frame) {
+        frames.push_back(frame);
+    });
+    REQUIRE(status == ReadStatus::AGAIN);
+    REQUIRE(frames.size() == 1);
+    REQUIRE(frames[0].header.msg_len == 3);
+    REQUIRE(strncmp(frames[0].message, "moo", 3) == 0);
+    REQUIRE(frames[0].header.target[0] == '\0');
+    REQUIRE_FALSE(reader.in_frame());
+}
+
+TEST_CASE("frame reader handles a frame sent a byte at a time", "[partial-frame]") {
+    SocketPair sockets;
+    FrameReader reader;
+    frame_container_t frames;
+
+    char bytes[MSG_FRAME_MAX_SIZE];
+    size_t n_bytes = make_frame("akkoXdianna", "receiver", bytes);
+
+    for (size_t i = 0; i < n_bytes; i++) {
+        REQUIRE(frames.empty());
+        REQUIRE(write(sockets.fds[0], bytes + i, 1) == 1);
+        auto status = reader.read_frames(sockets.fds[1], [&frames](message_t &&frame) {
+            frames.push_back(frame);
+        });
+        REQUIRE(status == ReadStatus::AGAIN);
+    }
+    REQUIRE(frames.size() == 1);
+    REQUIRE(strcmp(frames[0].header.target, "receiver") == 0);
+    REQUIRE(strncmp(frames[0].message, "akkoXdianna", frames[0].header.msg_len) == 0);
+}
+
+TEST_CASE("frame reader decodes several frames from one read", "[many-frames]") {
+    SocketPair sockets;
+    FrameReader reader;
+    frame_container_t frames;
+
+    const char *texts[] = {"one", "two", "three"};
+    char frames_buffer[3 * MSG_FRAME_MAX_SIZE];
+    size_t n_bytes = 0;
+    for (auto text : texts) {
+        n_bytes += make_frame(text, "", frames_buffer + n_bytes);
+    }
+    REQUIRE(write(sockets.fds[0], frames_buffer, n_bytes) == static_cast<ssize_t>(n_bytes));
+
+    auto status = reader.read_frames(sockets.fds[1], [&frames](message_t &&frame) {
+        frames.push_back(frame);
+    });
+    REQUIRE(status == ReadStatus::AGAIN);
+    REQUIRE(frames.size() == 3);
+    for (size_t i = 0; i < frames.size(); i++) {
+        REQUIRE(strncmp(frames[i].message, texts[i], strlen(texts[i])) == 0);
+    }
+}
+
+TEST_CASE("frame reader reports end of stream", "[end]") {
+    SocketPair sockets;
+    FrameReader reader;
+
+    REQUIRE(shutdown(sockets.fds[0], SHUT_WR) == 0);
+    auto status = reader.read_frames(sockets.fds[1], [](message_t &&) {});
+    REQUIRE(status == ReadStatus::END);
+}
+
+TEST_CASE("frame reader rejects malformed headers", "[malformed]") {
+    FrameReader reader;
+    char frame[MSG_FRAME_MAX_SIZE];
+    make_frame("moo", "", frame);
+
+    SECTION("oversized message") {
+        frame[offsetof(wire_header_t, msg_len)] = (MSG_DATA_MAX_SIZE + 1) & 0xff;
+        frame[offsetof(wire_header_t, msg_len) + 1] = (MSG_DATA_MAX_SIZE + 1) >> 8;
+    }
+
+    SECTION("unknown version") {
+        frame[offsetof(wire_header_t, version)] = PROTOCOL_VERSION + 1;
+    }
+
+    REQUIRE(reader.consume(frame, WIRE_HEADER_SIZE, [](message_t &&) {}) == -1);
+}
@@ -0,0 +1,103 @@
+// Test cases for the log backend
+//
+// 17 October 2026
+
+#include <catch2/catch_all.hpp>
+
+#include <common/log_util.hpp>
+
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <time.h>
+
+static std::mutex captured_mutex;
+static std::vector<std::string> captured;
+
+static void capture_sink(int, const char *message)
+{
+    std::lock_guard<std::mutex> lock(captured_mutex);
+    captured.emplace_back(message);
+}
+
+// everything logged so far, once it has been written
+static std::vector<std::string> logged()
+{
+    log_flush();
+    std::lock_guard<std::mutex> lock(captured_mutex);
+    auto messages = std::move(captured);
+    captured.clear();
+    return messages;
+}
+
+// wait for the start of a second so a burst falls in one window
+static void wait_for_next_second()
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC_COARSE, &now);
+    auto second = now.tv_sec;
+    while (now.tv_sec == second) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        clock_gettime(CLOCK_MONOTONIC_COARSE, &now);
+    }
+}
+
+TEST_CASE("log formats messages on the background thread", "[log-format]") {
+    log_set_sink(capture_sink);
+    logged();
+
+    std::string name = "client";
+    const char *missing = nullptr;
+    log(LogPriority::INFO, "%d %s %.*s %lu%%\n", -7, name.c_str(), 3, "abcdef", 42ul);
+    log(LogPriority::WARNING, "[%5s] [%-4d] %x %.2f %c\n", "ab", 12, 255u, 1.5, 'z');
+    log(LogPriority::ERROR, "%s %p\n", missing, static_cast<void *>(nullptr));
+
+    auto messages = logged();
+    log_set_sink(nullptr);
+    REQUIRE(messages.size() == 3);
+    REQUIRE(messages[0] == "-7 client abc 42%\n");
+    REQUIRE(messages[1] == "[   ab] [12  ] ff 1.50 z\n");
+    REQUIRE(messages[2].rfind("(null) ", 0) == 0);
+}
+
+TEST_CASE("log limits the rate of each call site", "[log-rate]") {
+    log_set_sink(capture_sink);
+    logged();
+
+    wait_for_next_second();
+    for (int i = 0; i < 2; i++) {
+        for (int j = 0; j < 50; j++) {
+            log(LogPriority::INFO, "flood %d\n", j);
+        }
+        if (i == 0) {
+            auto messages = logged();
+            REQUIRE(messages.size() == LOG_SITE_MAX_PER_SECOND);
+            REQUIRE(messages.back() == "flood 19\n");
+            wait_for_next_second();
+        }
+    }
+
+    // the first message of the next second reports what was dropped
+    auto messages = logged();
+    log_set_sink(nullptr);
+    REQUIRE(messages.size() == LOG_SITE_MAX_PER_SECOND);
+    REQUIRE(messages.front() == "flood 0 (30 earlier messages suppressed)\n");
+}
+
+TEST_CASE("log calls below the compiled priority are removed", "[log-compiled-out]") {
+    log_set_sink(capture_sink);
+    logged();
+
+    int evaluated = 0;
+    auto side_effect = [&evaluated]() { return ++evaluated; };
+    log(LogPriority::DEBUG, "debug %d\n", side_effect());
+    log(LogPriority::INFO, "info %d\n", side_effect());
+
+    auto messages = logged();
+    log_set_sink(nullptr);
+    REQUIRE(evaluated == 1);
+    REQUIRE(messages.size() == 1);
+    REQUIRE(messages[0] == "info 1\n");
+}
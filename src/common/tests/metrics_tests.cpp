@@ -0,0 +1,104 @@
+// Test cases for the metrics registry
+//
+// 17 October 2026
+
+#include <common/metrics.hpp>
+
+#include <catch2/catch_all.hpp>
+
+#include <string>
+#include <thread>
+#include <vector>
+
+TEST_CASE("counters add up updates from every thread", "[metrics-counter]") {
+    const int n_threads = 12;
+    const int n_adds = 10000;
+    Counter counter;
+    Gauge gauge;
+
+    std::vector<std::thread> threads;
+    for (int i = 0; i < n_threads; i++) {
+        threads.emplace_back([&counter, &gauge, i]() {
+            for (int j = 0; j < n_adds; j++) {
+                counter.add();
+                // half the threads take away what the other half add
+                if (i % 2 == 0) {
+                    gauge.add(2);
+                } else {
+                    gauge.sub();
+                }
+            }
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    REQUIRE(counter.value() == static_cast<uint64_t>(n_threads) * n_adds);
+    REQUIRE(gauge.value() == static_cast<int64_t>(n_threads / 2) * n_adds);
+}
+
+TEST_CASE("histogram buckets keep a fixed relative precision", "[metrics-histogram]") {
+    SECTION("buckets cover every value once") {
+        for (uint64_t value : {0ul, 1ul, 31ul, 32ul, 63ul, 64ul, 1000ul, 123456789ul, (1ul << 47) + 5}) {
+            size_t bucket = Histogram::bucket_of(value);
+            REQUIRE(bucket < HISTOGRAM_BUCKETS);
+            REQUIRE(Histogram::bucket_low(bucket) <= value);
+            REQUIRE(value <= Histogram::bucket_high(bucket));
+            REQUIRE(Histogram::bucket_high(bucket) - Histogram::bucket_low(bucket) <= value / 32);
+        }
+        for (size_t bucket = 1; bucket < HISTOGRAM_BUCKETS; bucket++) {
+            REQUIRE(Histogram::bucket_low(bucket) == Histogram::bucket_high(bucket - 1) + 1);
+        }
+        REQUIRE(Histogram::bucket_of(UINT64_MAX) == HISTOGRAM_BUCKETS - 1);
+    }
+
+    SECTION("percentiles come from the recorded values") {
+        Histogram histogram;
+        for (uint64_t value = 1; value <= 1000; value++) {
+            histogram.record(value * 1000);
+        }
+        REQUIRE(histogram.count() == 1000);
+        REQUIRE(histogram.sum() == 500500 * 1000);
+        auto median = histogram.percentile(50);
+        REQUIRE(median >= 500000);
+        REQUIRE(median <= 500000 * 33 / 32);
+        auto p99 = histogram.percentile(99);
+        REQUIRE(p99 >= 990000);
+        REQUIRE(p99 <= 990000 * 33 / 32);
+        REQUIRE(histogram.percentile(100) >= 1000000);
+        REQUIRE(histogram.count_below(1 << 9) == 0);
+        REQUIRE(histogram.count_below(1 << 10) == 1);
+        REQUIRE(histogram.count_below(1 << 20) == 1000);
+        REQUIRE(Histogram().percentile(99) == 0);
+    }
+}
+
+TEST_CASE("registry renders the Prometheus text format", "[metrics-render]") {
+    MetricsRegistry registry;
+    registry.counter("test_requests_total", "Requests.").add(3);
+    registry.gauge("test_open", "Open things.").add(2);
+    auto &latency = registry.histogram("test_latency_seconds", "Latency.", 1e-3);
+    latency.record(1);
+    latency.record(5);
+
+    // asking again gives the same metric
+    registry.counter("test_requests_total", "Requests.").add();
+    REQUIRE_THROWS(registry.gauge("test_requests_total", "Requests."));
+
+    auto text = registry.render();
+    auto has = [&text](const std::string &line) { return text.find(line + "\n") != std::string::npos; };
+    REQUIRE(has("# HELP test_requests_total Requests."));
+    REQUIRE(has("# TYPE test_requests_total counter"));
+    REQUIRE(has("test_requests_total 4"));
+    REQUIRE(has("# TYPE test_open gauge"));
+    REQUIRE(has("test_open 2"));
+    REQUIRE(has("# TYPE test_latency_seconds histogram"));
+    REQUIRE(has("test_latency_seconds_bucket{le=\"0\"} 0"));
+    REQUIRE(has("test_latency_seconds_bucket{le=\"0.001\"} 1"));
+    REQUIRE(has("test_latency_seconds_bucket{le=\"0.003\"} 1"));
+    REQUIRE(has("test_latency_seconds_bucket{le=\"0.007\"} 2"));
+    REQUIRE_FALSE(has("test_latency_seconds_bucket{le=\"0.015\"} 2"));
+    REQUIRE(has("test_latency_seconds_bucket{le=\"+Inf\"} 2"));
+    REQUIRE(has("test_latency_seconds_sum 0.006"));
+    REQUIRE(has("test_latency_seconds_count 2"));
+}
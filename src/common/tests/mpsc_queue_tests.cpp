@@ -0,0 +1,104 @@
+// Test cases for MpscQueue class
+//
+// 17 October 2026
+
+#include <common/mpsc_queue.hpp>
+
+#include <catch2/catch_all.hpp>
+
+#include <memory>
+#include <thread>
+#include <vector>
+
+TEST_CASE("mpsc queue is first in first out", "[mpsc-fifo]") {
+    MpscQueue<int> queue(4);
+    int value = 0;
+
+    REQUIRE(queue.empty());
+    REQUIRE_FALSE(queue.try_pop(value));
+    for (int i = 0; i < 3; i++) {
+        REQUIRE(queue.try_push(std::move(i)));
+    }
+    REQUIRE_FALSE(queue.empty());
+    for (int i = 0; i < 3; i++) {
+        REQUIRE(queue.try_pop(value));
+        REQUIRE(value == i);
+    }
+    REQUIRE(queue.empty());
+}
+
+TEST_CASE("mpsc queue is bounded", "[mpsc-bounded]") {
+    MpscQueue<int> queue(3);
+    REQUIRE(queue.capacity() == 4);
+
+    for (int i = 0; i < 4; i++) {
+        REQUIRE(queue.try_push(std::move(i)));
+    }
+    int extra = 4;
+    REQUIRE_FALSE(queue.try_push(std::move(extra)));
+
+    // popping frees a slot and the queue keeps working as it wraps
+    for (int i = 0; i < 10; i++) {
+        int value = -1;
+        REQUIRE(queue.try_pop(value));
+        REQUIRE(value == i);
+        int next = i + 4;
+        REQUIRE(queue.try_push(std::move(next)));
+    }
+}
+
+TEST_CASE("mpsc queue does not copy or leak values", "[mpsc-move]") {
+    MpscQueue<std::shared_ptr<int>> queue(2);
+    auto value = std::make_shared<int>(42);
+
+    auto queued = value;
+    REQUIRE(queue.try_push(std::move(queued)));
+    REQUIRE(value.use_count() == 2);
+
+    std::shared_ptr<int> popped;
+    REQUIRE(queue.try_pop(popped));
+    REQUIRE(*popped == 42);
+    popped.reset();
+    REQUIRE(value.use_count() == 1);
+}
+
+TEST_CASE("mpsc queue keeps each producer in order", "[mpsc-producers]") {
+    const int n_producers = 4;
+    const int n_values = 50000;
+    MpscQueue<std::pair<int, int>> queue(256);
+
+    std::vector<std::thread> producers;
+    for (int producer = 0; producer < n_producers; producer++) {
+        producers.emplace_back([&queue, producer]() {
+            for (int i = 0; i < n_values; i++) {
+                std::pair<int, int> value{producer, i};
+                while (!queue.try_push(std::move(value))) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+
+    std::vector<int> next(n_producers, 0);
+    int received = 0;
+    bool in_order = true;
+    while (received < n_producers * n_values) {
+        std::pair<int, int> value;
+        if (!queue.try_pop(value)) {
+            std::this_thread::yield();
+            continue;
+        }
+        in_order = in_order && value.second == next[value.first];
+        next[value.first] = value.second + 1;
+        received++;
+    }
+    for (auto &producer : producers) {
+        producer.join();
+    }
+
+    REQUIRE(in_order);
+    REQUIRE(queue.empty());
+    for (int count : next) {
+        REQUIRE(count == n_values);
+    }
+}
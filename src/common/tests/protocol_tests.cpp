@@ -0,0 +1,185 @@
+// Test cases for encoding and decoding the wire protocol
+//
+// 17 October 2026
+
+#include <common/frame.hpp>
+#include <common/net_common.hpp>
+#include <common/protocol.hpp>
+
+#include <catch2/catch_all.hpp>
+
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <sys/socket.h>
+#include <unistd.h>
+
+static message_t make_message(const char *text, const char *target, uint64_t time_stamp)
+{
+    message_t message{};
+    message.header.msg_len = strlen(text);
+    message.header.time_stamp = time_stamp;
+    strncpy(message.header.target, target, MSG_TARGET_MAX_SIZE - 1);
+    memcpy(message.message, text, message.header.msg_len);
+    return message;
+}
+
+TEST_CASE("wire header is little-endian", "[encode]") {
+    auto message = make_message("moo", "bob", 0x0102030405060708);
+    char frame[MSG_FRAME_MAX_SIZE];
+
+    int frame_len = encode_message(message, frame, sizeof(frame));
+    REQUIRE(frame_len == static_cast<int>(WIRE_HEADER_SIZE + 3 + 3));
+    REQUIRE(static_cast<size_t>(frame_len) == frame_size(message.header));
+
+    const unsigned char expected[] = {
+        PROTOCOL_VERSION,
+        0x03, 0x00,
+        0x08, 0x07, 0x06, 0x05, 0x04, 0x03, 0x02, 0x01,
+        0x03,
+        'b', 'o', 'b',
+        'm', 'o', 'o'
+    };
+    REQUIRE(memcmp(frame, expected, sizeof(expected)) == 0);
+}
+
+TEST_CASE("wire header round trips", "[round-trip]") {
+    auto message = make_message("akkoXdianna", "receiver", 1624060800);
+    char frame[MSG_FRAME_MAX_SIZE];
+    REQUIRE(encode_message(message, frame, sizeof(frame)) > 0);
+
+    msg_header_t header{};
+    int target_len = decode_header(frame, header);
+    REQUIRE(target_len == static_cast<int>(strlen("receiver")));
+    REQUIRE(header.msg_len == message.header.msg_len);
+    REQUIRE(header.time_stamp == message.header.time_stamp);
+    REQUIRE(memcmp(frame + WIRE_HEADER_SIZE, "receiver", target_len) == 0);
+    REQUIRE(memcmp(frame + WIRE_HEADER_SIZE + target_len, "akkoXdianna", header.msg_len) == 0);
+}
+
+TEST_CASE("frames are encoded once", "[frame]") {
+    auto message = make_message("akkoXdianna", "receiver", 42);
+    auto frame = make_frame(message);
+    REQUIRE(frame != nullptr);
+    REQUIRE(frame->len == frame_size(message.header));
+    REQUIRE(frame->target() == "receiver");
+
+    char expected[MSG_FRAME_MAX_SIZE];
+    REQUIRE(encode_message(message, expected, sizeof(expected)) == static_cast<int>(frame->len));
+    REQUIRE(memcmp(frame->data, expected, frame->len) == 0);
+
+    message.header.msg_len = MSG_DATA_MAX_SIZE + 1;
+    REQUIRE(make_frame(message) == nullptr);
+}
+
+TEST_CASE("control frames carry their type", "[control-frame]") {
+    auto type = GENERATE(MsgType::DATA, MsgType::PING, MsgType::PONG, MsgType::ROOM);
+    auto message = make_message("", "", 7);
+    message.header.type = type;
+    auto frame = make_frame(message);
+    REQUIRE(frame != nullptr);
+    REQUIRE(frame->type() == type);
+    REQUIRE(frame->target().empty());
+
+    msg_header_t header{};
+    REQUIRE(decode_header(frame->data, header) == 0);
+    REQUIRE(header.type == type);
+    REQUIRE(header.time_stamp == 7);
+}
+
+TEST_CASE("version 1 frames are still decoded", "[version-1]") {
+    auto message = make_message("moo", "bob", 1);
+    char frame[MSG_FRAME_MAX_SIZE];
+    REQUIRE(encode_message(message, frame, sizeof(frame)) > 0);
+    frame[offsetof(wire_header_t, version)] = 1;
+
+    msg_header_t header{};
+    REQUIRE(decode_header(frame, header) == 3);
+    REQUIRE(header.type == MsgType::DATA);
+
+    // version 1 has no type bits
+    frame[offsetof(wire_header_t, target_len)] |= static_cast<char>(1 << WIRE_TYPE_SHIFT);
+    REQUIRE(decode_header(frame, header) == -1);
+}
+
+TEST_CASE("encode rejects invalid messages", "[encode-invalid]") {
+    char frame[MSG_FRAME_MAX_SIZE];
+
+    SECTION("oversized message") {
+        auto message = make_message("moo", "", 0);
+        message.header.msg_len = MSG_DATA_MAX_SIZE + 1;
+        REQUIRE(encode_message(message, frame, sizeof(frame)) == -1);
+    }
+
+    SECTION("unterminated target") {
+        auto message = make_message("moo", "", 0);
+        memset(message.header.target, 'a', sizeof(message.header.target));
+        REQUIRE(encode_message(message, frame, sizeof(frame)) == -1);
+    }
+
+    SECTION("buffer too small") {
+        auto message = make_message("moo", "bob", 0);
+        REQUIRE(encode_message(message, frame, WIRE_HEADER_SIZE + 3) == -1);
+        REQUIRE(encode_header(message.header, frame, WIRE_HEADER_SIZE) == -1);
+    }
+}
+
+TEST_CASE("messages round trip over a socket", "[socket-round-trip]") {
+    int fds[2];
+    REQUIRE(socketpair(AF_UNIX, SOCK_STREAM, 0, fds) == 0);
+
+    auto message = make_message("test", "receiver", 42);
+    REQUIRE(write_message(fds[0], message) == 0);
+
+    message_t received{};
+    REQUIRE(read_message(fds[1], received) == 0);
+    REQUIRE(received.header.msg_len == 4);
+    REQUIRE(received.header.time_stamp == 42);
+    REQUIRE(strcmp(received.header.target, "receiver") == 0);
+    REQUIRE(strncmp(received.message, "test", 4) == 0);
+
+    close(fds[0]);
+    close(fds[1]);
+}
+
+TEST_CASE("several messages are written in one call", "[write-messages]") {
+    int fds[2];
+    REQUIRE(socketpair(AF_UNIX, SOCK_STREAM, 0, fds) == 0);
+
+    // more than one writev batch worth of messages, including an empty one
+    const size_t n_msgs = MAX_WRITE_BATCH + 3;
+    std::vector<message_t> messages;
+    std::vector<const message_t *> msg_ptrs;
+    for (size_t i = 0; i < n_msgs; i++) {
+        auto text = std::to_string(i);
+        messages.push_back(make_message(i == 1 ? "" : text.c_str(), i % 2 ? "bob" : "", i));
+    }
+    for (auto &message : messages) {
+        msg_ptrs.push_back(&message);
+    }
+
+    // read on another thread so that the socket buffer cannot fill up
+    std::vector<message_t> received(n_msgs);
+    std::vector<int> read_rcs(n_msgs);
+    std::thread reader([&fds, &received, &read_rcs]() {
+        for (size_t i = 0; i < received.size(); i++) {
+            read_rcs[i] = read_message(fds[1], received[i]);
+        }
+    });
+    REQUIRE(write_messages(fds[0], msg_ptrs.data(), msg_ptrs.size()) == 0);
+    reader.join();
+
+    for (size_t i = 0; i < n_msgs; i++) {
+        auto &expected = messages[i];
+        REQUIRE(read_rcs[i] == 0);
+        REQUIRE(received[i].header.time_stamp == expected.header.time_stamp);
+        REQUIRE(received[i].header.msg_len == expected.header.msg_len);
+        REQUIRE(strcmp(received[i].header.target, expected.header.target) == 0);
+        REQUIRE(memcmp(received[i].message, expected.message, expected.header.msg_len) == 0);
+    }
+
+    close(fds[0]);
+    close(fds[1]);
+}
@@ -8,9 +8,17 @@
 #include <common/utilities.hpp>
 
 #include <cassert>
+#include <cerrno>
+#include <cstdint>
 #include <stdexcept>
 
+#include <fcntl.h>
 #include <unistd.h>
+#include <sys/resource.h>
+
+#if __linux__
+#include <sys/eventfd.h>
+#endif
 
 Channel::Channel():
     read_pipe(0),
@@ -41,3 +49,77 @@ auto Channel::write(const std::string &msg) -> int
 {
     return ::write(get_write_end(), msg.c_str(), msg.size());
 }
+
+EventNotifier::EventNotifier():
+    read_fd(-1),
+    write_fd(-1)
+{
+#if __linux__
+    read_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (read_fd == -1) {
+        throw std::runtime_error("Unable to create notifier");
+    }
+    write_fd = read_fd;
+#else
+    int pipe_fd[2];
+    if (pipe(pipe_fd)) {
+        throw std::runtime_error("Unable to create notifier");
+    }
+    for (int fd : pipe_fd) {
+        fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+    }
+    read_fd = pipe_fd[0];
+    write_fd = pipe_fd[1];
+#endif
+}
+
+EventNotifier::~EventNotifier()
+{
+    close(read_fd);
+    if (write_fd != read_fd) {
+        close(write_fd);
+    }
+}
+
+// Make the notifier readable
+//
+// @return  0 on success
+//         -1 on error
+auto EventNotifier::notify() -> int
+{
+#if __linux__
+    uint64_t value = 1;
+    ssize_t rc = ::write(write_fd, &value, sizeof(value));
+#else
+    char value = 0;
+    ssize_t rc = ::write(write_fd, &value, sizeof(value));
+    if (rc == -1 && errno == EAGAIN) {
+        // pipe is full so it is readable already
+        return 0;
+    }
+#endif
+    return rc == -1 ? -1 : 0;
+}
+
+// Consume all pending notifications
+auto EventNotifier::drain() -> void
+{
+    char buffer[64];
+    while (::read(read_fd, buffer, sizeof(buffer)) > 0) {
+    }
+}
+
+auto raise_fd_limit() -> size_t
+{
+    struct rlimit limit;
+    if (getrlimit(RLIMIT_NOFILE, &limit)) {
+        return 0;
+    }
+    if (limit.rlim_cur < limit.rlim_max) {
+        limit.rlim_cur = limit.rlim_max;
+        if (setrlimit(RLIMIT_NOFILE, &limit)) {
+            getrlimit(RLIMIT_NOFILE, &limit);
+        }
+    }
+    return limit.rlim_cur;
+}
@@ -8,6 +8,9 @@
 #include <common/log_util.hpp>
 #include <io_multiplexor/EpollMultiplexor.hpp>
 
+#include <cerrno>
+#include <climits>
+#include <cstdint>
 #include <exception>
 #include <memory>
 
@@ -16,8 +19,35 @@
 
 using namespace std;
 
+// epoll_event.data holds either the data pointer given for an fd
+// or the fd itself. The fd is stored shifted with the low bit set,
+// which no data pointer has since they must be at least 2 byte
+// aligned, so the two are told apart when the event comes back.
+static void set_event_data(struct epoll_event &ev, const io_mplex_fd_info_t &fd_info)
+{
+    ev.data.u64 = 0;
+    if (fd_info.data != nullptr) {
+        ev.data.ptr = fd_info.data;
+    } else {
+        ev.data.u64 = (static_cast<uint64_t>(fd_info.fd) << 1) | 1;
+    }
+}
+
+static void get_event_data(const struct epoll_event &ev, int &fd, void *&data)
+{
+    if (ev.data.u64 & 1) {
+        fd = static_cast<int>(ev.data.u64 >> 1);
+        data = nullptr;
+    } else {
+        fd = -1;
+        data = ev.data.ptr;
+    }
+}
+
 EpollMultiplexor::EpollMultiplexor(unsigned max_events):
-    IoMultiplexor(max_events)
+    IoMultiplexor(max_events),
+    event_list_(new struct epoll_event[max_events]),
+    has_pwait2_(true)
 {
     // 
     instance_fd_ = epoll_create(max_events);
@@ -35,30 +65,80 @@ EpollMultiplexor::~EpollMultiplexor()
 
 int EpollMultiplexor::wait(struct timespec *timeout, std::vector<io_mplex_fd_info_t> &events)
 {
-    struct epoll_event event_list[max_events_];
-    
+    struct timespec shortened;
+    int n_events = wait_ready(timer_timeout(timeout, shortened), max_events_);
+    if (n_events == -1) {
+        return n_events;
+    }
+    events.reserve(events.size() + n_events);
+    for (int i = 0; i < n_events; i++) {
+        auto filters = flags_to_mplex(event_list_[i].events);
+        io_mplex_fd_info_t fd_info{filters, filters, -1};
+        get_event_data(event_list_[i], fd_info.fd, fd_info.data);
+        events.push_back(fd_info);
+    }
+    return n_events + report_timers(events);
+}
+
+////
+// @brief wait for events without allocating
+//
+// @param[in]   timeout     nullptr waits indefinitely
+// @param[out]  events      caller owned array for the events
+// @param[in]   max_events  size of events
+//
+// @return number of events
+//         -1 on error
+int EpollMultiplexor::wait(struct timespec *timeout, io_mplex_event_t *events, unsigned max_events)
+{
+    struct timespec shortened;
+    int n_events = wait_ready(timer_timeout(timeout, shortened), max_events);
+    for (int i = 0; i < n_events; i++) {
+        events[i].filters = flags_to_mplex(event_list_[i].events);
+        get_event_data(event_list_[i], events[i].fd, events[i].data);
+        events[i].result = 0;
+        events[i].buffer = nullptr;
+    }
+    return report_timers(events, n_events, max_events);
+}
+
+////
+// @brief wait on the epoll instance
+//
+// @param[in]   timeout     nullptr waits indefinitely
+// @param[in]   max_events  most events to take
+//
+// @return epoll_wait status, the events are left in event_list_
+//
+// @note epoll_pwait2 takes the timeout as is. Without it the timeout
+//       is rounded up to whole milliseconds so that a short wait never
+//       turns into a busy poll.
+int EpollMultiplexor::wait_ready(struct timespec *timeout, unsigned max_events)
+{
+    if (max_events > max_events_) {
+        max_events = max_events_;
+    }
+#if defined(__GLIBC__) && __GLIBC_PREREQ(2, 35)
+    if (has_pwait2_) {
+        int n_events = epoll_pwait2(instance_fd_, event_list_.get(), max_events, timeout, nullptr);
+        if (n_events != -1 || errno != ENOSYS) {
+            return n_events;
+        }
+        // built against a newer kernel than the one running
+        has_pwait2_ = false;
+    }
+#endif
+
     // Epoll semanitcs on the wait:
     //      -1 wait indefinitely
     //       0 return immediately
-    //       _ wait that many seconds
-    int wait_seconds = -1;
+    //       _ wait that many milliseconds
+    int wait_ms = -1;
     if (timeout != nullptr) {
-        wait_seconds = timeout->tv_sec;
-        log(LogPriority::INFO, "Wait seconds: %d\n", wait_seconds); 
-    }
-
-    int n_events = epoll_wait(instance_fd_, event_list, max_events_, wait_seconds);  
-    if (n_events == -1 || n_events == 0) {
-        return n_events;
-    }
-    events.reserve(n_events);
-    for (int i = 0; i < n_events; i++) {
-        auto& event = event_list[i];
-        auto flags = flags_to_mplex(event.events);
-        auto filters = flags_to_mplex(event.events);
-        events.push_back({flags, filters, event.data.fd});
+        int64_t ms = static_cast<int64_t>(timeout->tv_sec) * 1000 + (timeout->tv_nsec + 999999) / 1000000;
+        wait_ms = ms > INT_MAX ? INT_MAX : static_cast<int>(ms);
     }
-    return n_events;
+    return epoll_wait(instance_fd_, event_list_.get(), max_events, wait_ms);
 }
 
 int EpollMultiplexor::add(const io_mplex_fd_info_t &fd_info) 
@@ -67,13 +147,15 @@ int EpollMultiplexor::add(const io_mplex_fd_info_t &fd_info)
     int epoll_filters = flags_from_mplex(fd_info.filters);
    
     struct epoll_event ev;
-    ev.data.fd = fd_info.fd; 
+    set_event_data(ev, fd_info);
     ev.events = epoll_flags | epoll_filters;
 
     int rc = epoll_ctl(instance_fd_, EPOLL_CTL_ADD, fd_info.fd, &ev);
     if (rc) {
         log(LogPriority::ERROR, "Unable to add to epoll instance\n");
+        return rc;
     }
+    n_events_++;
     return rc;
 }
 
@@ -95,9 +177,26 @@ int EpollMultiplexor::add(std::vector<io_mplex_fd_info_t> &&fd_list)
     return add(fd_list);
 }
 
+int EpollMultiplexor::modify(const io_mplex_fd_info_t &fd_info)
+{
+    struct epoll_event ev;
+    set_event_data(ev, fd_info);
+    ev.events = flags_from_mplex(fd_info.flags) | flags_from_mplex(fd_info.filters);
+
+    int rc = epoll_ctl(instance_fd_, EPOLL_CTL_MOD, fd_info.fd, &ev);
+    if (rc) {
+        log(LogPriority::ERROR, "Unable to modify epoll instance\n");
+    }
+    return rc;
+}
+
 int EpollMultiplexor::remove(const int fd) 
 {
-    return epoll_ctl(instance_fd_, EPOLL_CTL_DEL, fd, nullptr); 
+    int rc = epoll_ctl(instance_fd_, EPOLL_CTL_DEL, fd, nullptr); 
+    if (rc == 0) {
+        n_events_--;
+    }
+    return rc;
 }
 
 int EpollMultiplexor::remove(const std::vector<int> &fd_list)
@@ -131,6 +230,18 @@ int EpollMultiplexor::flags_from_mplex(io_mplex_flags_t mplex_values)
     if (mplex_values & MPLEX_ONESHOT) {
         flags |= EPOLLONESHOT;
     }
+    if (mplex_values & MPLEX_EOF) {
+        // also report a peer that has shut down its end for writing
+        flags |= EPOLLRDHUP;
+    }
+    if (mplex_values & MPLEX_EDGE) {
+        flags |= EPOLLET;
+    }
+#ifdef EPOLLEXCLUSIVE
+    if (mplex_values & MPLEX_EXCLUSIVE) {
+        flags |= EPOLLEXCLUSIVE;
+    }
+#endif
     // epoll always waits for EPOLLHUP and EPOLLERR
     // so they are not checked for or added
 
@@ -146,7 +257,7 @@ io_mplex_flags_t EpollMultiplexor::flags_to_mplex(int epoll_values)
     if (epoll_values & EPOLLOUT) {
         flags |= MPLEX_OUT;
     }
-    if (epoll_values & EPOLLHUP) {
+    if (epoll_values & (EPOLLHUP | EPOLLRDHUP)) {
         flags |= MPLEX_EOF;
     }
     if (epoll_values & EPOLLERR) {
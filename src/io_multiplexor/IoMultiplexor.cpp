@@ -0,0 +1,111 @@
+// IoMultiplexor.cpp
+//
+// Timer handling shared by every multiplexor.
+//
+// 17 October 2026
+
+#include <io_multiplexor/IoMultiplexor.hpp>
+
+#include <common/metrics.hpp>
+
+#include <chrono>
+
+////
+// @brief count the events returned by a wait
+//
+// @note every wait into caller owned events ends by reporting its
+//       timers, so it is counted there
+static void record_wait(int n_events)
+{
+    static Histogram &wait_events = MetricsRegistry::instance().histogram(
+        "chat_mplex_wait_events", "Events returned by each multiplexor wait, timers included.");
+    wait_events.record(n_events);
+}
+
+////
+// @brief milliseconds on a monotonic clock, the multiplexor's timer ticks
+uint64_t IoMultiplexor::clock_ms()
+{
+    auto now = std::chrono::steady_clock::now().time_since_epoch();
+    return std::chrono::duration_cast<std::chrono::milliseconds>(now).count();
+}
+
+////
+// @brief start a timer, restarting it if it is already running
+//
+// @param[in]   timer       timer to start, its data is reported when it expires
+// @param[in]   timeout_ms  milliseconds until it expires
+void IoMultiplexor::start_timer(mplex_timer_t &timer, uint64_t timeout_ms)
+{
+    // catch the wheel up so the timeout counts from now. Part of the
+    // current tick has already gone, so one more is added to make sure
+    // the timer never expires early.
+    timers_.advance(clock_ms());
+    timers_.schedule(timer, timeout_ms + 1);
+}
+
+////
+// @brief shorten a wait so that it ends when the next timer is due
+//
+// @param[in]   timeout     timeout asked for, nullptr waits indefinitely
+// @param[out]  shortened   storage for a shorter timeout
+//
+// @return timeout or &shortened
+struct timespec *IoMultiplexor::timer_timeout(struct timespec *timeout, struct timespec &shortened)
+{
+    timers_.advance(clock_ms());
+    int64_t next_ms = timers_.next_timeout();
+    if (next_ms < 0) {
+        return timeout;
+    }
+    shortened.tv_sec = next_ms / 1000;
+    shortened.tv_nsec = (next_ms % 1000) * 1000000;
+    if (timeout != nullptr &&
+        (timeout->tv_sec < shortened.tv_sec ||
+         (timeout->tv_sec == shortened.tv_sec && timeout->tv_nsec < shortened.tv_nsec))) {
+        return timeout;
+    }
+    return &shortened;
+}
+
+////
+// @brief add expired timers to the events from a wait
+//
+// @param[out]  events      caller owned events
+// @param[in]   n_events    events already filled, -1 if the wait failed
+// @param[in]   max_events  size of events
+//
+// @return number of events including timers, or -1
+//
+// @note timers that do not fit are reported by the next wait
+int IoMultiplexor::report_timers(io_mplex_event_t *events, int n_events, unsigned max_events)
+{
+    if (n_events == -1) {
+        return -1;
+    }
+    timers_.advance(clock_ms());
+    mplex_timer_t *timer = nullptr;
+    while (static_cast<unsigned>(n_events) < max_events && (timer = timers_.pop_expired()) != nullptr) {
+        events[n_events++] = {MPLEX_TIMER, -1, timer->data, 0, nullptr};
+    }
+    record_wait(n_events);
+    return n_events;
+}
+
+////
+// @brief add expired timers to the events from a wait
+//
+// @param[out]  events      events from the wait
+//
+// @return number of timers added
+int IoMultiplexor::report_timers(std::vector<io_mplex_fd_info_t> &events)
+{
+    timers_.advance(clock_ms());
+    int n_timers = 0;
+    mplex_timer_t *timer = nullptr;
+    while ((timer = timers_.pop_expired()) != nullptr) {
+        events.push_back({MPLEX_TIMER, MPLEX_TIMER, -1, timer->data});
+        n_timers++;
+    }
+    return n_timers;
+}
@@ -0,0 +1,41 @@
+// IoMultiplexorFactory.cpp
+//
+// Picks the multiplexor for the platform and the
+// requested backend.
+//
+// 17 October 2026
+
+#include <common/log_util.hpp>
+#include <io_multiplexor/IoMultiplexorFactory.hpp>
+#if __linux__
+#include <io_multiplexor/UringMultiplexor.hpp>
+#endif
+
+#include <exception>
+#include <stdexcept>
+
+////
+// @brief create a multiplexor for the platform
+//
+// @param[in]   max_events  most events returned by a single wait
+// @param[in]   backend     implementation to use, io_uring falls back
+//                          to the native multiplexor if it is unavailable
+std::unique_ptr<IoMultiplexor> IoMultiplexorFactory::get_multiplexor(unsigned max_events,
+                                                                     MplexBackend backend)
+{
+#if __linux__
+    if (backend == MplexBackend::URING) {
+        try {
+            return std::unique_ptr<UringMultiplexor>(new UringMultiplexor(max_events));
+        } catch (const std::runtime_error &e) {
+            log(LogPriority::WARNING, "%s -- falling back to epoll\n", e.what());
+        }
+    }
+    return std::unique_ptr<EpollMultiplexor>(new EpollMultiplexor(max_events));
+#elif __FreeBSD__
+    (void)backend;
+    return std::unique_ptr<KqueueMultiplexor>(new KqueueMultiplexor(max_events));
+#else
+    #error UNSUPPORTED_PLATFORM
+#endif
+}
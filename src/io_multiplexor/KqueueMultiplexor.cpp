@@ -24,7 +24,8 @@ using namespace std;
 // @throws std::runtime_error if unable to 
 //         create kqueue
 KqueueMultiplexor::KqueueMultiplexor(unsigned max_events):
-    IoMultiplexor(max_events)
+    IoMultiplexor(max_events),
+    event_list_(new struct kevent[max_events])
 {
     instance_fd_ = kqueue();
     if (instance_fd_ == -1) {
@@ -51,21 +52,47 @@ KqueueMultiplexor::~KqueueMultiplexor()
 // @return kevent status 
 int KqueueMultiplexor::wait(struct timespec *timeout, std::vector<io_mplex_fd_info_t> &events) 
 {
-    struct kevent event_list[max_events_]; 
-
-    int count = kevent(instance_fd_, nullptr, 0, event_list, max_events_, timeout);
-    if (count == -1 || count == 0) { 
+    struct timespec shortened;
+    int count = kevent(instance_fd_, nullptr, 0, event_list_.get(), max_events_,
+                       timer_timeout(timeout, shortened));
+    if (count == -1) { 
         return count; 
     }
     
-    events.reserve(count);
+    events.reserve(events.size() + count);
     for (int i = 0; i < count; i++) {
-        struct kevent &event = event_list[i]; 
+        struct kevent &event = event_list_[i]; 
         auto flags = flags_to_mplex(event.flags);
         auto filters = flags_to_mplex(event.filter);
-        events.push_back({flags, filters, static_cast<int>(event.ident)});
+        events.push_back({flags, filters, static_cast<int>(event.ident), event.udata});
     }
-    return count;
+    return count + report_timers(events);
+}
+
+// Wait for kevents without allocating
+//
+// @param[in]   timeout     timespec defining the timeout. nullptr implies wait indefinitely
+// @param[out]  events      caller owned array for the events found
+// @param[in]   max_events  size of events
+//
+// @return kevent status
+int KqueueMultiplexor::wait(struct timespec *timeout, io_mplex_event_t *events, unsigned max_events)
+{
+    if (max_events > max_events_) {
+        max_events = max_events_;
+    }
+    struct timespec shortened;
+    int count = kevent(instance_fd_, nullptr, 0, event_list_.get(), max_events,
+                       timer_timeout(timeout, shortened));
+    for (int i = 0; i < count; i++) {
+        struct kevent &event = event_list_[i];
+        events[i].filters = flags_to_mplex(event.filter) | flags_to_mplex(event.flags);
+        events[i].fd = static_cast<int>(event.ident);
+        events[i].data = event.udata;
+        events[i].result = 0;
+        events[i].buffer = nullptr;
+    }
+    return report_timers(events, count, max_events);
 }
 
 // Add the given file descriptor with provided flags and filters
@@ -80,7 +107,7 @@ int KqueueMultiplexor::add(const io_mplex_fd_info_t &fd_info)
     int filters = flags_from_mplex(fd_info.filters);
     
     struct kevent event;
-    EV_SET(&event, fd_info.fd, filters, flags | EV_ADD, 0, 0, nullptr);
+    EV_SET(&event, fd_info.fd, filters, flags | EV_ADD, 0, 0, fd_info.data);
     
     int rc =  kevent(instance_fd_, &event, 1, nullptr, 0, nullptr);
     if (rc) {
@@ -110,7 +137,7 @@ int KqueueMultiplexor::add(const std::vector<io_mplex_fd_info_t> &fd_list)
     for (auto &fd_info : fd_list) {
         flags = flags_from_mplex(fd_info.flags);
         filters = flags_from_mplex(fd_info.filters);
-        EV_SET(&change_list[index], fd_info.fd, filters, flags | EV_ADD, 0, 0, nullptr);
+        EV_SET(&change_list[index], fd_info.fd, filters, flags | EV_ADD, 0, 0, fd_info.data);
         index++;
     }
 
@@ -137,6 +164,27 @@ int KqueueMultiplexor::add(std::vector<io_mplex_fd_info_t> &&fd_list)
     return add(fd_list);
 }
 
+// Change the flags and filters of a file descriptor already
+// in the kqueue, re-enabling it if it was a oneshot that fired
+//
+// @param[in]   fd_info     structure defining file descriptor, flags, and filters
+//
+// @return kevent modification success or failure
+int KqueueMultiplexor::modify(const io_mplex_fd_info_t &fd_info)
+{
+    int flags = flags_from_mplex(fd_info.flags);
+    int filters = flags_from_mplex(fd_info.filters);
+
+    struct kevent event;
+    EV_SET(&event, fd_info.fd, filters, flags | EV_ADD | EV_ENABLE, 0, 0, fd_info.data);
+
+    int rc = kevent(instance_fd_, &event, 1, nullptr, 0, nullptr);
+    if (rc) {
+        log(LogPriority::ERROR, "Failed to modify event in kqueue\n");
+    }
+    return rc;
+}
+
 // Remove the file descriptor from the kqueue.
 //
 // @param[in]   fd  file descriptor to remove 
@@ -219,6 +267,11 @@ int KqueueMultiplexor::flags_from_mplex(io_mplex_flags_t mplex_values)
     if (mplex_values & MPLEX_EOF) {
         flags |= EV_EOF;
     }
+    if (mplex_values & MPLEX_EDGE) {
+        flags |= EV_CLEAR;
+    }
+    // each kqueue is woken on its own so MPLEX_EXCLUSIVE needs
+    // nothing extra
     return flags;
 }
 
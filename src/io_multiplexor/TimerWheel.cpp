@@ -0,0 +1,243 @@
+// TimerWheel.cpp
+//
+// Implementation of the hierarchical timer wheel.
+//
+// 17 October 2026
+
+#include <io_multiplexor/TimerWheel.hpp>
+
+constexpr uint64_t TIMER_WHEEL_MASK = TIMER_WHEEL_SLOTS - 1;
+constexpr uint64_t NO_TIMER = UINT64_MAX;
+
+static void list_init(mplex_timer_t &head)
+{
+    head.prev = &head;
+    head.next = &head;
+}
+
+static bool list_empty(const mplex_timer_t &head)
+{
+    return head.next == &head;
+}
+
+static void list_push(mplex_timer_t &head, mplex_timer_t &timer)
+{
+    timer.prev = head.prev;
+    timer.next = &head;
+    head.prev->next = &timer;
+    head.prev = &timer;
+}
+
+static void list_unlink(mplex_timer_t &timer)
+{
+    timer.prev->next = timer.next;
+    timer.next->prev = timer.prev;
+    timer.prev = nullptr;
+    timer.next = nullptr;
+}
+
+// move every timer in from to the end of to
+static void list_splice(mplex_timer_t &from, mplex_timer_t &to)
+{
+    if (list_empty(from)) {
+        return;
+    }
+    from.next->prev = to.prev;
+    to.prev->next = from.next;
+    from.prev->next = &to;
+    to.prev = from.prev;
+    list_init(from);
+}
+
+////
+// @brief create an empty wheel
+//
+// @param[in]   now     current time in ticks
+TimerWheel::TimerWheel(uint64_t now):
+    now_(now),
+    size_(0)
+{
+    for (auto &level : slots_) {
+        for (auto &slot : level) {
+            list_init(slot);
+        }
+    }
+    list_init(expired_);
+}
+
+////
+// @brief detach any timers that are still scheduled so that
+//        their owners see them as inactive
+TimerWheel::~TimerWheel()
+{
+    while (pop_expired() != nullptr) {
+    }
+    for (auto &level : slots_) {
+        for (auto &slot : level) {
+            while (!list_empty(slot)) {
+                list_unlink(*slot.next);
+            }
+        }
+    }
+}
+
+////
+// @brief start a timer, restarting it if it is already scheduled
+//
+// @param[in]   timer   timer to start
+// @param[in]   ticks   ticks from now until it expires, 0 expires it
+//                      on the next advance. Clamped to TIMER_WHEEL_MAX_TICKS
+void TimerWheel::schedule(mplex_timer_t &timer, uint64_t ticks)
+{
+    if (timer.is_active()) {
+        list_unlink(timer);
+    } else {
+        size_++;
+    }
+    if (ticks == 0) {
+        timer.expires = now_;
+        list_push(expired_, timer);
+        return;
+    }
+    if (ticks > TIMER_WHEEL_MAX_TICKS) {
+        ticks = TIMER_WHEEL_MAX_TICKS;
+    }
+    timer.expires = now_ + ticks;
+    insert(timer);
+}
+
+////
+// @brief stop a timer, whether or not it has expired
+//
+// @param[in]   timer   timer to stop, nothing happens if it is not active
+void TimerWheel::cancel(mplex_timer_t &timer)
+{
+    if (!timer.is_active()) {
+        return;
+    }
+    list_unlink(timer);
+    size_--;
+}
+
+////
+// @brief move the wheel forward, expiring timers that are due
+//
+// @param[in]   now     current time in ticks
+//
+// @note stretches of time without any timers are skipped over
+//       rather than walked one tick at a time
+void TimerWheel::advance(uint64_t now)
+{
+    while (now_ < now) {
+        uint64_t ticks = ticks_to_next();
+        if (ticks == NO_TIMER || ticks > now - now_) {
+            now_ = now;
+            break;
+        }
+        now_ += ticks - 1;
+        step();
+    }
+}
+
+////
+// @brief take the next expired timer
+//
+// @return the timer, no longer active
+//         nullptr if no timers have expired
+mplex_timer_t *TimerWheel::pop_expired()
+{
+    if (list_empty(expired_)) {
+        return nullptr;
+    }
+    mplex_timer_t *timer = expired_.next;
+    list_unlink(*timer);
+    size_--;
+    return timer;
+}
+
+////
+// @brief ticks until the wheel next needs to advance
+//
+// @return 0 if timers have expired and not been popped
+//        -1 if there are no timers
+//
+// @note a timer in an upper level is only known to expire after the
+//       slot holding it is cascaded, so this may be earlier than the
+//       first timer actually expires
+int64_t TimerWheel::next_timeout() const
+{
+    if (!list_empty(expired_)) {
+        return 0;
+    }
+    if (size_ == 0) {
+        return -1;
+    }
+    uint64_t ticks = ticks_to_next();
+    return ticks == NO_TIMER ? -1 : static_cast<int64_t>(ticks);
+}
+
+void TimerWheel::insert(mplex_timer_t &timer)
+{
+    uint64_t ticks = timer.expires - now_;
+    unsigned level = 0;
+    while (level < TIMER_WHEEL_LEVELS - 1 && ticks >> (TIMER_WHEEL_BITS * (level + 1)) != 0) {
+        level++;
+    }
+    uint64_t slot = (timer.expires >> (TIMER_WHEEL_BITS * level)) & TIMER_WHEEL_MASK;
+    list_push(slots_[level][slot], timer);
+}
+
+////
+// @brief redistribute the current slot of a level to the levels below
+//
+// @param[in]   level   level to cascade, greater than 0
+void TimerWheel::cascade(unsigned level)
+{
+    uint64_t slot = (now_ >> (TIMER_WHEEL_BITS * level)) & TIMER_WHEEL_MASK;
+    mplex_timer_t pending;
+    list_init(pending);
+    list_splice(slots_[level][slot], pending);
+    while (!list_empty(pending)) {
+        mplex_timer_t &timer = *pending.next;
+        list_unlink(timer);
+        insert(timer);
+    }
+}
+
+////
+// @brief advance a single tick
+void TimerWheel::step()
+{
+    now_++;
+    // each time a level wraps the next level up is cascaded into it
+    for (unsigned level = 1; level < TIMER_WHEEL_LEVELS; level++) {
+        if (((now_ >> (TIMER_WHEEL_BITS * (level - 1))) & TIMER_WHEEL_MASK) != 0) {
+            break;
+        }
+        cascade(level);
+    }
+    list_splice(slots_[0][now_ & TIMER_WHEEL_MASK], expired_);
+}
+
+////
+// @brief ticks until the next slot that holds timers is reached
+//
+// @return NO_TIMER if every slot is empty
+uint64_t TimerWheel::ticks_to_next() const
+{
+    uint64_t next = NO_TIMER;
+    for (unsigned level = 0; level < TIMER_WHEEL_LEVELS; level++) {
+        unsigned shift = TIMER_WHEEL_BITS * level;
+        uint64_t base = now_ >> shift;
+        for (uint64_t i = 1; i <= TIMER_WHEEL_SLOTS; i++) {
+            if (!list_empty(slots_[level][(base + i) & TIMER_WHEEL_MASK])) {
+                uint64_t ticks = ((base + i) << shift) - now_;
+                if (ticks < next) {
+                    next = ticks;
+                }
+                break;
+            }
+        }
+    }
+    return next;
+}
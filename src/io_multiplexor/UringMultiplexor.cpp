@@ -0,0 +1,781 @@
+// UringMultiplexor.cpp
+//
+// Implementation of UringMultiplexor class
+// Handles IO multiplexing and completions using
+// io_uring on Linux based systems.
+//
+// 17 October 2026
+
+#include <common/log_util.hpp>
+#include <io_multiplexor/UringMultiplexor.hpp>
+
+#include <cerrno>
+#include <cstring>
+#include <exception>
+#include <stdexcept>
+
+#include <linux/io_uring.h>
+#include <linux/time_types.h>
+#include <poll.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+// user_data of requests whose completions are ignored
+constexpr uint64_t URING_IGNORE = UINT64_MAX;
+constexpr uint16_t URING_BUFFER_GROUP = 0;
+
+// opcode slots asked for when probing the kernel
+constexpr unsigned URING_PROBE_OPS = 256;
+
+static int uring_setup(unsigned entries, struct io_uring_params *params)
+{
+    return syscall(__NR_io_uring_setup, entries, params);
+}
+
+static int uring_enter(int fd, unsigned to_submit, unsigned min_complete, unsigned flags,
+                       const void *arg, size_t arg_size)
+{
+    return syscall(__NR_io_uring_enter, fd, to_submit, min_complete, flags, arg, arg_size);
+}
+
+static int uring_register(int fd, unsigned opcode, const void *arg, unsigned n_args)
+{
+    return syscall(__NR_io_uring_register, fd, opcode, arg, n_args);
+}
+
+////
+// @brief true if the kernel supports opcode
+static bool uring_supports(int fd, unsigned opcode)
+{
+    size_t size = sizeof(struct io_uring_probe) + URING_PROBE_OPS * sizeof(struct io_uring_probe_op);
+    std::unique_ptr<char []> storage(new char[size]());
+    auto probe = reinterpret_cast<struct io_uring_probe *>(storage.get());
+    if (uring_register(fd, IORING_REGISTER_PROBE, probe, URING_PROBE_OPS) == -1) {
+        return false;
+    }
+    return opcode <= probe->last_op && (probe->ops[opcode].flags & IO_URING_OP_SUPPORTED);
+}
+
+////
+// @brief set up an io_uring instance and its provided buffers
+//
+// @param[in]   max_events  most events returned by a single wait
+//
+// @throws std::runtime_error if io_uring is unavailable or too old
+UringMultiplexor::UringMultiplexor(unsigned max_events):
+    IoMultiplexor(max_events),
+    sq_ring_(MAP_FAILED),
+    sq_ring_size_(0),
+    cq_ring_(MAP_FAILED),
+    sqes_(static_cast<struct io_uring_sqe *>(MAP_FAILED)),
+    sqes_size_(0),
+    sq_head_(nullptr),
+    sq_tail_(nullptr),
+    sq_mask_(0),
+    sq_array_(nullptr),
+    sq_entries_(0),
+    cq_head_(nullptr),
+    cq_tail_(nullptr),
+    cq_mask_(0),
+    cqes_(nullptr),
+    event_list_(new io_mplex_event_t[max_events])
+{
+    struct io_uring_params params;
+    memset(&params, 0, sizeof(params));
+    params.flags = IORING_SETUP_CQSIZE;
+    params.cq_entries = URING_SQ_ENTRIES * URING_CQ_FACTOR;
+
+    instance_fd_ = uring_setup(URING_SQ_ENTRIES, &params);
+    if (instance_fd_ == -1) {
+        throw std::runtime_error("Unable to create io_uring");
+    }
+    // timed waits, one mmap for both rings and multishot recv, which
+    // arrived with zero copy send
+    if (!(params.features & IORING_FEAT_EXT_ARG) || !(params.features & IORING_FEAT_SINGLE_MMAP) ||
+        !uring_supports(instance_fd_, IORING_OP_SEND_ZC)) {
+        teardown();
+        throw std::runtime_error("io_uring is too old");
+    }
+
+    // both rings share one mapping
+    sq_ring_size_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    size_t cq_ring_size = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+    if (cq_ring_size > sq_ring_size_) {
+        sq_ring_size_ = cq_ring_size;
+    }
+    sq_ring_ = mmap(nullptr, sq_ring_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                    instance_fd_, IORING_OFF_SQ_RING);
+    sqes_size_ = params.sq_entries * sizeof(struct io_uring_sqe);
+    sqes_ = static_cast<struct io_uring_sqe *>(mmap(nullptr, sqes_size_, PROT_READ | PROT_WRITE,
+                                                    MAP_SHARED | MAP_POPULATE, instance_fd_,
+                                                    IORING_OFF_SQES));
+    if (sq_ring_ == MAP_FAILED || sqes_ == MAP_FAILED) {
+        teardown();
+        throw std::runtime_error("Unable to map io_uring");
+    }
+    cq_ring_ = sq_ring_;
+
+    char *sq = static_cast<char *>(sq_ring_);
+    sq_head_ = reinterpret_cast<unsigned *>(sq + params.sq_off.head);
+    sq_tail_ = reinterpret_cast<unsigned *>(sq + params.sq_off.tail);
+    sq_mask_ = *reinterpret_cast<unsigned *>(sq + params.sq_off.ring_mask);
+    sq_array_ = reinterpret_cast<unsigned *>(sq + params.sq_off.array);
+    sq_entries_ = params.sq_entries;
+
+    char *cq = static_cast<char *>(cq_ring_);
+    cq_head_ = reinterpret_cast<unsigned *>(cq + params.cq_off.head);
+    cq_tail_ = reinterpret_cast<unsigned *>(cq + params.cq_off.tail);
+    cq_mask_ = *reinterpret_cast<unsigned *>(cq + params.cq_off.ring_mask);
+    cqes_ = reinterpret_cast<struct io_uring_cqe *>(cq + params.cq_off.cqes);
+
+    if (setup_buffers()) {
+        teardown();
+        throw std::runtime_error("Unable to register io_uring buffers");
+    }
+}
+
+UringMultiplexor::~UringMultiplexor()
+{
+    teardown();
+}
+
+////
+// @brief close the ring and unmap everything shared with the kernel
+//
+// @note closing the ring cancels whatever is still in flight
+void UringMultiplexor::teardown()
+{
+    if (instance_fd_ != -1 && close(instance_fd_) == -1) {
+        log(LogPriority::ERROR, "Failed to close io_uring\n");
+    }
+    instance_fd_ = -1;
+    if (sqes_ != MAP_FAILED) {
+        munmap(sqes_, sqes_size_);
+        sqes_ = static_cast<struct io_uring_sqe *>(MAP_FAILED);
+    }
+    if (sq_ring_ != MAP_FAILED) {
+        munmap(sq_ring_, sq_ring_size_);
+        sq_ring_ = MAP_FAILED;
+    }
+}
+
+////
+// @brief hand every buffer to the kernel for multishot recv to fill
+//
+// @return  0 on success
+//         -1 on error
+int UringMultiplexor::setup_buffers()
+{
+    buffers_.reset(new char[URING_BUFFER_COUNT * URING_BUFFER_SIZE]);
+    struct io_uring_sqe *sqe = get_sqe();
+    if (sqe == nullptr) {
+        return -1;
+    }
+    sqe->opcode = IORING_OP_PROVIDE_BUFFERS;
+    sqe->fd = URING_BUFFER_COUNT;
+    sqe->addr = reinterpret_cast<uint64_t>(buffers_.get());
+    sqe->len = URING_BUFFER_SIZE;
+    sqe->buf_group = URING_BUFFER_GROUP;
+    sqe->user_data = URING_IGNORE;
+    if (submit(1, nullptr) == -1) {
+        return -1;
+    }
+
+    // nothing else is in flight yet, so this is its completion
+    unsigned head = *cq_head_;
+    if (head == __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE)) {
+        return -1;
+    }
+    int rc = cqes_[head & cq_mask_].res;
+    __atomic_store_n(cq_head_, head + 1, __ATOMIC_RELEASE);
+    return rc < 0 ? -1 : 0;
+}
+
+////
+// @brief hand a buffer back to the kernel
+//
+// @param[in]   buffer_id   buffer to hand back
+//
+// @note the buffer is queued like any other request, so the buffers
+//       released while handling a batch of events go back together
+void UringMultiplexor::recycle_buffer(unsigned buffer_id)
+{
+    struct io_uring_sqe *sqe = get_sqe();
+    if (sqe == nullptr) {
+        log(LogPriority::ERROR, "Unable to return buffer %u to io_uring\n", buffer_id);
+        return;
+    }
+    sqe->opcode = IORING_OP_PROVIDE_BUFFERS;
+    sqe->fd = 1;
+    sqe->addr = reinterpret_cast<uint64_t>(buffers_.get() + buffer_id * URING_BUFFER_SIZE);
+    sqe->len = URING_BUFFER_SIZE;
+    sqe->buf_group = URING_BUFFER_GROUP;
+    sqe->off = buffer_id;
+    sqe->user_data = URING_IGNORE;
+}
+
+////
+// @brief hand the buffer of an MPLEX_RECV event back once it is consumed
+//
+// @param[in]   event   event returned by wait
+void UringMultiplexor::release_buffer(const io_mplex_event_t &event)
+{
+    if (event.buffer == nullptr) {
+        return;
+    }
+    recycle_buffer((event.buffer - buffers_.get()) / URING_BUFFER_SIZE);
+}
+
+UringMultiplexor::fd_state_t &UringMultiplexor::fd_state(int fd)
+{
+    if (static_cast<size_t>(fd) >= fds_.size()) {
+        fds_.resize(fd + 1, {0, -1});
+    }
+    return fds_[fd];
+}
+
+int UringMultiplexor::new_op(OpType type, int fd, void *data)
+{
+    int index = 0;
+    if (free_ops_.empty()) {
+        index = ops_.size();
+        ops_.emplace_back();
+    } else {
+        index = free_ops_.back();
+        free_ops_.pop_back();
+    }
+    op_t &op = ops_[index];
+    op.type = type;
+    op.armed = false;
+    op.orphaned = false;
+    op.fd = fd;
+    op.generation = fd_state(fd).generation;
+    op.flags = 0;
+    op.filters = 0;
+    op.data = data;
+    return index;
+}
+
+void UringMultiplexor::free_op(int index)
+{
+    free_ops_.push_back(index);
+}
+
+////
+// @brief queue a submission, it reaches the kernel with the next wait
+//
+// @return zeroed submission
+//         nullptr if the queue is full
+//
+// @note nothing polls the submission queue, so the kernel only reads
+//       it during io_uring_enter and the tail can be published first
+struct io_uring_sqe *UringMultiplexor::get_sqe()
+{
+    unsigned tail = *sq_tail_;
+    if (tail - __atomic_load_n(sq_head_, __ATOMIC_ACQUIRE) >= sq_entries_) {
+        // full -- hand what is queued to the kernel to make room
+        if (submit(0, nullptr) == -1 ||
+            tail - __atomic_load_n(sq_head_, __ATOMIC_ACQUIRE) >= sq_entries_) {
+            log(LogPriority::ERROR, "io_uring submission queue is full\n");
+            errno = EBUSY;
+            return nullptr;
+        }
+    }
+    unsigned index = tail & sq_mask_;
+    struct io_uring_sqe *sqe = &sqes_[index];
+    memset(sqe, 0, sizeof(*sqe));
+    sq_array_[index] = index;
+    __atomic_store_n(sq_tail_, tail + 1, __ATOMIC_RELEASE);
+    return sqe;
+}
+
+////
+// @brief submit everything queued and optionally wait for completions
+//
+// @param[in]   min_complete    completions to wait for, 0 to only submit
+// @param[in]   timeout         longest wait, nullptr waits indefinitely
+//
+// @return  0 on success or timeout
+//         -1 on error
+int UringMultiplexor::submit(unsigned min_complete, struct timespec *timeout)
+{
+    unsigned to_submit = *sq_tail_ - __atomic_load_n(sq_head_, __ATOMIC_ACQUIRE);
+    if (to_submit == 0 && min_complete == 0) {
+        return 0;
+    }
+
+    unsigned flags = min_complete > 0 ? IORING_ENTER_GETEVENTS : 0;
+    struct __kernel_timespec ts;
+    struct io_uring_getevents_arg arg;
+    const void *arg_ptr = nullptr;
+    size_t arg_size = 0;
+    if (min_complete > 0 && timeout != nullptr) {
+        ts.tv_sec = timeout->tv_sec;
+        ts.tv_nsec = timeout->tv_nsec;
+        memset(&arg, 0, sizeof(arg));
+        arg.sigmask_sz = _NSIG / 8;
+        arg.ts = reinterpret_cast<uint64_t>(&ts);
+        flags |= IORING_ENTER_EXT_ARG;
+        arg_ptr = &arg;
+        arg_size = sizeof(arg);
+    }
+
+    int rc = uring_enter(instance_fd_, to_submit, min_complete, flags, arg_ptr, arg_size);
+    if (rc == -1) {
+        // a wait that timed out has still submitted everything
+        if (errno == ETIME) {
+            return 0;
+        }
+        // completions have to be reaped before more can be posted
+        if (errno == EBUSY || errno == EAGAIN) {
+            return 0;
+        }
+        return -1;
+    }
+    return 0;
+}
+
+////
+// @brief queue a poll for the readiness an op was added with
+//
+// @param[in]   index   poll op to arm
+//
+// @return  0 on success
+//         -1 on error
+//
+// @note an op with neither MPLEX_IN nor MPLEX_OUT stays disarmed
+int UringMultiplexor::arm_poll(int index)
+{
+    op_t &op = ops_[index];
+    if (!((op.flags | op.filters) & (MPLEX_IN | MPLEX_OUT))) {
+        return 0;
+    }
+    struct io_uring_sqe *sqe = get_sqe();
+    if (sqe == nullptr) {
+        return -1;
+    }
+    sqe->opcode = IORING_OP_POLL_ADD;
+    sqe->fd = op.fd;
+    sqe->poll32_events = flags_from_mplex(op.flags | op.filters);
+    if (op.flags & MPLEX_EDGE) {
+        sqe->len = IORING_POLL_ADD_MULTI;
+    }
+    sqe->user_data = index;
+    op.armed = true;
+    return 0;
+}
+
+////
+// @brief cancel requests, their completions are ignored
+//
+// @param[in]   fd      cancel every request on fd, if index is -1
+// @param[in]   index   op to cancel
+void UringMultiplexor::cancel(int fd, int index)
+{
+    struct io_uring_sqe *sqe = get_sqe();
+    if (sqe == nullptr) {
+        return;
+    }
+    sqe->opcode = IORING_OP_ASYNC_CANCEL;
+    sqe->user_data = URING_IGNORE;
+    if (index != -1) {
+        sqe->addr = index;
+    } else {
+        sqe->fd = fd;
+        sqe->cancel_flags = IORING_ASYNC_CANCEL_FD | IORING_ASYNC_CANCEL_ALL;
+    }
+}
+
+int UringMultiplexor::wait(struct timespec *timeout, std::vector<io_mplex_fd_info_t> &events)
+{
+    int n_events = wait(timeout, event_list_.get(), max_events_);
+    if (n_events == -1) {
+        return n_events;
+    }
+    events.reserve(events.size() + n_events);
+    for (int i = 0; i < n_events; i++) {
+        auto &event = event_list_[i];
+        // there is nowhere to put the bytes received
+        release_buffer(event);
+        events.push_back({event.filters, event.filters, event.fd, event.data});
+    }
+    return n_events;
+}
+
+////
+// @brief submit queued requests and wait for completions
+//
+// @param[in]   timeout     nullptr waits indefinitely
+// @param[out]  events      caller owned array for the events
+// @param[in]   max_events  size of events
+//
+// @return number of events
+//         -1 on error
+int UringMultiplexor::wait(struct timespec *timeout, io_mplex_event_t *events, unsigned max_events)
+{
+    if (max_events > max_events_) {
+        max_events = max_events_;
+    }
+    struct timespec shortened;
+    timeout = timer_timeout(timeout, shortened);
+
+    bool ready = __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE) != *cq_head_;
+    bool no_wait = ready || (timeout != nullptr && timeout->tv_sec == 0 && timeout->tv_nsec == 0);
+    if (submit(no_wait ? 0 : 1, timeout) == -1) {
+        return -1;
+    }
+    return report_timers(events, reap(events, max_events), max_events);
+}
+
+////
+// @brief turn completions into events
+//
+// @return number of events
+int UringMultiplexor::reap(io_mplex_event_t *events, unsigned max_events)
+{
+    unsigned head = *cq_head_;
+    unsigned tail = __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE);
+    unsigned n_events = 0;
+    while (head != tail && n_events < max_events) {
+        const struct io_uring_cqe &cqe = cqes_[head & cq_mask_];
+        head++;
+        if (complete(cqe, events[n_events])) {
+            n_events++;
+        }
+    }
+    __atomic_store_n(cq_head_, head, __ATOMIC_RELEASE);
+    return n_events;
+}
+
+////
+// @brief turn a completion into an event
+//
+// @param[in]   cqe     completion
+// @param[out]  event   event to fill
+//
+// @return true if event was filled
+//         false if the completion is not reported
+bool UringMultiplexor::complete(const struct io_uring_cqe &cqe, io_mplex_event_t &event)
+{
+    if (cqe.user_data == URING_IGNORE) {
+        return false;
+    }
+    int index = static_cast<int>(cqe.user_data);
+    op_t &op = ops_[index];
+    bool more = cqe.flags & IORING_CQE_F_MORE;
+    bool stale = op.orphaned || op.generation != fd_state(op.fd).generation;
+
+    char *buffer = nullptr;
+    if (cqe.flags & IORING_CQE_F_BUFFER) {
+        unsigned buffer_id = cqe.flags >> IORING_CQE_BUFFER_SHIFT;
+        if (stale) {
+            recycle_buffer(buffer_id);
+        } else {
+            buffer = buffers_.get() + buffer_id * URING_BUFFER_SIZE;
+        }
+    }
+    if (!more) {
+        op.armed = false;
+    }
+    if (stale) {
+        // removed or replaced, the op is done once the kernel is
+        if (!more) {
+            free_op(index);
+        }
+        return false;
+    }
+
+    event.fd = op.fd;
+    event.data = op.data;
+    event.result = cqe.res;
+    event.buffer = buffer;
+    switch (op.type) {
+        case OpType::POLL:
+            // added ops keep their slot, level triggered ones are
+            // re-armed and report again if they are still ready
+            event.filters = cqe.res < 0 ? MPLEX_ERR : flags_to_mplex(cqe.res);
+            event.result = 0;
+            if (!more && cqe.res >= 0 && !(op.flags & MPLEX_ONESHOT)) {
+                arm_poll(index);
+            }
+            return true;
+        case OpType::ACCEPT:
+            event.filters = MPLEX_ACCEPT;
+            break;
+        case OpType::RECV:
+            event.filters = MPLEX_RECV;
+            break;
+        case OpType::SEND:
+            event.filters = MPLEX_SEND;
+            break;
+    }
+    if (more) {
+        event.filters |= MPLEX_MORE;
+    } else {
+        free_op(index);
+    }
+    return true;
+}
+
+////
+// @brief wait for readiness on an fd
+//
+// @param[in]   fd_info     fd, flags, filters and data
+//
+// @return  0 on success
+//         -1 on error
+int UringMultiplexor::add(const io_mplex_fd_info_t &fd_info)
+{
+    if (fd_info.fd < 0) {
+        errno = EBADF;
+        return -1;
+    }
+    if (fd_state(fd_info.fd).poll_op != -1) {
+        log(LogPriority::ERROR, "Unable to add to io_uring -- fd %d already added\n", fd_info.fd);
+        errno = EEXIST;
+        return -1;
+    }
+    int index = new_op(OpType::POLL, fd_info.fd, fd_info.data);
+    ops_[index].flags = fd_info.flags;
+    ops_[index].filters = fd_info.filters;
+    if (arm_poll(index)) {
+        log(LogPriority::ERROR, "Unable to add to io_uring\n");
+        free_op(index);
+        return -1;
+    }
+    fd_state(fd_info.fd).poll_op = index;
+    n_events_++;
+    return 0;
+}
+
+int UringMultiplexor::add(const std::vector<io_mplex_fd_info_t> &fd_list)
+{
+    int rc = 0;
+    int final_rc = 0;
+    for (auto &fd_info : fd_list) {
+        rc = add(fd_info);
+        if (rc) {
+            final_rc = rc;
+        }
+    }
+    return final_rc;
+}
+
+int UringMultiplexor::add(std::vector<io_mplex_fd_info_t> &&fd_list)
+{
+    return add(fd_list);
+}
+
+////
+// @brief change the readiness waited for, re-arming a oneshot
+//
+// @param[in]   fd_info     fd, flags, filters and data
+//
+// @return  0 on success
+//         -1 on error
+int UringMultiplexor::modify(const io_mplex_fd_info_t &fd_info)
+{
+    if (fd_info.fd < 0 || static_cast<size_t>(fd_info.fd) >= fds_.size() ||
+        fds_[fd_info.fd].poll_op == -1) {
+        errno = ENOENT;
+        return -1;
+    }
+    int index = fds_[fd_info.fd].poll_op;
+    if (ops_[index].armed) {
+        // replace the request in flight, anything it completes with is dropped
+        ops_[index].orphaned = true;
+        cancel(fd_info.fd, index);
+        index = new_op(OpType::POLL, fd_info.fd, fd_info.data);
+        fds_[fd_info.fd].poll_op = index;
+    }
+    op_t &op = ops_[index];
+    op.flags = fd_info.flags;
+    op.filters = fd_info.filters;
+    op.data = fd_info.data;
+    return arm_poll(index);
+}
+
+////
+// @brief stop waiting on an fd and cancel every operation on it
+//
+// @param[in]   fd  file descriptor to remove
+//
+// @return  0 on success
+//         -1 on error
+//
+// @note the cancellation is submitted straight away, while fd still
+//       refers to the same file, so fd can be closed as soon as this
+//       returns. Completions already posted for fd are dropped.
+int UringMultiplexor::remove(const int fd)
+{
+    if (fd < 0) {
+        errno = EBADF;
+        return -1;
+    }
+    fd_state_t &state = fd_state(fd);
+    state.generation++;
+    if (state.poll_op != -1) {
+        if (!ops_[state.poll_op].armed) {
+            free_op(state.poll_op);
+        }
+        state.poll_op = -1;
+        n_events_--;
+    }
+    cancel(fd, -1);
+    return submit(0, nullptr);
+}
+
+int UringMultiplexor::remove(const std::vector<int> &fd_list)
+{
+    int rc = 0;
+    int final_rc = 0;
+    for (int fd : fd_list) {
+        rc = remove(fd);
+        if (rc) {
+            final_rc = rc;
+        }
+    }
+    return final_rc;
+}
+
+int UringMultiplexor::remove(std::vector<int> &&fd_list)
+{
+    return remove(fd_list);
+}
+
+////
+// @brief accept connections until the request is cancelled or fails
+//
+// @param[in]   listen_fd   listening socket
+// @param[in]   data        reported with each MPLEX_ACCEPT event
+//
+// @return  0 on success
+//         -1 on error
+//
+// @note accepted sockets are non-blocking and close on exec
+int UringMultiplexor::accept_multishot(int listen_fd, void *data)
+{
+    int index = new_op(OpType::ACCEPT, listen_fd, data);
+    struct io_uring_sqe *sqe = get_sqe();
+    if (sqe == nullptr) {
+        free_op(index);
+        return -1;
+    }
+    sqe->opcode = IORING_OP_ACCEPT;
+    sqe->fd = listen_fd;
+    sqe->ioprio = IORING_ACCEPT_MULTISHOT;
+    sqe->accept_flags = SOCK_NONBLOCK | SOCK_CLOEXEC;
+    sqe->user_data = index;
+    ops_[index].armed = true;
+    return 0;
+}
+
+////
+// @brief receive into provided buffers until the request ends
+//
+// @param[in]   fd      socket to receive from
+// @param[in]   data    reported with each MPLEX_RECV event
+//
+// @return  0 on success
+//         -1 on error
+//
+// @note an event without MPLEX_MORE ends the request, with -ENOBUFS if
+//       the buffers ran out. Every buffer reported has to be released.
+int UringMultiplexor::recv_multishot(int fd, void *data)
+{
+    int index = new_op(OpType::RECV, fd, data);
+    struct io_uring_sqe *sqe = get_sqe();
+    if (sqe == nullptr) {
+        free_op(index);
+        return -1;
+    }
+    sqe->opcode = IORING_OP_RECV;
+    sqe->fd = fd;
+    sqe->ioprio = IORING_RECV_MULTISHOT;
+    sqe->flags = IOSQE_BUFFER_SELECT;
+    sqe->buf_group = URING_BUFFER_GROUP;
+    sqe->user_data = index;
+    ops_[index].armed = true;
+    return 0;
+}
+
+////
+// @brief queue a send, submitted with every other queued request
+//        by the next wait
+//
+// @param[in]   fd      socket or pipe to send on
+// @param[in]   iov     data to send, copied so only the bytes have to
+//                      stay valid until the MPLEX_SEND event
+// @param[in]   iovcnt  number of iovecs, at most URING_SEND_MAX_IOV are sent
+// @param[in]   data    reported with the MPLEX_SEND event
+//
+// @return  0 on success
+//         -1 on error
+//
+// @note like writev, writing to a closed peer raises SIGPIPE unless
+//       it is ignored
+int UringMultiplexor::send(int fd, const struct iovec *iov, int iovcnt, void *data)
+{
+    if (iovcnt <= 0) {
+        errno = EINVAL;
+        return -1;
+    }
+    if (iovcnt > URING_SEND_MAX_IOV) {
+        iovcnt = URING_SEND_MAX_IOV;
+    }
+    int index = new_op(OpType::SEND, fd, data);
+    struct io_uring_sqe *sqe = get_sqe();
+    if (sqe == nullptr) {
+        free_op(index);
+        return -1;
+    }
+    op_t &op = ops_[index];
+    memcpy(op.iov, iov, iovcnt * sizeof(*iov));
+
+    // a vectored write so that pipes can be written as well as sockets
+    sqe->opcode = IORING_OP_WRITEV;
+    sqe->fd = fd;
+    sqe->addr = reinterpret_cast<uint64_t>(op.iov);
+    sqe->len = iovcnt;
+    sqe->off = static_cast<uint64_t>(-1);
+    sqe->user_data = index;
+    op.armed = true;
+    return 0;
+}
+
+int UringMultiplexor::flags_from_mplex(io_mplex_flags_t mplex_values)
+{
+    int flags = 0;
+    if (mplex_values & MPLEX_IN) {
+        flags |= POLLIN;
+    }
+    if (mplex_values & MPLEX_OUT) {
+        flags |= POLLOUT;
+    }
+    if (mplex_values & MPLEX_EOF) {
+        flags |= POLLRDHUP;
+    }
+    // poll always reports POLLHUP and POLLERR
+    return flags;
+}
+
+io_mplex_flags_t UringMultiplexor::flags_to_mplex(int poll_values)
+{
+    io_mplex_flags_t flags = 0;
+    if (poll_values & POLLIN) {
+        flags |= MPLEX_IN;
+    }
+    if (poll_values & POLLOUT) {
+        flags |= MPLEX_OUT;
+    }
+    if (poll_values & (POLLHUP | POLLRDHUP)) {
+        flags |= MPLEX_EOF;
+    }
+    if (poll_values & POLLERR) {
+        flags |= MPLEX_ERR;
+    }
+    return flags;
+}
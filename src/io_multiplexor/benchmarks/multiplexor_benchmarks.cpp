@@ -0,0 +1,66 @@
+// Benchmarks for IoMultiplexor wait
+//
+// Many pipes are registered but only one is readable, as in
+// a server where most clients are quiet. epoll keeps a ready
+// list, so the cost of a wait should depend on the events it
+// reports and not on the number of registered descriptors.
+//
+// 17 October 2026
+
+#define CATCH_CONFIG_MAIN
+
+#include <common/utilities.hpp>
+#include <io_multiplexor/IoMultiplexorFactory.hpp>
+
+#include <catch2/catch_all.hpp>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
+const static unsigned BENCH_MAX_EVENTS = 64;
+
+// pipes registered with a multiplexor, closed when done
+struct bench_pipes_t {
+    std::vector<int> fds;
+
+    ~bench_pipes_t()
+    {
+        for (int fd : fds) {
+            close(fd);
+        }
+    }
+};
+
+TEST_CASE("multiplexor wait by registered descriptors", "[!benchmark][mplex-wait]") {
+    auto n_fds = GENERATE(1, 10, 100, 1000, 5000);
+    // every pipe needs two descriptors
+    raise_fd_limit();
+
+    auto io_mplex = IoMultiplexorFactory::get_multiplexor(BENCH_MAX_EVENTS);
+    REQUIRE(io_mplex != nullptr);
+    bench_pipes_t pipes;
+    for (int i = 0; i < n_fds; i++) {
+        int fds[2];
+        REQUIRE(pipe(fds) == 0);
+        pipes.fds.push_back(fds[0]);
+        pipes.fds.push_back(fds[1]);
+        REQUIRE(io_mplex->add({0, MPLEX_IN, fds[0]}) == 0);
+    }
+
+    io_mplex_event_t events[BENCH_MAX_EVENTS];
+    struct timespec no_wait{0, 0};
+    auto registered = std::to_string(n_fds) + " registered";
+
+    BENCHMARK("wait with none ready, " + registered) {
+        return io_mplex->wait(&no_wait, events, BENCH_MAX_EVENTS);
+    };
+
+    // level triggered, so the unread byte is reported by every wait
+    REQUIRE(write(pipes.fds[1], "x", 1) == 1);
+    BENCHMARK("wait with one ready, " + registered) {
+        return io_mplex->wait(&no_wait, events, BENCH_MAX_EVENTS);
+    };
+}
@@ -10,6 +10,7 @@
 #include <memory>
 #include <string>
 
+#include <sys/socket.h>
 #include <unistd.h>
 
 const unsigned test_mplex_size = 10;
@@ -108,3 +109,143 @@ TEST_CASE("multiplexor returns read", "[read_ready]") {
     REQUIRE(read(test_channel.get_read_end(), msg_buffer, sizeof(msg_buffer)) ==
                 static_cast<ssize_t>(message.size()));
 }
+
+TEST_CASE("multiplexor edge triggered read", "[edge_triggered]") {
+    Channel test_channel;
+    struct timespec no_wait{0, 0};
+    std::string message{"edge"};
+    REQUIRE(test_channel.write(message) == static_cast<ssize_t>(message.size()));
+
+    auto mplex = IoMultiplexorFactory::get_multiplexor(test_mplex_size);
+    std::vector<io_mplex_fd_info_t> events;
+
+    SECTION("level triggered reports again until drained") {
+        REQUIRE(mplex->add({0, MPLEX_IN, test_channel.get_read_end()}) == 0);
+        REQUIRE(mplex->wait(&no_wait, events) == 1);
+        events.clear();
+        REQUIRE(mplex->wait(&no_wait, events) == 1);
+    }
+
+    SECTION("edge triggered reports once per change") {
+        REQUIRE(mplex->add({MPLEX_EDGE, MPLEX_IN, test_channel.get_read_end()}) == 0);
+        REQUIRE(mplex->wait(&no_wait, events) == 1);
+        REQUIRE((events[0].filters & MPLEX_IN) != 0);
+        events.clear();
+        REQUIRE(mplex->wait(&no_wait, events) == 0);
+
+        // new data is a new edge
+        REQUIRE(test_channel.write(message) == static_cast<ssize_t>(message.size()));
+        REQUIRE(mplex->wait(&no_wait, events) == 1);
+    }
+}
+
+TEST_CASE("multiplexor reports a peer shutting down", "[peer_shutdown]") {
+    int fds[2];
+    REQUIRE(socketpair(AF_UNIX, SOCK_STREAM, 0, fds) == 0);
+    auto mplex = IoMultiplexorFactory::get_multiplexor(test_mplex_size);
+    REQUIRE(mplex->add({MPLEX_EDGE, MPLEX_IN | MPLEX_EOF, fds[0]}) == 0);
+
+    // the peer can still read but will not write again
+    REQUIRE(shutdown(fds[1], SHUT_WR) == 0);
+
+    std::vector<io_mplex_fd_info_t> events;
+    REQUIRE(mplex->wait(nullptr, events) == 1);
+    REQUIRE(events[0].fd == fds[0]);
+    REQUIRE((events[0].filters & MPLEX_EOF) != 0);
+
+    close(fds[0]);
+    close(fds[1]);
+}
+
+TEST_CASE("multiplexors share an fd exclusively", "[exclusive]") {
+    Channel test_channel;
+    auto first = IoMultiplexorFactory::get_multiplexor(test_mplex_size);
+    auto second = IoMultiplexorFactory::get_multiplexor(test_mplex_size);
+
+    REQUIRE(first->add({MPLEX_EXCLUSIVE, MPLEX_IN, test_channel.get_read_end()}) == 0);
+    REQUIRE(second->add({MPLEX_EXCLUSIVE, MPLEX_IN, test_channel.get_read_end()}) == 0);
+
+    std::string message{"one"};
+    REQUIRE(test_channel.write(message) == static_cast<ssize_t>(message.size()));
+
+    // at least one waiter is woken
+    struct timespec no_wait{0, 0};
+    std::vector<io_mplex_fd_info_t> events;
+    int woken = first->wait(&no_wait, events);
+    woken += second->wait(&no_wait, events);
+    REQUIRE(woken >= 1);
+}
+
+TEST_CASE("multiplexor modify re-arms a oneshot", "[modify_oneshot]") {
+    Channel test_channel;
+    struct timespec no_wait{0, 0};
+    auto mplex = IoMultiplexorFactory::get_multiplexor(test_mplex_size);
+    REQUIRE(mplex->add({MPLEX_ONESHOT, MPLEX_OUT, test_channel.get_write_end()}) == 0);
+
+    std::vector<io_mplex_fd_info_t> events;
+    REQUIRE(mplex->wait(&no_wait, events) == 1);
+    events.clear();
+
+    // still writable, but the oneshot has fired
+    REQUIRE(mplex->wait(&no_wait, events) == 0);
+
+    REQUIRE(mplex->modify({MPLEX_ONESHOT, MPLEX_OUT, test_channel.get_write_end()}) == 0);
+    REQUIRE(mplex->wait(&no_wait, events) == 1);
+    REQUIRE(events[0].fd == test_channel.get_write_end());
+}
+
+TEST_CASE("multiplexor modify changes filters", "[modify_filters]") {
+    int fds[2];
+    REQUIRE(socketpair(AF_UNIX, SOCK_STREAM, 0, fds) == 0);
+    struct timespec no_wait{0, 0};
+    auto mplex = IoMultiplexorFactory::get_multiplexor(test_mplex_size);
+    REQUIRE(mplex->add({0, MPLEX_IN, fds[0]}) == 0);
+
+    std::vector<io_mplex_fd_info_t> events;
+    REQUIRE(mplex->wait(&no_wait, events) == 0);
+
+    REQUIRE(mplex->modify({0, MPLEX_IN | MPLEX_OUT, fds[0]}) == 0);
+    REQUIRE(mplex->wait(&no_wait, events) == 1);
+    REQUIRE((events[0].filters & MPLEX_OUT) != 0);
+    events.clear();
+
+    REQUIRE(mplex->modify({0, MPLEX_IN, fds[0]}) == 0);
+    REQUIRE(mplex->wait(&no_wait, events) == 0);
+
+    close(fds[0]);
+    close(fds[1]);
+}
+
+TEST_CASE("multiplexor modify needs an added fd", "[modify_missing]") {
+    Channel test_channel;
+    auto mplex = IoMultiplexorFactory::get_multiplexor(test_mplex_size);
+    REQUIRE(mplex->modify({0, MPLEX_IN, test_channel.get_read_end()}) != 0);
+}
+
+TEST_CASE("multiplexor reports events by data", "[event_data]") {
+    Channel by_fd;
+    Channel by_data;
+    int token = 0;
+    auto mplex = IoMultiplexorFactory::get_multiplexor(test_mplex_size);
+    REQUIRE(mplex->add({0, MPLEX_OUT, by_fd.get_write_end()}) == 0);
+    REQUIRE(mplex->add({0, MPLEX_OUT, by_data.get_write_end(), &token}) == 0);
+
+    io_mplex_event_t events[test_mplex_size];
+    int n_events = mplex->wait(nullptr, events, test_mplex_size);
+    REQUIRE(n_events == 2);
+    int seen = 0;
+    for (int i = 0; i < n_events; i++) {
+        REQUIRE((events[i].filters & MPLEX_OUT) != 0);
+        if (events[i].data == nullptr) {
+            REQUIRE(events[i].fd == by_fd.get_write_end());
+            seen |= 1;
+        } else {
+            REQUIRE(events[i].data == &token);
+            seen |= 2;
+        }
+    }
+    REQUIRE(seen == 3);
+
+    // never more than asked for
+    REQUIRE(mplex->wait(nullptr, events, 1) == 1);
+}
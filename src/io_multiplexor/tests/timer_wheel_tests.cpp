@@ -0,0 +1,144 @@
+// Test cases for TimerWheel and multiplexor timers
+//
+// 17 October 2026
+
+#include <common/utilities.hpp>
+#include <io_multiplexor/IoMultiplexorFactory.hpp>
+#include <io_multiplexor/TimerWheel.hpp>
+
+#include <catch2/catch_all.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+// advance to each point the wheel asks to be woken at, recording
+// the tick each timer expires on
+static std::vector<uint64_t> run_wheel(TimerWheel &wheel, uint64_t until)
+{
+    std::vector<uint64_t> expired;
+    while (wheel.now() < until) {
+        int64_t timeout = wheel.next_timeout();
+        if (timeout == -1) {
+            break;
+        }
+        uint64_t now = wheel.now() + (timeout > 0 ? timeout : 1);
+        wheel.advance(now);
+        mplex_timer_t *timer = nullptr;
+        while ((timer = wheel.pop_expired()) != nullptr) {
+            REQUIRE(!timer->is_active());
+            REQUIRE(timer->expires == now);
+            expired.push_back(now);
+        }
+    }
+    return expired;
+}
+
+TEST_CASE("timer wheel expires timers on their tick", "[timer_wheel]") {
+    auto start = GENERATE(uint64_t(0), uint64_t(37), uint64_t(4095), uint64_t(1000000));
+    TimerWheel wheel(start);
+
+    // delays that land in each level and on level boundaries
+    std::vector<uint64_t> delays{1, 2, 63, 64, 65, 100, 4095, 4096, 4097, 50000, 262144, 300000};
+    std::vector<mplex_timer_t> timers(delays.size());
+    for (size_t i = 0; i < delays.size(); i++) {
+        wheel.schedule(timers[i], delays[i]);
+        REQUIRE(timers[i].is_active());
+    }
+    REQUIRE(wheel.size() == delays.size());
+
+    auto expired = run_wheel(wheel, start + 300000);
+    REQUIRE(expired.size() == delays.size());
+    for (size_t i = 0; i < delays.size(); i++) {
+        REQUIRE(expired[i] == start + delays[i]);
+    }
+    REQUIRE(wheel.size() == 0);
+    REQUIRE(wheel.next_timeout() == -1);
+}
+
+TEST_CASE("timer wheel skips ahead", "[timer_wheel_skip]") {
+    TimerWheel wheel(10);
+    mplex_timer_t near;
+    mplex_timer_t far;
+    wheel.schedule(near, 5);
+    wheel.schedule(far, 100000);
+
+    REQUIRE(wheel.next_timeout() == 5);
+    wheel.advance(200000);
+    REQUIRE(wheel.pop_expired() == &near);
+    REQUIRE(wheel.pop_expired() == &far);
+    REQUIRE(wheel.pop_expired() == nullptr);
+    REQUIRE(wheel.now() == 200000);
+}
+
+TEST_CASE("timer wheel cancels and restarts timers", "[timer_wheel_cancel]") {
+    TimerWheel wheel(0);
+    mplex_timer_t cancelled;
+    mplex_timer_t restarted;
+    wheel.schedule(cancelled, 10);
+    wheel.schedule(restarted, 10);
+
+    wheel.cancel(cancelled);
+    REQUIRE(!cancelled.is_active());
+    wheel.cancel(cancelled);
+    wheel.schedule(restarted, 20);
+    REQUIRE(wheel.size() == 1);
+
+    auto expired = run_wheel(wheel, 100);
+    REQUIRE(expired == std::vector<uint64_t>{20});
+
+    // an expired timer can still be cancelled before it is popped
+    wheel.schedule(cancelled, 0);
+    REQUIRE(wheel.next_timeout() == 0);
+    wheel.cancel(cancelled);
+    REQUIRE(wheel.pop_expired() == nullptr);
+    REQUIRE(wheel.size() == 0);
+}
+
+TEST_CASE("multiplexor waits for less than a second", "[short_timeout]") {
+    Channel test_channel;
+    auto mplex = IoMultiplexorFactory::get_multiplexor(10);
+    REQUIRE(mplex->add({0, MPLEX_IN, test_channel.get_read_end()}) == 0);
+
+    struct timespec timeout{0, 20 * 1000000};
+    io_mplex_event_t events[10];
+    auto start = std::chrono::steady_clock::now();
+    REQUIRE(mplex->wait(&timeout, events, 10) == 0);
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    REQUIRE(elapsed >= std::chrono::milliseconds(20));
+    REQUIRE(elapsed < std::chrono::milliseconds(1000));
+}
+
+TEST_CASE("multiplexor reports expired timers", "[mplex_timer]") {
+    auto mplex = IoMultiplexorFactory::get_multiplexor(10);
+    int first_data = 0;
+    int second_data = 0;
+    mplex_timer_t first;
+    mplex_timer_t second;
+    first.data = &first_data;
+    second.data = &second_data;
+
+    auto start = std::chrono::steady_clock::now();
+    mplex->start_timer(second, 40);
+    mplex->start_timer(first, 20);
+
+    io_mplex_event_t events[10];
+    std::vector<void *> fired;
+    while (fired.size() < 2) {
+        int n_events = mplex->wait(nullptr, events, 10);
+        REQUIRE(n_events >= 0);
+        for (int i = 0; i < n_events; i++) {
+            REQUIRE(events[i].filters == MPLEX_TIMER);
+            REQUIRE(events[i].fd == -1);
+            fired.push_back(events[i].data);
+        }
+    }
+    REQUIRE(std::chrono::steady_clock::now() - start >= std::chrono::milliseconds(40));
+    REQUIRE(fired == std::vector<void *>{&first_data, &second_data});
+
+    // a stopped timer never fires
+    mplex->start_timer(first, 10);
+    mplex->stop_timer(first);
+    struct timespec timeout{0, 30 * 1000000};
+    REQUIRE(mplex->wait(&timeout, events, 10) == 0);
+}
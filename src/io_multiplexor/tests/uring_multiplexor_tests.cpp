@@ -0,0 +1,198 @@
+// Test cases for UringMultiplexor
+//
+// 17 October 2026
+
+#include <common/net_common.hpp>
+#include <common/utilities.hpp>
+#include <io_multiplexor/UringMultiplexor.hpp>
+
+#include <catch2/catch_all.hpp>
+
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+const unsigned uring_test_size = 16;
+
+// nullptr if the kernel has no usable io_uring, the tests then pass trivially
+static std::unique_ptr<UringMultiplexor> make_uring()
+{
+    try {
+        return std::unique_ptr<UringMultiplexor>(new UringMultiplexor(uring_test_size));
+    } catch (const std::runtime_error &e) {
+        WARN("io_uring unavailable: " << e.what());
+        return nullptr;
+    }
+}
+
+TEST_CASE("uring multiplexor reports readiness", "[uring_poll]") {
+    auto mplex = make_uring();
+    if (!mplex) {
+        return;
+    }
+    Channel test_channel;
+    struct timespec no_wait{0, 0};
+    io_mplex_event_t events[uring_test_size];
+    int token = 0;
+
+    REQUIRE(mplex->add({0, MPLEX_IN, test_channel.get_read_end(), &token}) == 0);
+    REQUIRE(mplex->wait(&no_wait, events, uring_test_size) == 0);
+
+    std::string message{"uring"};
+    REQUIRE(test_channel.write(message) == static_cast<ssize_t>(message.size()));
+    REQUIRE(mplex->wait(nullptr, events, uring_test_size) == 1);
+    REQUIRE((events[0].filters & MPLEX_IN) != 0);
+    REQUIRE(events[0].data == &token);
+
+    // level triggered, so it is reported until it is drained
+    REQUIRE(mplex->wait(nullptr, events, uring_test_size) == 1);
+    char buffer[16];
+    REQUIRE(read(test_channel.get_read_end(), buffer, sizeof(buffer)) == static_cast<ssize_t>(message.size()));
+    struct timespec short_wait{0, 20 * 1000000};
+    REQUIRE(mplex->wait(&short_wait, events, uring_test_size) == 0);
+
+    REQUIRE(mplex->remove(test_channel.get_read_end()) == 0);
+    REQUIRE(test_channel.write(message) == static_cast<ssize_t>(message.size()));
+    REQUIRE(mplex->wait(&short_wait, events, uring_test_size) == 0);
+}
+
+TEST_CASE("uring multiplexor re-arms a oneshot with modify", "[uring_modify]") {
+    auto mplex = make_uring();
+    if (!mplex) {
+        return;
+    }
+    Channel test_channel;
+    struct timespec short_wait{0, 20 * 1000000};
+    io_mplex_event_t events[uring_test_size];
+    int fd = test_channel.get_write_end();
+
+    REQUIRE(mplex->modify({MPLEX_ONESHOT, MPLEX_OUT, fd}) != 0);
+    REQUIRE(mplex->add({MPLEX_ONESHOT, MPLEX_OUT, fd}) == 0);
+    REQUIRE(mplex->add({MPLEX_ONESHOT, MPLEX_OUT, fd}) != 0);
+    REQUIRE(mplex->wait(nullptr, events, uring_test_size) == 1);
+    REQUIRE(events[0].fd == fd);
+    REQUIRE(mplex->wait(&short_wait, events, uring_test_size) == 0);
+
+    REQUIRE(mplex->modify({MPLEX_ONESHOT, MPLEX_OUT, fd}) == 0);
+    REQUIRE(mplex->wait(nullptr, events, uring_test_size) == 1);
+
+    // replacing an armed request reports only the new one
+    REQUIRE(mplex->modify({MPLEX_ONESHOT, MPLEX_OUT, fd}) == 0);
+    REQUIRE(mplex->modify({MPLEX_ONESHOT, MPLEX_OUT, fd}) == 0);
+    REQUIRE(mplex->wait(nullptr, events, uring_test_size) == 1);
+    REQUIRE(mplex->wait(&short_wait, events, uring_test_size) == 0);
+}
+
+TEST_CASE("uring multiplexor accepts and receives", "[uring_accept_recv]") {
+    auto mplex = make_uring();
+    if (!mplex) {
+        return;
+    }
+    int listen_fd = bind_socket("127.0.0.1", "0", false, false);
+    REQUIRE(listen_fd != -1);
+    REQUIRE(listen_socket(listen_fd, 16) == 0);
+    struct sockaddr_in addr;
+    socklen_t addr_len = sizeof(addr);
+    REQUIRE(getsockname(listen_fd, reinterpret_cast<struct sockaddr *>(&addr), &addr_len) == 0);
+
+    int listener = 0;
+    REQUIRE(mplex->accept_multishot(listen_fd, &listener) == 0);
+
+    const int n_clients = 3;
+    int clients[n_clients];
+    for (auto &client : clients) {
+        client = socket(AF_INET, SOCK_STREAM, 0);
+        REQUIRE(connect(client, reinterpret_cast<struct sockaddr *>(&addr), addr_len) == 0);
+    }
+
+    io_mplex_event_t events[uring_test_size];
+    std::vector<int> accepted;
+    while (accepted.size() < n_clients) {
+        int n_events = mplex->wait(nullptr, events, uring_test_size);
+        REQUIRE(n_events >= 0);
+        for (int i = 0; i < n_events; i++) {
+            REQUIRE(events[i].filters & MPLEX_ACCEPT);
+            REQUIRE(events[i].filters & MPLEX_MORE);
+            REQUIRE(events[i].data == &listener);
+            REQUIRE(events[i].result >= 0);
+            accepted.push_back(events[i].result);
+        }
+    }
+
+    int receiver = accepted.front();
+    REQUIRE(mplex->recv_multishot(receiver, &receiver) == 0);
+    std::string received;
+    for (const char *part : {"one ", "two ", "three"}) {
+        REQUIRE(::send(clients[0], part, strlen(part), 0) == static_cast<ssize_t>(strlen(part)));
+    }
+    while (received != "one two three") {
+        int n_events = mplex->wait(nullptr, events, uring_test_size);
+        REQUIRE(n_events >= 0);
+        for (int i = 0; i < n_events; i++) {
+            REQUIRE(events[i].filters & MPLEX_RECV);
+            REQUIRE(events[i].result > 0);
+            received.append(events[i].buffer, events[i].result);
+            mplex->release_buffer(events[i]);
+        }
+    }
+
+    // end of file is a zero length receive that ends the request
+    close(clients[0]);
+    REQUIRE(mplex->wait(nullptr, events, uring_test_size) == 1);
+    REQUIRE(events[0].filters == MPLEX_RECV);
+    REQUIRE(events[0].result == 0);
+
+    for (int i = 1; i < n_clients; i++) {
+        close(clients[i]);
+    }
+    for (int fd : accepted) {
+        close(fd);
+    }
+    REQUIRE(mplex->remove(listen_fd) == 0);
+    close(listen_fd);
+}
+
+TEST_CASE("uring multiplexor batches sends", "[uring_send]") {
+    auto mplex = make_uring();
+    if (!mplex) {
+        return;
+    }
+    const int n_pairs = 8;
+    int fds[n_pairs][2];
+    for (auto &pair : fds) {
+        REQUIRE(socketpair(AF_UNIX, SOCK_STREAM, 0, pair) == 0);
+    }
+
+    std::string head{"hello "};
+    std::string tail{"everyone"};
+    struct iovec iov[2] = {{&head[0], head.size()}, {&tail[0], tail.size()}};
+    for (auto &pair : fds) {
+        REQUIRE(mplex->send(pair[0], iov, 2, &pair) == 0);
+    }
+
+    // every send goes out with the wait
+    io_mplex_event_t events[uring_test_size];
+    int completed = 0;
+    while (completed < n_pairs) {
+        int n_events = mplex->wait(nullptr, events, uring_test_size);
+        REQUIRE(n_events >= 0);
+        for (int i = 0; i < n_events; i++) {
+            REQUIRE(events[i].filters == MPLEX_SEND);
+            REQUIRE(events[i].result == static_cast<int>(head.size() + tail.size()));
+            completed++;
+        }
+    }
+    for (auto &pair : fds) {
+        char buffer[32];
+        REQUIRE(read(pair[1], buffer, sizeof(buffer)) == static_cast<ssize_t>(head.size() + tail.size()));
+        REQUIRE(std::string(buffer, head.size() + tail.size()) == "hello everyone");
+        close(pair[0]);
+        close(pair[1]);
+    }
+}
@@ -0,0 +1,156 @@
+// AdminServer.cpp
+//
+// Implementation of the local socket serving
+// the server's metrics.
+//
+// 17 October 2026
+
+#include "AdminServer.hpp"
+
+#include <common/log_util.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <exception>
+
+#include <poll.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+
+// Longest a client that stopped reading can hold up the admin thread
+constexpr int ADMIN_WRITE_TIMEOUT_S = 1;
+
+////
+// @brief bind the admin socket and start serving it
+//
+// @param[in]   path        file system path of the socket, replaced if a
+//                          socket is already there
+// @param[in]   registry    metrics to serve
+//
+// @throws std::runtime_error if the socket cannot be set up
+AdminServer::AdminServer(const std::string &path, MetricsRegistry &registry):
+    path_(path),
+    registry_(registry),
+    listen_fd_(-1),
+    running_(true)
+{
+    struct sockaddr_un addr;
+    memzero(&addr, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if (path_.empty() || path_.size() >= sizeof(addr.sun_path)) {
+        throw std::runtime_error("Admin socket path is empty or too long\n");
+    }
+    memcpy(addr.sun_path, path_.c_str(), path_.size() + 1);
+
+    // a socket left behind by a server that did not shut down cleanly
+    // is replaced, anything else at the path is left alone
+    struct stat st;
+    if (lstat(path_.c_str(), &st) == 0 && S_ISSOCK(st.st_mode)) {
+        unlink(path_.c_str());
+    }
+
+    listen_fd_ = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (listen_fd_ == -1) {
+        throw std::runtime_error("Unable to create admin socket\n");
+    }
+    if (bind(listen_fd_, reinterpret_cast<struct sockaddr *>(&addr), sizeof(addr)) ||
+        chmod(path_.c_str(), S_IRUSR | S_IWUSR) ||
+        listen(listen_fd_, SOMAXCONN)) {
+        log(LogPriority::ERROR, "Unable to listen on admin socket %s: %s\n", path_.c_str(), strerror(errno));
+        close(listen_fd_);
+        throw std::runtime_error("Unable to listen on admin socket\n");
+    }
+    thread_ = std::thread(&AdminServer::serve, this);
+}
+
+AdminServer::~AdminServer()
+{
+    running_ = false;
+    if (stop_notifier_.notify() != 0) {
+        log(LogPriority::ERROR, "Failed to stop admin server -- aborting\n");
+        std::abort();
+    }
+    thread_.join();
+    close(listen_fd_);
+    unlink(path_.c_str());
+}
+
+////
+// @brief accept and answer connections until stopped
+void AdminServer::serve()
+{
+    log(LogPriority::INFO, "Serving metrics at %s\n", path_.c_str());
+    while (running_) {
+        struct pollfd fds[2] = {{listen_fd_, POLLIN, 0}, {stop_notifier_.get_fd(), POLLIN, 0}};
+        if (poll(fds, 2, -1) == -1) {
+            if (errno != EINTR) {
+                log(LogPriority::ERROR, "admin poll error: %s\n", strerror(errno));
+            }
+            continue;
+        }
+        if (fds[1].revents) {
+            break;
+        }
+        int client_fd = accept4(listen_fd_, nullptr, nullptr, SOCK_CLOEXEC);
+        if (client_fd == -1) {
+            if (errno != EINTR && errno != ECONNABORTED) {
+                log(LogPriority::ERROR, "admin accept error: %s\n", strerror(errno));
+            }
+            continue;
+        }
+        answer(client_fd);
+        close(client_fd);
+    }
+}
+
+////
+// @brief send the metrics to a connection
+//
+// @param[in]   client_fd   connection to answer, closed by the caller
+void AdminServer::answer(int client_fd)
+{
+    struct timeval write_timeout{ADMIN_WRITE_TIMEOUT_S, 0};
+    setsockopt(client_fd, SOL_SOCKET, SO_SNDTIMEO, &write_timeout, sizeof(write_timeout));
+
+    // the request is only looked at to tell HTTP apart, one read of
+    // whatever has arrived is enough for that
+    char request[1024];
+    ssize_t request_len = 0;
+    struct pollfd readable{client_fd, POLLIN, 0};
+    if (poll(&readable, 1, ADMIN_READ_TIMEOUT_MS) == 1) {
+        request_len = recv(client_fd, request, sizeof(request) - 1, MSG_DONTWAIT);
+    }
+    request_len = std::max<ssize_t>(request_len, 0);
+    request[request_len] = '\0';
+
+    std::string body = registry_.render();
+    std::string response;
+    if (strncmp(request, "GET ", 4) == 0) {
+        const char *target = request + 4;
+        bool found = strncmp(target, "/ ", 2) == 0 || strncmp(target, "/metrics ", 9) == 0 ||
+                     strncmp(target, "/metrics?", 9) == 0;
+        if (!found) {
+            body = "not found\n";
+        }
+        response = std::string(found ? "HTTP/1.0 200 OK\r\n" : "HTTP/1.0 404 Not Found\r\n") +
+                   "Content-Type: text/plain; version=0.0.4\r\n" +
+                   "Content-Length: " + std::to_string(body.size()) + "\r\n" +
+                   "Connection: close\r\n\r\n";
+    }
+    response += body;
+
+    size_t sent = 0;
+    while (sent < response.size()) {
+        ssize_t n = send(client_fd, response.data() + sent, response.size() - sent, MSG_NOSIGNAL);
+        if (n == -1) {
+            if (errno == EINTR) {
+                continue;
+            }
+            log(LogPriority::INFO, "admin client went away: %s\n", strerror(errno));
+            return;
+        }
+        sent += n;
+    }
+}
@@ -0,0 +1,45 @@
+// AdminServer.hpp
+//
+// Local socket that serves the server's
+// metrics to operators and scrapers.
+//
+// 17 October 2026
+
+#pragma once
+
+#include <common/metrics.hpp>
+#include <common/utilities.hpp>
+
+#include <atomic>
+#include <string>
+#include <thread>
+
+// Longest wait for a request before the metrics are sent anyway
+constexpr int ADMIN_READ_TIMEOUT_MS = 200;
+
+// The admin socket is a unix domain socket, so only local users that
+// the file permissions allow can reach it. Each connection gets the
+// metrics in the Prometheus text format and is closed. A request that
+// starts with GET is answered as HTTP so that curl --unix-socket or a
+// scraper behind a local proxy work, anything else just gets the text.
+// Connections are served one at a time on a thread of their own.
+class AdminServer final {
+public:
+    AdminServer(const std::string &path, MetricsRegistry &registry);
+    ~AdminServer();
+
+    AdminServer(const AdminServer &rhs) = delete;
+    AdminServer(AdminServer &&rhs) = delete;
+    AdminServer& operator=(const AdminServer &rhs) = delete;
+
+private:
+    void serve();
+    void answer(int client_fd);
+
+    std::string path_;
+    MetricsRegistry &registry_;
+    int listen_fd_;
+    std::atomic<bool> running_;
+    EventNotifier stop_notifier_;
+    std::thread thread_;
+};
@@ -8,10 +8,17 @@
 #include "BroadCaster.hpp"
 
 #include <common/log_util.hpp>
+#include <common/metrics.hpp>
 #include <common/net_common.hpp>
+#include <io_multiplexor/IoMultiplexorFactory.hpp>
 
+#include <algorithm>
 #include <cassert>
+#include <chrono>
+#include <exception>
 #include <thread>
+#include <tuple>
+#include <utility>
 
 #include <netinet/in.h>
 #include <arpa/inet.h>
@@ -21,136 +28,630 @@
 
 #include <sys/socket.h>
 
-BroadCaster::BroadCaster()
-    :processing_(true)
+// Only the notifier and clients that are waiting to become
+// writable are watched so a modest event list is plenty. Sends on a
+// completion multiplexor report an event each, and whatever does not
+// fit is left for the next wait
+constexpr unsigned BROADCASTER_MAX_EVENTS = 64;
+
+// Maximum number of events handled between checks for writable clients
+constexpr size_t BROADCASTER_BATCH_SIZE = 1024;
+
+// Frames handed to a single send on a completion multiplexor
+constexpr int BROADCASTER_SEND_IOV = 16;
+
+// Metrics of every broadcaster, updated by each one's own thread
+// except for the queue depth which producers add to
+struct broadcaster_metrics_t {
+    Gauge &queued_events;
+    Counter &frames_queued;
+    Counter &bytes_sent;
+    Counter &slow_drops;
+    Counter &slow_disconnects;
+    Histogram &batch_ns;
+};
+
+static broadcaster_metrics_t &broadcaster_metrics()
+{
+    static auto &registry = MetricsRegistry::instance();
+    static broadcaster_metrics_t metrics{
+        registry.gauge("chat_broadcaster_queued_events", "Events waiting in broadcaster queues."),
+        registry.counter("chat_frames_queued_total", "Frames queued for clients to be written."),
+        registry.counter("chat_bytes_sent_total", "Bytes written to clients."),
+        registry.counter("chat_slow_consumer_drops_total", "Frames dropped because a client fell behind."),
+        registry.counter("chat_slow_consumer_disconnects_total", "Clients disconnected for falling behind."),
+        registry.histogram("chat_broadcaster_batch_seconds", "Time a broadcaster takes to handle a batch of events.",
+                           1e-9),
+    };
+    return metrics;
+}
+
+BroadCaster::BroadCaster():
+    BroadCaster(DEFAULT_OUT_BUFFER_SIZE, SlowConsumerPolicy::DROP_OLDEST)
 {
+}
+
+////
+// @brief create a BroadCaster and start its processing thread
+//
+// @param[in]   out_buffer_size     bytes that may be queued for each client
+// @param[in]   policy              what to do when a client's queue is full
+// @param[in]   backend             multiplexor to write clients with
+//
+// @throws std::runtime_error if the multiplexor cannot be set up
+BroadCaster::BroadCaster(size_t out_buffer_size, SlowConsumerPolicy policy, MplexBackend backend):
+    processing_(true),
+    sleeping_(false),
+    out_buffer_size_(out_buffer_size),
+    policy_(policy),
+    event_queue_(BROADCASTER_QUEUE_SIZE),
+    out_registered_(0),
+    sends_in_flight_(0),
+    client_table_(out_buffer_size)
+{
+    io_mplex_ = IoMultiplexorFactory::get_multiplexor(BROADCASTER_MAX_EVENTS, backend);
+    if (io_mplex_ == nullptr) {
+        throw std::runtime_error("Unable to allocate multiplexor\n");
+    }
+    int rc = io_mplex_->add({0, MPLEX_IN, notifier_.get_fd()});
+    if (rc != 0) {
+        throw std::runtime_error("Unable to setup notifier\n");
+    }
     process_ = std::thread(&BroadCaster::process_events, std::ref(*this));
 }
 
 BroadCaster::~BroadCaster()
 {
-    queue_lock_.lock();
     processing_ = false;
-    queue_condition_.notify_one();
-    queue_lock_.unlock();
+    if (notifier_.notify() != 0) {
+        log(LogPriority::ERROR, "Failed to stop broadcaster -- aborting\n");
+        std::abort();
+    }
     process_.join();
 }
 
 ////
-// @brief read a message from the client
+// @brief encode a message once and add it to the BroadCaster
 //
-// @param[in]   client_fd   client to read message from
-void BroadCaster::read_message(int client_fd)
+// @param[in]   type        BROADCAST or DIRECT_MSG
+// @param[in]   client_fd   client that sent the message
+// @param[in]   message     message to send
+void BroadCaster::add_message(EventType type, int client_fd, const message_t &message)
 {
-    message_t message;
-    int rc = ::read_message(client_fd, message);
-    if (rc) {
-        log(LogPriority::ERROR, "failed to read message from client\n");
+    auto frame = make_frame(message);
+    if (frame == nullptr) {
+        log(LogPriority::ERROR, "Failed to encode message from client %d\n", client_fd);
         return;
     }
-    if (message.header.target == nullptr) {
-        add_event({EventType::BROADCAST, client_fd, nullptr, std::move(message)});
-    } else {
-        add_event({EventType::DIRECT_MSG, client_fd, nullptr, std::move(message)});
-    }
+    add_event({type, client_fd, std::move(frame), {}});
+}
+
+////
+// @brief add an event carrying a copy of name to the BroadCaster
+//
+// @param[in]   type        ADD_CLIENT or SET_HOST
+// @param[in]   client_fd   client the name belongs to
+// @param[in]   name        name to copy, truncated to fit the event
+// @param[in]   client_id   id of the client for ADD_CLIENT
+void BroadCaster::add_named_event(EventType type, int client_fd, std::string_view name, uint64_t client_id)
+{
+    event_info_t event{type, client_fd, {}, {}, client_id};
+    size_t len = std::min(name.size(), sizeof(event.name) - 1);
+    memcpy(event.name, name.data(), len);
+    event.name[len] = '\0';
+    add_event(std::move(event));
 }
 
 //// 
 // @brief add an event to the BroadCaster
 //
+// @note producers never take a lock. The processing thread is only
+//       notified when it has parked because the queue was empty.
 void BroadCaster::add_event(event_info_t &&event_info) 
 {
-    std::lock_guard<std::mutex> gl(queue_lock_);
-    event_queue_.push(event_info);
-    queue_condition_.notify_one();
+    if (event_info.trace.traced()) {
+        event_info.trace.enqueued_ns = trace_clock_ns();
+    }
+    while (!event_queue_.try_push(std::move(event_info))) {
+        // queue is full -- let the processing thread catch up
+        std::this_thread::yield();
+    }
+    broadcaster_metrics().queued_events.add();
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (sleeping_.load(std::memory_order_relaxed) && sleeping_.exchange(false)) {
+        if (notifier_.notify() != 0) {
+            log(LogPriority::ERROR, "Failed to wake broadcaster\n");
+        }
+    }
 }
 
 ////
 //  @brief process events enqueued by Server
 //
+//  Events are taken off the queue in batches. Messages are queued on
+//  each recipient's OutBuffer and every recipient is flushed once per
+//  batch. Clients whose socket is full are watched for MPLEX_OUT and
+//  finish flushing when they become writable, so one slow client
+//  never holds up the others. With a completion multiplexor each
+//  recipient gets a send instead of a write, and the sends for a whole
+//  batch reach the kernel together with the next wait.
+//
+//  The thread only parks in the multiplexor once the queue is empty.
 void BroadCaster::process_events()
 {
+    auto &metrics = broadcaster_metrics();
+    io_mplex_event_t ready[BROADCASTER_MAX_EVENTS];
+    std::vector<event_info_t> events;
+    struct timespec no_wait{0, 0};
+    events.reserve(BROADCASTER_BATCH_SIZE);
+
     while (processing_) {
-        std::unique_lock<std::mutex> lk(queue_lock_);
-        if (event_queue_.empty()) {
-            queue_condition_.wait(lk, [this]{ return !processing_ || !event_queue_.empty(); });
-        }
-        if (processing_ == false) {
-            // shutting down -- any events left over are just dropped
-            log(LogPriority::INFO, "Shutting down broadcaster -- remaining events: %lu\n", 
-                    event_queue_.size());
-            lk.unlock();
-            break;
+        event_info_t event;
+        bool traced = false;
+        while (events.size() < BROADCASTER_BATCH_SIZE && event_queue_.try_pop(event)) {
+            if (event.trace.traced()) {
+                event.trace.dequeued_ns = trace_clock_ns();
+                traced = true;
+            }
+            events.push_back(std::move(event));
         }
-        event_info_t event = event_queue_.front();
-        event_queue_.pop();
-        lk.unlock();
-
-        switch (event.type) {
-            case EventType::ADD_CLIENT: 
-            {
-                auto res = client_map_.insert({event.sock_fd, event.source});
-                if (res.second == false) {
-                    log(LogPriority::ERROR, "Failed to insert client %s\n", 
-                            event.source);
-                }
+        metrics.queued_events.sub(events.size());
+
+        struct timespec *timeout = &no_wait;
+        if (events.empty()) {
+            // announce that we are parking and then check the queue
+            // once more so that a concurrent producer is never missed
+            sleeping_.store(true, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (!event_queue_.empty()) {
+                sleeping_.store(false, std::memory_order_relaxed);
+                continue;
             }
-            break;
-            case EventType::DEL_CLIENT: 
-            {
-                auto count = client_map_.erase(event.sock_fd);
-                if (count == 0) {
-                    log(LogPriority::ERROR, "Failed to remove client\n");
-                }
+            timeout = nullptr;
+        }
+
+        if (timeout == nullptr || out_registered_ > 0 || sends_in_flight_ > 0) {
+            int n_events = io_mplex_->wait(timeout, ready, BROADCASTER_MAX_EVENTS);
+            sleeping_.store(false, std::memory_order_relaxed);
+            if (n_events == -1 && errno != EINTR) {
+                log(LogPriority::ERROR, "io_mplex wait error: %s\n", strerror(errno));
             }
-            break;
-            case EventType::BROADCAST:
-            {   
-                // Write the message to all known clients except
-                // the sending client
-                for (auto &client : client_map_) {
-                    int dest_fd = client.first;
-                    if (dest_fd != event.sock_fd) {
-                        int rc = write_message(dest_fd, event.message);
-                        if (rc == -1) {
-                            log(LogPriority::ERROR, "Failed to send message to client %s\n",
-                                client.second);
-                        }
-                    }
-                }
+            handle_writable(ready, n_events);
+        }
+        if (events.empty()) {
+            continue;
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        for (auto &event : events) {
+            handle_event(event);
+        }
+        for (int client_fd : dirty_clients_) {
+            auto client = client_table_.find(client_fd);
+            if (client == nullptr) {
+                continue;
             }
-            break;
-            case EventType::DIRECT_MSG:
-            {
-                bool found = false;
-                const char *target = event.message.header.target;
-                for (auto &client : client_map_) {
-                    if (strncmp(client.second, target, strlen(target)) == 0) {
-                        int rc = write_message(client.first, event.message);
-                        if (rc) {
-                            log(LogPriority::INFO, "Failed to send message to %s\n", target);
-                        }
-                        found = true;
-                        break;
-                    }
-                }
-                if (!found) {
-                    log(LogPriority::INFO, "Unable to send message to %s\n", target);
-                }
+            client->dirty = false;
+            if (!client->out_registered && !client->sending) {
+                flush_client(client_fd, *client);
             }
-            break;
-            default:
-                log(LogPriority::ERROR, "Unknown event type %d\n", static_cast<int>(event.type));
-                std::abort();
         }
+        dirty_clients_.clear();
+        if (traced) {
+            record_traces(events);
+        }
+        events.clear();
+        auto elapsed = std::chrono::steady_clock::now() - start;
+        metrics.batch_ns.record(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
     }
-    
+
+    // shutting down -- any events left over are just dropped
+    size_t remaining = 0;
+    event_info_t event;
+    while (event_queue_.try_pop(event)) {
+        remaining++;
+    }
+    metrics.queued_events.sub(remaining);
+    log(LogPriority::INFO, "Shutting down broadcaster -- remaining events: %lu\n", remaining);
+
+    // closing the multiplexor cancels sends still in flight, which
+    // point into frames owned by the client table
+    io_mplex_.reset();
+
     int rc = 0;
     // Shutdown all client connections and close sockets
-    for (auto &client_info : client_map_) {
+    for (auto &client_info : client_table_) {
         rc = terminate_connection(client_info.first, SHUT_WR);
         if (rc) {
-            log(LogPriority::ERROR, "Failed to terminate connection to %s\n", client_info.second);
+            log(LogPriority::ERROR, "Failed to terminate connection to %s\n", client_info.second.name.data());
+        }
+    }
+}
+
+////
+// @brief record the stage times of the traced messages in a batch
+//
+// @param[in]   events  batch that has just been flushed
+void BroadCaster::record_traces(const std::vector<event_info_t> &events)
+{
+    auto &metrics = trace_metrics();
+    uint64_t flushed_ns = trace_clock_ns();
+    for (const auto &event : events) {
+        const auto &trace = event.trace;
+        if (!trace.traced()) {
+            continue;
+        }
+        metrics.decode_enqueue.record(trace.enqueued_ns - trace.decoded_ns);
+        metrics.queue_wait.record(trace.dequeued_ns - trace.enqueued_ns);
+        metrics.fan_out.record(flushed_ns - trace.dequeued_ns);
+        metrics.delivery.record(flushed_ns - trace.received_ns);
+    }
+}
+
+////
+// @brief handle a single event from the queue
+//
+// @param[in]   event   event to handle, its trace is cleared if the
+//                      message is not for any of this broadcaster's
+//                      clients
+void BroadCaster::handle_event(event_info_t &event)
+{
+    switch (event.type) {
+        case EventType::ADD_CLIENT: 
+        {
+            auto client = client_table_.add(event.sock_fd, event.name);
+            if (client == nullptr) {
+                log(LogPriority::ERROR, "Failed to insert client %s\n", 
+                        event.name);
+                break;
+            }
+            client->id = event.client_id;
+        }
+        break;
+        case EventType::DEL_CLIENT: 
+        {
+            auto client = client_table_.find(event.sock_fd);
+            if (client == nullptr) {
+                // never added, but the socket is still ours to close
+                log(LogPriority::ERROR, "Failed to remove client\n");
+                close(event.sock_fd);
+                break;
+            }
+            // a send in flight still owns the front of the queue, so
+            // the client goes once it completes
+            if (client->sending) {
+                client->deleted = true;
+                break;
+            }
+            remove_client(event.sock_fd, *client);
+        }
+        break;
+        case EventType::BROADCAST:
+        {   
+            // Queue the message for all known clients except
+            // the sending client
+            for (auto &client : client_table_) {
+                int dest_fd = client.first;
+                if (dest_fd != event.sock_fd) {
+                    queue_message(dest_fd, client.second, event.frame);
+                }
+            }
+        }
+        break;
+        case EventType::DIRECT_MSG:
+        {
+            auto target = event.frame->target();
+            int dest_fd = client_table_.find(target);
+            if (dest_fd == -1) {
+                // with several shards only one of them has the target
+                log(LogPriority::DEBUG, "Unable to send message to %.*s\n",
+                        static_cast<int>(target.size()), target.data());
+                // the shard that has the target records the trace
+                event.trace = {};
+                break;
+            }
+            queue_message(dest_fd, *client_table_.find(dest_fd), event.frame);
+        }
+        break;
+        case EventType::SEND_TO:
+        {
+            auto client = client_table_.find(event.sock_fd);
+            if (client != nullptr && client->id == event.client_id) {
+                queue_message(event.sock_fd, *client, event.frame);
+            }
+        }
+        break;
+        case EventType::SET_HOST:
+        {
+            auto client = client_table_.find(event.sock_fd);
+            if (client == nullptr || !client_table_.set_host(event.sock_fd, event.name)) {
+                break;
+            }
+            log(LogPriority::INFO, "Client %s is %s\n", client->name.data(), client->host.data());
         }
+        break;
+        default:
+            log(LogPriority::ERROR, "Unknown event type %d\n", static_cast<int>(event.type));
+            std::abort();
+    }
+}
+
+////
+// @brief handle readiness events from the multiplexor
+//
+// @param[in]   events      wake channel and client readiness events
+// @param[in]   n_events    number of events, may be -1 after an error
+//
+// @note clients are registered with their client_info_t as the event
+//       data, so they are dispatched without a table lookup
+void BroadCaster::handle_writable(const io_mplex_event_t *events, int n_events)
+{
+    for (int i = 0; i < n_events; i++) {
+        const auto &event = events[i];
+        if (event.data == nullptr) {
+            if (event.fd == notifier_.get_fd()) {
+                notifier_.drain();
+            }
+            continue;
+        }
+        auto &client = *static_cast<client_info_t *>(event.data);
+        if (event.filters & MPLEX_SEND) {
+            handle_sent(client, event.result);
+            continue;
+        }
+        if (!client.out_registered) {
+            continue;
+        }
+        // the oneshot has fired and is no longer armed
+        client.out_registered = false;
+        out_registered_--;
+        flush_client(client.fd, client);
+    }
+}
+
+////
+// @brief queue a message on a client's OutBuffer, applying the
+//        slow consumer policy if it does not fit
+//
+// @param[in]   client_fd   client to send the message to
+// @param[in]   client      state of the client
+// @param[in]   frame       encoded message to queue
+void BroadCaster::queue_message(int client_fd, client_info_t &client, const frame_ptr_t &frame)
+{
+    if (client.closing || client.deleted) {
+        return;
+    }
+    auto &metrics = broadcaster_metrics();
+    if (client.out.push(frame)) {
+        metrics.frames_queued.add();
+    } else {
+        // make room with whatever the socket will take right now
+        if (!client.out_registered && !client.sending) {
+            flush_client(client_fd, client);
+        }
+        if (client.closing) {
+            return;
+        }
+        if (client.out.push(frame)) {
+            metrics.frames_queued.add();
+        } else {
+            switch (policy_) {
+                case SlowConsumerPolicy::DROP_OLDEST:
+                    metrics.slow_drops.add(client.out.drop_oldest(frame->len));
+                    if (!client.out.push(frame)) {
+                        metrics.slow_drops.add();
+                        log(LogPriority::INFO, "Dropped message to slow client %s\n", client.name.data());
+                    } else {
+                        metrics.frames_queued.add();
+                    }
+                    break;
+                case SlowConsumerPolicy::DROP_NEWEST:
+                    metrics.slow_drops.add();
+                    log(LogPriority::INFO, "Dropped message to slow client %s\n", client.name.data());
+                    break;
+                case SlowConsumerPolicy::DISCONNECT:
+                    disconnect_client(client_fd, client);
+                    return;
+            }
+        }
+    }
+    if (!client.dirty) {
+        client.dirty = true;
+        dirty_clients_.push_back(client_fd);
+    }
+}
+
+////
+// @brief write as much of a client's OutBuffer as the socket takes
+//
+// @param[in]   client_fd   client to flush
+// @param[in]   client      state of the client
+void BroadCaster::flush_client(int client_fd, client_info_t &client)
+{
+    if (client.closing) {
+        return;
+    }
+    if (io_mplex_->has_completions()) {
+        send_client(client_fd, client);
+        return;
+    }
+    size_t queued = client.out.size();
+    auto status = client.out.flush(client_fd);
+    broadcaster_metrics().bytes_sent.add(queued - client.out.size());
+    switch (status) {
+        case FlushStatus::DONE:
+            watch_writable(client_fd, client, false);
+            break;
+        case FlushStatus::AGAIN:
+            if (watch_writable(client_fd, client, true)) {
+                disconnect_client(client_fd, client);
+            }
+            break;
+        case FlushStatus::ERROR:
+            // the server sees the error on its side and deletes the client
+            log(LogPriority::ERROR, "Failed to send messages to client %s\n", client.name.data());
+            client.closing = true;
+            watch_writable(client_fd, client, false);
+            break;
+    }
+}
+
+////
+// @brief queue a send of the front of a client's OutBuffer
+//
+// @param[in]   client_fd   client to send to
+// @param[in]   client      state of the client
+//
+// @note a client has at most one send in flight so its bytes can never
+//       be reordered. The rest of the queue follows once it completes.
+void BroadCaster::send_client(int client_fd, client_info_t &client)
+{
+    if (client.sending || client.closing) {
+        return;
+    }
+    struct iovec iov[BROADCASTER_SEND_IOV];
+    int iovcnt = client.out.fill_iov(iov, BROADCASTER_SEND_IOV);
+    if (iovcnt == 0) {
+        watch_writable(client_fd, client, false);
+        return;
+    }
+    if (io_mplex_->send(client_fd, iov, iovcnt, &client)) {
+        log(LogPriority::ERROR, "Failed to send messages to client %s\n", client.name.data());
+        client.closing = true;
+        watch_writable(client_fd, client, false);
+        return;
+    }
+    client.sending = true;
+    sends_in_flight_++;
+}
+
+////
+// @brief handle the completion of a client's send
+//
+// @param[in]   client  state of the client
+// @param[in]   result  bytes sent or a negative errno
+void BroadCaster::handle_sent(client_info_t &client, int result)
+{
+    client.sending = false;
+    sends_in_flight_--;
+    if (result > 0) {
+        client.out.consume(result);
+        broadcaster_metrics().bytes_sent.add(result);
+    }
+    if (client.deleted) {
+        remove_client(client.fd, client);
+        return;
+    }
+    if (result >= 0) {
+        send_client(client.fd, client);
+    } else if (result == -EAGAIN || result == -EWOULDBLOCK || result == -EINTR) {
+        // full -- try again once the socket is writable
+        if (watch_writable(client.fd, client, true)) {
+            disconnect_client(client.fd, client);
+        }
+    } else if (!client.closing) {
+        // the server sees the error on its side and deletes the client
+        log(LogPriority::ERROR, "Failed to send messages to client %s: %s\n", client.name.data(),
+                strerror(-result));
+        client.closing = true;
+        watch_writable(client.fd, client, false);
+    }
+}
+
+////
+// @brief remove a deleted client and close its socket
+//
+// @param[in]   client_fd   client to remove
+// @param[in]   client      state of the client, gone once this returns
+//
+// @note the server has stopped reading the socket before it deletes
+//       the client, so this is the last user of the descriptor
+void BroadCaster::remove_client(int client_fd, client_info_t &client)
+{
+    // anything queued before the delete is still sent if
+    // the socket will take it
+    if (!client.closing) {
+        client.out.flush(client_fd);
+    }
+    forget_writable(client_fd, client);
+    client_table_.remove(client_fd);
+    if (close(client_fd)) {
+        log(LogPriority::ERROR, "Failed to close client socket %d: %s\n", client_fd, strerror(errno));
+    }
+}
+
+////
+// @brief disconnect a client that cannot keep up
+//
+// @param[in]   client_fd   client to disconnect
+// @param[in]   client      state of the client
+//
+// @note the socket is shut down so that the server reads end of file
+//       and deletes the client through the usual path
+void BroadCaster::disconnect_client(int client_fd, client_info_t &client)
+{
+    log(LogPriority::INFO, "Disconnecting slow client %s (%s)\n", client.name.data(),
+            client.host.empty() ? "unresolved" : client.host.data());
+    broadcaster_metrics().slow_disconnects.add();
+    client.closing = true;
+    watch_writable(client_fd, client, false);
+    if (shutdown(client_fd, SHUT_RDWR)) {
+        log(LogPriority::ERROR, "Failed to shutdown client %s\n", client.name.data());
+    }
+}
+
+////
+// @brief start or stop waiting for a client to become writable
+//
+// @param[in]   client_fd   client to watch
+// @param[in]   client      state of the client
+// @param[in]   watch       true to wait for MPLEX_OUT, false to stop
+//
+// @return  0 on success
+//         -1 on error
+//
+// @note a client is added to the multiplexor the first time it has to
+//       wait and stays there until it is deleted. MPLEX_OUT is a oneshot
+//       that is re-armed with a single modify each time it is needed.
+int BroadCaster::watch_writable(int client_fd, client_info_t &client, bool watch)
+{
+    if (client.out_registered == watch) {
+        return 0;
+    }
+    io_mplex_fd_info_t fd_info{MPLEX_ONESHOT, watch ? MPLEX_OUT : 0, client_fd, &client};
+    if (!client.out_added) {
+        if (io_mplex_->add(fd_info)) {
+            log(LogPriority::ERROR, "Failed to wait for client %s\n", client.name.data());
+            return -1;
+        }
+        client.out_added = true;
+    } else if (io_mplex_->modify(fd_info)) {
+        log(LogPriority::ERROR, "Failed to %s client %s\n", watch ? "wait for" : "stop waiting for",
+                client.name.data());
+        return -1;
+    }
+    if (watch) {
+        out_registered_++;
+    } else {
+        out_registered_--;
+    }
+    client.out_registered = watch;
+    return 0;
+}
+
+////
+// @brief stop watching a client that is being deleted
+//
+// @param[in]   client_fd   client to forget
+// @param[in]   client      state of the client
+void BroadCaster::forget_writable(int client_fd, client_info_t &client)
+{
+    if (client.out_registered) {
+        out_registered_--;
+        client.out_registered = false;
+    }
+    if (client.out_added && io_mplex_->remove(client_fd)) {
+        log(LogPriority::ERROR, "Failed to remove client %s from multiplexor\n", client.name.data());
     }
+    client.out_added = false;
 }
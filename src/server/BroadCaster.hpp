@@ -5,35 +5,62 @@
 //
 // 16-May-2021
 
+#pragma once
+
+#include "ClientTable.hpp"
+#include "MessageTrace.hpp"
+#include "OutBuffer.hpp"
+
+#include <common/frame.hpp>
+#include <common/mpsc_queue.hpp>
 #include <common/protocol.hpp>
+#include <common/utilities.hpp>
+#include <io_multiplexor/IoMultiplexor.hpp>
 
-#include <string>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string_view>
 #include <vector>
-#include <queue>
-#include <mutex>
-#include <condition_variable>
 #include <thread>
-#include <unordered_map>
 
-#include <cassert>
 
 enum class EventType : int {
     ADD_CLIENT,
     DEL_CLIENT,
     BROADCAST,
     DIRECT_MSG,
+    SET_HOST,
+    SEND_TO,
+};
+
+// What to do with a client whose outbound buffer is full
+enum class SlowConsumerPolicy : int {
+    DROP_OLDEST,    // drop queued messages to make room for new ones
+    DROP_NEWEST,    // drop the message that does not fit
+    DISCONNECT,     // disconnect the client
 };
 
+constexpr size_t DEFAULT_OUT_BUFFER_SIZE = 16 * 1024;
+
+// Events that can be waiting for the BroadCaster before producers
+// have to wait for it to catch up
+constexpr size_t BROADCASTER_QUEUE_SIZE = 16 * 1024;
+
 struct event_info_t {
     EventType type;
     int sock_fd;
-    const char *source;
-    message_t message;
+    frame_ptr_t frame;                  // shared by every recipient
+    char name[CLIENT_NAME_MAX_SIZE];    // copy of the name for ADD_CLIENT and SET_HOST
+    uint64_t client_id = 0;             // for ADD_CLIENT and SEND_TO
+    msg_trace_t trace = {};             // stage times of a sampled message
 };
 
 class BroadCaster final {
 public:
     BroadCaster();
+    BroadCaster(size_t out_buffer_size, SlowConsumerPolicy policy,
+                MplexBackend backend = MplexBackend::NATIVE);
     ~BroadCaster();
     
     BroadCaster(const BroadCaster &rhs) = delete;
@@ -43,22 +70,36 @@ public:
     ////
     // @brief add a client to the BroadCaster
     // 
-    // @param[in]   name        name of the client
+    // @param[in]   name        name of the client, copied by the call
     // @param[in]   client_fd   connection to client
+    // @param[in]   client_id   id that frames sent to this client must carry
+    //
+    // @note names longer than CLIENT_NAME_MAX_SIZE - 1 are truncated
+    void add_client(std::string_view name, int client_fd, uint64_t client_id = 0)
+    {
+        add_named_event(EventType::ADD_CLIENT, client_fd, name, client_id);
+    }
+
+    ////
+    // @brief attach the host name of a client once it is resolved
     //
-    void add_client(const char *name, int client_fd)
+    // @param[in]   client_fd   connection to client
+    // @param[in]   host        host name, copied and truncated like a name
+    void set_host(int client_fd, std::string_view host)
     {
-        assert(name != nullptr);
-        add_event({EventType::ADD_CLIENT, client_fd, name, {}});
+        add_named_event(EventType::SET_HOST, client_fd, host);
     }
 
     ////
     // @brief delete a client from the BroadCaster
     //
     // @param[in]   client_fd       client file descriptor to delete 
+    //
+    // @note the BroadCaster closes the socket once it has sent
+    //       whatever was queued for the client
     void del_client(int client_fd)
     {
-        add_event({EventType::DEL_CLIENT, client_fd, nullptr, {}});
+        add_event({EventType::DEL_CLIENT, client_fd, {}, {}});
     }
     
     ////
@@ -68,7 +109,7 @@ public:
     // @param[in]  message  message to broadcast
     void broadcast_msg(int client_fd, message_t &&message)
     {
-        add_event({EventType::BROADCAST, client_fd, nullptr, message});
+        add_message(EventType::BROADCAST, client_fd, message);
     }
 
     ////
@@ -78,20 +119,74 @@ public:
     // @param[in]   intended recipient of the message
     // @param[in]   message to send
     void direct_msg(int client_fd, message_t &&message) {
-        add_event({EventType::DIRECT_MSG, client_fd, nullptr, message});
+        add_message(EventType::DIRECT_MSG, client_fd, message);
     }
-    
-    void read_message(int client_fd);
 
-private:
+    ////
+    // @brief broadcast a message that is already encoded
+    //
+    // @param[in]   client_fd   client that sent the message
+    // @param[in]   frame       encoded message, may be shared with other BroadCasters
+    // @param[in]   trace       stage times if the message is traced
+    void broadcast_frame(int client_fd, const frame_ptr_t &frame, const msg_trace_t &trace = {})
+    {
+        add_event({EventType::BROADCAST, client_fd, frame, {}, 0, trace});
+    }
+
+    ////
+    // @brief direct message that is already encoded
+    //
+    // @param[in]   client_fd   client that sent the message
+    // @param[in]   frame       encoded message, may be shared with other BroadCasters
+    // @param[in]   trace       stage times if the message is traced
+    //
+    // @note nothing is sent if the target is not a client of this BroadCaster
+    void direct_frame(int client_fd, const frame_ptr_t &frame, const msg_trace_t &trace = {})
+    {
+        add_event({EventType::DIRECT_MSG, client_fd, frame, {}, 0, trace});
+    }
+
+    ////
+    // @brief send an encoded frame to a single client
+    //
+    // @param[in]   client_fd   client to send the frame to
+    // @param[in]   client_id   id the client was added with
+    // @param[in]   frame       encoded frame, may be shared with other BroadCasters
+    //
+    // @note nothing is sent if client_fd now belongs to another client
+    void send_frame(int client_fd, uint64_t client_id, const frame_ptr_t &frame)
+    {
+        add_event({EventType::SEND_TO, client_fd, frame, {}, client_id});
+    }
 
+private:
     void process_events();
+    void handle_event(event_info_t &event);
+    void handle_writable(const io_mplex_event_t *events, int n_events);
+    void queue_message(int client_fd, client_info_t &client, const frame_ptr_t &frame);
+    void flush_client(int client_fd, client_info_t &client);
+    void send_client(int client_fd, client_info_t &client);
+    void handle_sent(client_info_t &client, int result);
+    void remove_client(int client_fd, client_info_t &client);
+    void disconnect_client(int client_fd, client_info_t &client);
+    int watch_writable(int client_fd, client_info_t &client, bool watch);
+    void forget_writable(int client_fd, client_info_t &client);
 
+    void add_message(EventType type, int client_fd, const message_t &message);
+    void add_named_event(EventType type, int client_fd, std::string_view name, uint64_t client_id = 0);
     void add_event(event_info_t &&event_info);
-    bool processing_;
+    void record_traces(const std::vector<event_info_t> &events);
+    std::atomic<bool> processing_;
+    std::atomic<bool> sleeping_;    // parked waiting on the notifier
     std::thread process_;
-    std::condition_variable queue_condition_;
-    std::mutex queue_lock_;
-    std::queue<event_info_t> event_queue_;
-    std::unordered_map<int, const char*> client_map_;
+    size_t out_buffer_size_;
+    SlowConsumerPolicy policy_;
+    std::unique_ptr<IoMultiplexor> io_mplex_;
+    EventNotifier notifier_;
+    MpscQueue<event_info_t> event_queue_;
+    unsigned out_registered_;       // clients waiting for MPLEX_OUT
+    unsigned sends_in_flight_;      // clients waiting for MPLEX_SEND
+    ClientTable client_table_;
+    // clients with messages queued by the batch being processed
+    std::vector<int> dirty_clients_;
 };
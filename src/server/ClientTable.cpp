@@ -0,0 +1,122 @@
+// ClientTable.cpp
+//
+// Implementation of the table of clients known
+// to a BroadCaster.
+//
+// 17 October 2026
+
+#include "ClientTable.hpp"
+
+#include <common/log_util.hpp>
+
+#include <tuple>
+#include <utility>
+
+ClientTable::ClientTable(size_t out_buffer_size):
+    out_buffer_size_(out_buffer_size)
+{
+}
+
+////
+// @brief add a client and index it by name
+//
+// @param[in]   client_fd   connection to the client
+// @param[in]   name        name of the client
+//
+// @return the new client
+//         nullptr if client_fd is already in the table or name
+//         is too long
+//
+// @note a client whose name is already taken is still added but
+//       cannot be reached by name
+client_info_t *ClientTable::add(int client_fd, std::string_view name)
+{
+    if (clients_.count(client_fd) != 0) {
+        return nullptr;
+    }
+    auto interned = strings_.intern(name);
+    if (interned.data() == nullptr) {
+        return nullptr;
+    }
+
+    auto res = clients_.emplace(std::piecewise_construct,
+                                std::forward_as_tuple(client_fd),
+                                std::forward_as_tuple(client_fd, interned, out_buffer_size_));
+    client_info_t &client = res.first->second;
+    client.indexed = names_.emplace(interned, client_fd).second;
+    if (!client.indexed) {
+        log(LogPriority::WARNING, "Client name %s is already in use\n", interned.data());
+    }
+    return &client;
+}
+
+////
+// @brief remove a client and its name
+//
+// @param[in]   client_fd   connection to the client
+//
+// @return true if the client was removed
+bool ClientTable::remove(int client_fd)
+{
+    auto client = clients_.find(client_fd);
+    if (client == clients_.end()) {
+        return false;
+    }
+    if (client->second.indexed) {
+        names_.erase(client->second.name);
+    }
+    strings_.release(client->second.name);
+    if (!client->second.host.empty()) {
+        strings_.release(client->second.host);
+    }
+    clients_.erase(client);
+    return true;
+}
+
+////
+// @brief attach a host name to a client
+//
+// @param[in]   client_fd   connection to the client
+// @param[in]   host        host name of the client
+//
+// @return true if the host name was attached
+bool ClientTable::set_host(int client_fd, std::string_view host)
+{
+    auto client = clients_.find(client_fd);
+    if (client == clients_.end() || host.empty()) {
+        return false;
+    }
+    auto interned = strings_.intern(host);
+    if (interned.data() == nullptr) {
+        return false;
+    }
+    if (!client->second.host.empty()) {
+        strings_.release(client->second.host);
+    }
+    client->second.host = interned;
+    return true;
+}
+
+////
+// @brief find a client by connection
+//
+// @param[in]   client_fd   connection to the client
+//
+// @return the client or nullptr if it is unknown
+client_info_t *ClientTable::find(int client_fd)
+{
+    auto client = clients_.find(client_fd);
+    return client == clients_.end() ? nullptr : &client->second;
+}
+
+////
+// @brief find a client by its exact name
+//
+// @param[in]   name    name of the client
+//
+// @return connection to the client or -1 if no client has that name
+int ClientTable::find(std::string_view name) const
+{
+    auto client = names_.find(name);
+    return client == names_.end() ? -1 : client->second;
+}
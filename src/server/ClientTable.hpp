@@ -0,0 +1,74 @@
+// ClientTable.hpp
+//
+// Table of the clients known to a BroadCaster,
+// indexed by connection and by name.
+//
+// 17 October 2026
+
+#pragma once
+
+#include "OutBuffer.hpp"
+#include "StringTable.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <unordered_map>
+
+struct client_info_t {
+    client_info_t(int client_fd, std::string_view client_name, size_t out_buffer_size):
+        fd(client_fd),
+        name(client_name),
+        host(),
+        out(out_buffer_size),
+        out_added(false),
+        out_registered(false),
+        dirty(false),
+        closing(false),
+        indexed(false),
+        sending(false),
+        deleted(false),
+        id(0) {}
+
+    int fd;
+    std::string_view name;  // interned and null terminated
+    std::string_view host;  // interned host name, empty until resolved
+    OutBuffer out;          // messages waiting to be written
+    bool out_added;         // added to the multiplexor
+    bool out_registered;    // waiting for MPLEX_OUT
+    bool dirty;             // queued to be flushed this batch
+    bool closing;           // disconnected as a slow consumer
+    bool indexed;           // reachable by name
+    bool sending;           // a send is in flight on a completion multiplexor
+    bool deleted;           // deleted while a send was in flight
+    uint64_t id;            // given by the reactor that accepted the client
+};
+
+class ClientTable final {
+public:
+    // nodes never move, so a client_info_t stays put until it is removed
+    using client_map_t = std::unordered_map<int, client_info_t>;
+
+    ClientTable(size_t out_buffer_size);
+    ~ClientTable() = default;
+
+    ClientTable(const ClientTable &rhs) = delete;
+    ClientTable& operator=(const ClientTable &rhs) = delete;
+
+    client_info_t *add(int client_fd, std::string_view name);
+    bool remove(int client_fd);
+    bool set_host(int client_fd, std::string_view host);
+    client_info_t *find(int client_fd);
+    int find(std::string_view name) const;
+
+    size_t size() const { return clients_.size(); }
+    client_map_t::iterator begin() { return clients_.begin(); }
+    client_map_t::iterator end() { return clients_.end(); }
+
+private:
+    size_t out_buffer_size_;
+    client_map_t clients_;
+    StringTable strings_;   // owns the names and hosts of all clients
+    // exact name to client fd, keys view the interned names
+    std::unordered_map<std::string_view, int> names_;
+};
@@ -0,0 +1,57 @@
+// MessageTrace.cpp
+//
+// Clock, sampler and histograms for
+// message tracing.
+//
+// 17 October 2026
+
+#include "MessageTrace.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+#include <time.h>
+
+////
+// @brief histograms shared by every reactor and broadcaster
+trace_metrics_t &trace_metrics()
+{
+    static auto &registry = MetricsRegistry::instance();
+    static trace_metrics_t metrics{
+        registry.histogram("chat_trace_read_decode_seconds",
+                           "Traced messages, from read off the socket to decoded.", 1e-9),
+        registry.histogram("chat_trace_decode_enqueue_seconds",
+                           "Traced messages, from decoded to on a broadcaster queue.", 1e-9),
+        registry.histogram("chat_trace_queue_wait_seconds",
+                           "Traced messages, time spent on a broadcaster queue.", 1e-9),
+        registry.histogram("chat_trace_fan_out_seconds",
+                           "Traced messages, from off the queue to flushed to every recipient.", 1e-9),
+        registry.histogram("chat_trace_delivery_seconds",
+                           "Traced messages, from read off the socket to flushed to every recipient.", 1e-9),
+    };
+    return metrics;
+}
+
+////
+// @brief monotonic time in nanoseconds, never 0
+uint64_t trace_clock_ns()
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return static_cast<uint64_t>(now.tv_sec) * 1000000000 + now.tv_nsec + 1;
+}
+
+////
+// @brief create a sampler
+//
+// @param[in]   fraction    share of reads to trace, 0 for none and 1
+//                          for all of them
+TraceSampler::TraceSampler(double fraction):
+    period_(0),
+    countdown_(0)
+{
+    if (fraction > 0) {
+        period_ = std::max<uint64_t>(1, std::llround(1.0 / std::min(fraction, 1.0)));
+        countdown_ = period_;
+    }
+}
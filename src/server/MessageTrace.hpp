@@ -0,0 +1,60 @@
+// MessageTrace.hpp
+//
+// Sampled timing of messages as they pass
+// through the server.
+//
+// 17 October 2026
+
+#pragma once
+
+#include <common/metrics.hpp>
+
+#include <cstdint>
+
+// Fraction of reads whose first message is traced
+constexpr double DEFAULT_TRACE_SAMPLE = 0.001;
+
+// Monotonic times in nanoseconds that a traced message reached each
+// stage. Times are 0 for a message that is not traced. The wire
+// time_stamp is the sender's wall clock, so it is never used for these.
+struct msg_trace_t {
+    uint64_t received_ns = 0;       // bytes read off the socket
+    uint64_t decoded_ns = 0;        // frame complete and decoded
+    uint64_t enqueued_ns = 0;       // pushed on a BroadCaster's queue
+    uint64_t dequeued_ns = 0;       // taken off the queue
+
+    bool traced() const { return received_ns != 0; }
+};
+
+// Per stage latencies of traced messages. A message goes to every
+// BroadCaster, so the stages after decoding are recorded by each.
+struct trace_metrics_t {
+    Histogram &read_decode;         // received to decoded
+    Histogram &decode_enqueue;      // decoded to enqueued, encoding included
+    Histogram &queue_wait;          // enqueued to dequeued
+    Histogram &fan_out;             // dequeued to flushed to every recipient
+    Histogram &delivery;            // received to flushed to every recipient
+};
+
+trace_metrics_t &trace_metrics();
+uint64_t trace_clock_ns();
+
+// Picks one in every period reads to trace. Each reactor has its own,
+// so sampling costs a decrement and no clock reads or atomics.
+class TraceSampler final {
+public:
+    TraceSampler(double fraction);
+
+    bool sample()
+    {
+        if (period_ == 0 || --countdown_ > 0) {
+            return false;
+        }
+        countdown_ = period_;
+        return true;
+    }
+
+private:
+    uint64_t period_;               // 0 when tracing is off
+    uint64_t countdown_;            // reads until the next traced one
+};
@@ -0,0 +1,124 @@
+// OutBuffer.cpp
+//
+// Implementation of the bounded queue of messages
+// waiting to be written to a client.
+//
+// 17 October 2026
+
+#include "OutBuffer.hpp"
+
+#include <errno.h>
+
+// Maximum number of frames handed to a single writev
+constexpr int OUT_BUFFER_MAX_IOV = 64;
+
+OutBuffer::OutBuffer(size_t capacity):
+    capacity_(capacity),
+    size_(0),
+    head_written_(0)
+{
+}
+
+////
+// @brief queue a reference to a frame
+//
+// @param[in]   frame   frame to queue
+//
+// @return true if the frame was queued
+//         false if it does not fit
+bool OutBuffer::push(const frame_ptr_t &frame)
+{
+    if (frame->len > available()) {
+        return false;
+    }
+    frames_.push_back(frame);
+    size_ += frame->len;
+    return true;
+}
+
+////
+// @brief drop whole frames from the front of the queue
+//
+// @param[in]   n_bytes     space that should be made available
+//
+// @return number of frames dropped
+//
+// @note a frame that has been partially written is never dropped
+//       since that would corrupt the stream
+size_t OutBuffer::drop_oldest(size_t n_bytes)
+{
+    size_t keep = head_written_ != 0 ? 1 : 0;
+    auto first = frames_.begin() + keep;
+    auto last = first;
+
+    while (available() < n_bytes && last != frames_.end()) {
+        size_ -= (*last)->len;
+        last++;
+    }
+    size_t dropped = last - first;
+    frames_.erase(first, last);
+    return dropped;
+}
+
+////
+// @brief write as much of the queue as the socket will take
+//
+// @param[in]   sock_fd     socket to write to
+//
+// @return FlushStatus describing the state of the queue
+FlushStatus OutBuffer::flush(int sock_fd)
+{
+    while (size_ > 0) {
+        struct iovec iov[OUT_BUFFER_MAX_IOV];
+        int iovcnt = fill_iov(iov, OUT_BUFFER_MAX_IOV);
+
+        ssize_t bytes_written = writev(sock_fd, iov, iovcnt);
+        if (bytes_written == -1) {
+            if (errno == EINTR) {
+                continue;
+            } else if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                return FlushStatus::AGAIN;
+            }
+            return FlushStatus::ERROR;
+        }
+        consume(bytes_written);
+    }
+    return FlushStatus::DONE;
+}
+
+////
+// @brief describe the start of the queue for a vectored write
+//
+// @param[out]  iov         filled with the unwritten part of each frame
+// @param[in]   max_iov     size of iov
+//
+// @return number of iovecs filled, 0 if the queue is empty
+//
+// @note the iovecs point into the queued frames, so they stay valid
+//       until the bytes are consumed
+int OutBuffer::fill_iov(struct iovec *iov, int max_iov) const
+{
+    int iovcnt = 0;
+    size_t offset = head_written_;
+    for (auto frame = frames_.begin(); frame != frames_.end() && iovcnt < max_iov; frame++) {
+        iov[iovcnt].iov_base = const_cast<char *>((*frame)->data) + offset;
+        iov[iovcnt].iov_len = (*frame)->len - offset;
+        iovcnt++;
+        offset = 0;
+    }
+    return iovcnt;
+}
+
+////
+// @brief drop bytes from the front of the queue once they are written
+//
+// @param[in]   n_bytes     bytes written, at most size()
+void OutBuffer::consume(size_t n_bytes)
+{
+    size_ -= n_bytes;
+    head_written_ += n_bytes;
+    while (!frames_.empty() && head_written_ >= frames_.front()->len) {
+        head_written_ -= frames_.front()->len;
+        frames_.pop_front();
+    }
+}
@@ -0,0 +1,53 @@
+// OutBuffer.hpp
+//
+// Bounded queue of encoded messages waiting to
+// be written to a client.
+//
+// 17 October 2026
+
+#pragma once
+
+#include <common/frame.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+
+#include <sys/uio.h>
+
+// Outcome of OutBuffer::flush
+enum class FlushStatus : int {
+    DONE,       // everything queued was written
+    AGAIN,      // socket is full -- wait for it to become writable
+    ERROR,      // write error, the client should be dropped
+};
+
+// Frames are shared with every other client they are sent to, so
+// queueing a message only takes a reference. The queue is bounded by
+// the number of bytes waiting to be written.
+class OutBuffer final {
+public:
+    OutBuffer(size_t capacity);
+    ~OutBuffer() = default;
+
+    OutBuffer(const OutBuffer &rhs) = delete;
+    OutBuffer& operator=(const OutBuffer &rhs) = delete;
+    OutBuffer(OutBuffer &&rhs) = default;
+
+    bool push(const frame_ptr_t &frame);
+    size_t drop_oldest(size_t n_bytes);
+    FlushStatus flush(int sock_fd);
+    int fill_iov(struct iovec *iov, int max_iov) const;
+    void consume(size_t n_bytes);
+
+    size_t size() const { return size_; }
+    size_t capacity() const { return capacity_; }
+    size_t available() const { return capacity_ - size_; }
+    bool empty() const { return size_ == 0; }
+
+private:
+    size_t capacity_;
+    size_t size_;               // bytes queued
+    size_t head_written_;       // bytes of the first frame already written
+    std::deque<frame_ptr_t> frames_;
+};
@@ -0,0 +1,727 @@
+// Reactor.cpp
+//
+// Implementation of the event loop serving
+// one shard of the server's connections.
+//
+// 17 October 2026
+
+#include "Reactor.hpp"
+
+#include <common/log_util.hpp>
+#include <common/metrics.hpp>
+#include <common/net_common.hpp>
+#include <common/utilities.hpp>
+#include <io_multiplexor/IoMultiplexorFactory.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <ctime>
+#include <exception>
+#include <thread>
+#include <tuple>
+#include <utility>
+
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <netdb.h>
+#include <unistd.h>
+
+// Unanswered keepalive probes before the kernel resets a connection
+constexpr int REACTOR_KEEPALIVE_PROBES = 3;
+
+// Ids are unique across every reactor so that a client is never
+// confused with a later one on the same descriptor
+static std::atomic<uint64_t> next_client_id{1};
+
+// Metrics of every reactor, each updates them from its own thread
+struct reactor_metrics_t {
+    Counter &accepted;
+    Counter &closed;
+    Counter &evicted;
+    Counter &idle_timeouts;
+    Gauge &open;
+    Counter &messages;
+    Counter &bytes;
+    Histogram &batch_ns;
+};
+
+static reactor_metrics_t &reactor_metrics()
+{
+    static auto &registry = MetricsRegistry::instance();
+    static reactor_metrics_t metrics{
+        registry.counter("chat_connections_accepted_total", "Client connections accepted."),
+        registry.counter("chat_connections_closed_total", "Client connections closed for any reason."),
+        registry.counter("chat_connections_evicted_total", "Least recently active clients evicted at capacity."),
+        registry.counter("chat_connections_idle_timeouts_total", "Clients disconnected for not answering a ping."),
+        registry.gauge("chat_connections_open", "Client connections open."),
+        registry.counter("chat_messages_received_total", "Frames received from clients."),
+        registry.counter("chat_bytes_received_total", "Bytes of complete frames received from clients."),
+        registry.histogram("chat_reactor_batch_seconds", "Time a reactor takes to handle the events of a wait.",
+                           1e-9),
+    };
+    return metrics;
+}
+
+////
+// @brief bind a listening socket and start serving clients
+//
+// @param[in]   config          server configuration
+// @param[in]   shard           index of this reactor's BroadCaster
+// @param[in]   broadcasters    BroadCaster of every shard
+// @param[in]   resolver        resolves host names, null to leave clients
+//                              named by address only
+// @param[in]   room_shards     RoomShard of every room shard, empty to
+//                              ignore rooms
+//
+// @throws std::runtime_error if the socket or multiplexor cannot be set up
+Reactor::Reactor(const server_config_t &config, size_t shard,
+                 const std::vector<BroadCaster *> &broadcasters, Resolver *resolver,
+                 const std::vector<RoomShard *> &room_shards):
+        address_(config.address),
+        port_(config.port),
+        server_socket_(-1),
+        max_conn_(config.max_conn),
+        is_running_(false),
+        completions_(false),
+        idle_timeout_ms_(config.idle_timeout_ms),
+        ping_timeout_ms_(config.ping_timeout_ms),
+        sampler_(config.trace_sample),
+        trace_received_ns_(0),
+        broadcaster_(*broadcasters.at(shard)),
+        broadcasters_(broadcasters),
+        room_shards_(room_shards),
+        resolver_(resolver),
+        resolved_(RESOLVER_QUEUE_SIZE),
+        lru_{&lru_, &lru_},
+        n_open_(0)
+{
+    // a single reactor does not share its port so that a second
+    // server on the same port still fails to start
+    bool reuse_port = config.n_threads > 1;
+    server_socket_ = bind_socket(address_.c_str(), port_.c_str(), false, reuse_port);
+    if (server_socket_ == -1) {
+        throw std::runtime_error("Unable to bind socket\n");
+    }
+
+    // accepted sockets inherit keepalive from the listening socket
+    if (config.keepalive_s > 0 &&
+        set_keepalive(server_socket_, config.keepalive_s, std::max(1, config.keepalive_s / 3),
+                      REACTOR_KEEPALIVE_PROBES)) {
+        close(server_socket_);
+        throw std::runtime_error("Unable to set keepalive\n");
+    }
+
+    message_t control{};
+    control.header.type = MsgType::PING;
+    ping_ = make_frame(control);
+    control.header.type = MsgType::PONG;
+    pong_ = make_frame(control);
+    if (ping_ == nullptr || pong_ == nullptr) {
+        close(server_socket_);
+        throw std::runtime_error("Unable to encode control frames\n");
+    }
+
+    int rc = listen_socket(server_socket_, config.backlog);
+    if (rc) {
+        close(server_socket_);
+        throw std::runtime_error("Unable to mark socket for listening\n");
+    }
+
+    // Three additional entries can be returned -- the listening socket,
+    // the stop channel used for shutdown and the resolver notifier
+    io_mplex_ = IoMultiplexorFactory::get_multiplexor(max_conn_ + 3, config.io_backend);
+    if (io_mplex_ == nullptr) {
+        close(server_socket_);
+        throw std::runtime_error("Unable to allocate multiplexor\n");
+    }
+    events_.reset(new io_mplex_event_t[io_mplex_->get_max_events()]);
+    completions_ = io_mplex_->has_completions();
+
+    if (completions_) {
+        rc = io_mplex_->accept_multishot(server_socket_, nullptr);
+    } else {
+        // edge triggered since accept_clients always drains the queue
+        rc = io_mplex_->add({MPLEX_EDGE, MPLEX_IN, server_socket_});
+    }
+    if (rc != 0) {
+        close(server_socket_);
+        throw std::runtime_error("Unable to setup listening socket\n");
+    }
+
+    rc = io_mplex_->add({0, MPLEX_IN, stop_channel_.get_read_end()});
+    if (rc != 0) {
+        close(server_socket_);
+        throw std::runtime_error("Unable to setup pipe\n");
+    }
+
+    rc = io_mplex_->add({0, MPLEX_IN, resolved_notifier_.get_fd()});
+    if (rc != 0) {
+        close(server_socket_);
+        throw std::runtime_error("Unable to setup notifier\n");
+    }
+
+    is_running_ = true;
+    handler_ = std::thread(&Reactor::handle_clients, std::ref(*this));
+}
+
+Reactor::~Reactor()
+{
+    stop();
+    // the multiplexor's timers point into the connections
+    io_mplex_.reset();
+    close(server_socket_);
+}
+
+////
+// @brief stop handling clients and wait for the event loop to exit
+//
+// @note host names resolved after the reactor stops are ignored, so a
+//       Resolver using this reactor can be destroyed once it is stopped
+void Reactor::stop()
+{
+    if (!handler_.joinable()) {
+        return;
+    }
+    is_running_ = false;
+    if (stop_channel_.write("0") != 1) {
+        log(LogPriority::ERROR, "Failed to stop reactor -- aborting\n");
+        std::abort();
+    }
+    handler_.join();
+}
+
+void Reactor::handle_clients()
+{
+    log(LogPriority::INFO, "Now handling clients at %s:%s\n", address_.c_str(), port_.c_str());
+    auto &metrics = reactor_metrics();
+    unsigned max_events = io_mplex_->get_max_events();
+    while (is_running_) {
+        int n_events = io_mplex_->wait(nullptr, events_.get(), max_events);
+        if (n_events == -1) {
+            log(LogPriority::ERROR, "io_mplex wait error: %s\n", strerror(errno));
+            continue;
+        }
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < n_events; i++) {
+            const auto &event = events_[i];
+            if (event.filters & MPLEX_ACCEPT) {
+                handle_accepted(event);
+            } else if (event.data != nullptr) {
+                // client sockets carry their connection
+                auto &connection = *static_cast<connection_t *>(event.data);
+                if (event.filters & MPLEX_RECV) {
+                    handle_received(connection, event);
+                } else if (!connection.open) {
+                    continue;
+                } else if (event.filters & MPLEX_TIMER) {
+                    handle_idle(connection);
+                } else if (event.filters & MPLEX_IN) {
+                    read_client(connection);
+                } else if (event.filters & (MPLEX_EOF | MPLEX_ERR)) {
+                    // remove client and terminate connection
+                    drop_client(connection.fd);
+                }
+            } else if (event.fd == server_socket_) {
+                accept_clients();
+            } else if (event.fd == stop_channel_.get_read_end()) {
+                log(LogPriority::INFO, "received shutdown\n");
+                break;
+            } else if (event.fd == resolved_notifier_.get_fd()) {
+                resolved_notifier_.drain();
+                handle_resolved();
+            }
+        }
+        for (int client_fd : dropped_) {
+            auto connection = connections_.find(client_fd);
+            if (connection != connections_.end() && !connection->second.open) {
+                connections_.erase(connection);
+            }
+        }
+        dropped_.clear();
+        replaced_.clear();
+        auto elapsed = std::chrono::steady_clock::now() - start;
+        metrics.batch_ns.record(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+    }
+}
+
+////
+// @brief accept every connection waiting on the listening socket
+//
+// @note the queue is drained until accept reports EAGAIN so that a
+//       burst of connections costs one readiness event, not one each
+void Reactor::accept_clients()
+{
+    for (;;) {
+        struct sockaddr_storage client_addr;
+        socklen_t addrlen = sizeof(client_addr);
+
+        memzero(&client_addr, sizeof(client_addr));
+        int client_fd = accept_socket(server_socket_, &client_addr, &addrlen);
+        if (client_fd == -1) {
+            if (errno == EINTR || errno == ECONNABORTED) {
+                continue;
+            }
+            // empty queue, or another reactor took the connection
+            if (errno != EAGAIN && errno != EWOULDBLOCK) {
+                log(LogPriority::ERROR, "accept error: %s\n", strerror(errno));
+            }
+            return;
+        }
+        add_client(client_fd, client_addr);
+    }
+}
+
+////
+// @brief add a connection accepted by the multishot accept
+//
+// @param[in]   event   MPLEX_ACCEPT event, its result is the new socket
+//                      or a negative errno
+void Reactor::handle_accepted(const io_mplex_event_t &event)
+{
+    if (event.result >= 0) {
+        struct sockaddr_storage client_addr;
+        socklen_t addrlen = sizeof(client_addr);
+        memzero(&client_addr, sizeof(client_addr));
+        if (getpeername(event.result, reinterpret_cast<struct sockaddr *>(&client_addr), &addrlen)) {
+            // gone before it could be added
+            close(event.result);
+        } else {
+            add_client(event.result, client_addr);
+        }
+    } else if (event.result != -ECONNABORTED && event.result != -EINTR && event.result != -ECANCELED) {
+        log(LogPriority::ERROR, "accept error: %s\n", strerror(-event.result));
+    }
+
+    // the kernel ended the request, start another one
+    if (!(event.filters & MPLEX_MORE) && is_running_ &&
+        io_mplex_->accept_multishot(server_socket_, nullptr)) {
+        log(LogPriority::ERROR, "unable to accept connections: %s\n", strerror(errno));
+    }
+}
+
+////
+// @brief add an accepted connection to this shard
+//
+// @param[in]   client_fd       non-blocking client socket
+// @param[in]   client_addr     address of the client
+//
+// @note the client is named by its numeric address, formatted without
+//       any resolver calls so that accepting never blocks
+void Reactor::add_client(int client_fd, struct sockaddr_storage &client_addr)
+{
+    char peer[ADDRESS_MAX_SIZE];
+    if (format_address(&client_addr, peer, sizeof(peer), true) == -1) {
+        log(LogPriority::ERROR, "unable to format client address\n");
+        int err_rc = terminate_connection(client_fd, SHUT_WR);
+        if (err_rc) {
+            log(LogPriority::ERROR, "failed to terminate socket\n");
+        }
+        return;
+    }
+    log(LogPriority::INFO, "received connection from %s\n", peer);
+
+    if (n_open_ >= max_conn_) {
+        evict_client();
+    }
+
+    // the descriptor may belong to a connection dropped earlier in this
+    // batch, which is kept until the batch is done with it
+    auto replaced = connections_.extract(client_fd);
+    if (!replaced.empty()) {
+        replaced_.push_back(std::move(replaced));
+    }
+    auto &connection = connections_.try_emplace(client_fd).first->second;
+    connection.fd = client_fd;
+    connection.open = true;
+    connection.id = next_client_id.fetch_add(1, std::memory_order_relaxed);
+    connection.idle_timer.data = &connection;
+    memcpy(connection.peer, peer, sizeof(peer));
+
+    int rc = 0;
+    if (completions_) {
+        rc = io_mplex_->recv_multishot(client_fd, &connection);
+    } else {
+        // edge triggered, read_client reads until the socket is drained
+        rc = io_mplex_->add({MPLEX_EDGE, MPLEX_IN | MPLEX_EOF, client_fd, &connection});
+    }
+    if (rc) {
+        log(LogPriority::ERROR, "unable to add client (%s) to multiplexor", peer);
+        connections_.erase(client_fd);
+        int err_rc = terminate_connection(client_fd, SHUT_WR);
+        if (err_rc) {
+            log(LogPriority::ERROR, "failed to terminate socket\n");
+        }
+        return;
+    }
+    touch(connection);
+    n_open_++;
+    reactor_metrics().accepted.add();
+    reactor_metrics().open.add();
+    // connecting is not activity, a silent client is pinged after one timeout
+    connection.active = false;
+    if (idle_timeout_ms_ > 0) {
+        io_mplex_->start_timer(connection.idle_timer, idle_timeout_ms_);
+    }
+    broadcaster_.add_client(peer, client_fd, connection.id);
+
+    if (resolver_ == nullptr) {
+        return;
+    }
+    resolved_host_t resolved{client_fd, peer, {}};
+    resolver_->resolve(client_addr, [this, resolved](const std::string &host) mutable {
+        resolved.host = host;
+        if (!resolved_.try_push(std::move(resolved))) {
+            return;
+        }
+        if (resolved_notifier_.notify() != 0) {
+            log(LogPriority::ERROR, "Failed to wake reactor\n");
+        }
+    });
+}
+
+////
+// @brief hand resolved host names to the broadcaster
+//
+// @note a result is dropped if its connection has closed, even if the
+//       descriptor has since been reused for another client
+void Reactor::handle_resolved()
+{
+    resolved_host_t resolved;
+    while (resolved_.try_pop(resolved)) {
+        auto connection = connections_.find(resolved.client_fd);
+        if (connection == connections_.end() || !connection->second.open ||
+            resolved.peer != connection->second.peer) {
+            continue;
+        }
+        broadcaster_.set_host(resolved.client_fd, resolved.host);
+    }
+}
+
+////
+// @brief read whatever is available from a client and hand
+//        complete messages to the broadcasters
+//
+// @param[in]   connection  client that is ready for reading
+//
+// @note never blocks -- partial messages stay buffered in the
+//       client's FrameReader until the next readiness event
+void Reactor::read_client(connection_t &connection)
+{
+    int client_fd = connection.fd;
+    if (sampler_.sample()) {
+        trace_received_ns_ = trace_clock_ns();
+    }
+    auto status = connection.reader.read_frames(client_fd, [this, &connection](message_t &&message) {
+        dispatch_message(connection, std::move(message));
+    });
+    trace_received_ns_ = 0;
+
+    switch (status) {
+        case ReadStatus::AGAIN:
+            break;
+        case ReadStatus::END:
+            log(LogPriority::INFO, "client %d disconnected\n", client_fd);
+            drop_client(client_fd);
+            break;
+        case ReadStatus::ERROR:
+            log(LogPriority::ERROR, "failed to read message from client %d\n", client_fd);
+            drop_client(client_fd);
+            break;
+    }
+}
+
+////
+// @brief decode bytes received by the multishot recv
+//
+// @param[in]   connection  client the bytes were received from
+// @param[in]   event       MPLEX_RECV event, its result is the number of
+//                          bytes in its buffer or a negative errno
+void Reactor::handle_received(connection_t &connection, const io_mplex_event_t &event)
+{
+    int client_fd = connection.fd;
+    int rc = 0;
+    if (connection.open && event.result > 0) {
+        if (sampler_.sample()) {
+            trace_received_ns_ = trace_clock_ns();
+        }
+        rc = connection.reader.consume(event.buffer, event.result, [this, &connection](message_t &&message) {
+            dispatch_message(connection, std::move(message));
+        });
+        trace_received_ns_ = 0;
+    }
+    io_mplex_->release_buffer(event);
+    if (!connection.open) {
+        return;
+    }
+
+    if (rc) {
+        log(LogPriority::ERROR, "failed to read message from client %d\n", client_fd);
+        drop_client(client_fd);
+    } else if (event.result == 0) {
+        log(LogPriority::INFO, "client %d disconnected\n", client_fd);
+        drop_client(client_fd);
+    } else if (event.result < 0 && event.result != -ENOBUFS) {
+        log(LogPriority::ERROR, "failed to read message from client %d: %s\n", client_fd,
+                strerror(-event.result));
+        drop_client(client_fd);
+    } else if (!(event.filters & MPLEX_MORE) && io_mplex_->recv_multishot(client_fd, &connection)) {
+        // out of buffers or ended by the kernel -- carry on with a new request
+        log(LogPriority::ERROR, "unable to read from client %d\n", client_fd);
+        drop_client(client_fd);
+    }
+}
+
+////
+// @brief hand a message read from a client to the broadcasters
+//
+// @param[in]   connection  client that sent the message, now the most
+//                          recently active
+// @param[in]   message     decoded message
+void Reactor::dispatch_message(connection_t &connection, message_t &&message)
+{
+    touch(connection);
+    auto &metrics = reactor_metrics();
+    metrics.messages.add();
+    metrics.bytes.add(frame_size(message.header));
+    int client_fd = connection.fd;
+    // control frames are answered here and never forwarded
+    switch (message.header.type) {
+        case MsgType::PING:
+            broadcaster_.send_frame(client_fd, connection.id, pong_);
+            return;
+        case MsgType::PONG:
+            return;
+        case MsgType::ROOM:
+            handle_room_request(connection, message);
+            return;
+        case MsgType::DATA:
+            break;
+    }
+    // only members may send to a room
+    if (is_room(message.header.target) &&
+        std::find(connection.rooms.begin(), connection.rooms.end(), message.header.target) == connection.rooms.end()) {
+        log(LogPriority::INFO, "client %d is not in %s -- message dropped\n", client_fd, message.header.target);
+        return;
+    }
+    // only the first message of a traced read is traced. A room's
+    // messages are fanned out by its RoomShard, which carries no trace,
+    // so the read's trace is left for the next message.
+    msg_trace_t trace;
+    if (trace_received_ns_ != 0 && !is_room(message.header.target)) {
+        trace.received_ns = trace_received_ns_;
+        trace.decoded_ns = trace_clock_ns();
+        trace_received_ns_ = 0;
+        trace_metrics().read_decode.record(trace.decoded_ns - trace.received_ns);
+    }
+    // encoded once and shared by every shard. The recipient of a
+    // direct message may be in any shard so each one is asked.
+    auto frame = make_frame(message);
+    if (frame == nullptr) {
+        log(LogPriority::ERROR, "Failed to encode message from client %d\n", client_fd);
+        return;
+    }
+    if (is_room(message.header.target)) {
+        // a room's messages all go through the shard that owns it
+        if (!room_shards_.empty()) {
+            room_shard(message.header.target).publish({client_fd, connection.id, nullptr}, frame);
+        }
+        return;
+    }
+    bool is_broadcast = message.header.target[0] == '\0';
+    for (auto broadcaster : broadcasters_) {
+        if (is_broadcast) {
+            broadcaster->broadcast_frame(client_fd, frame, trace);
+        } else {
+            broadcaster->direct_frame(client_fd, frame, trace);
+        }
+    }
+}
+
+////
+// @brief join, leave or list rooms for a client
+//
+// @param[in]   connection  client that sent the request
+// @param[in]   message     room frame, its data is a single RoomOp
+//
+// @note the reactor keeps the rooms each of its clients is in, so a
+//       list never involves a RoomShard and a dropped client can leave
+//       every room it joined
+void Reactor::handle_room_request(connection_t &connection, const message_t &message)
+{
+    if (message.header.msg_len != 1 || room_shards_.empty()) {
+        log(LogPriority::INFO, "ignoring room frame from client %s\n", connection.peer);
+        return;
+    }
+    std::string_view room(message.header.target);
+    auto joined = std::find(connection.rooms.begin(), connection.rooms.end(), room);
+    room_member_t member{connection.fd, connection.id, &broadcaster_};
+    switch (static_cast<RoomOp>(message.message[0])) {
+        case RoomOp::JOIN:
+            if (joined != connection.rooms.end() || !is_room(room) ||
+                connection.rooms.size() >= ROOM_MAX_JOINED) {
+                log(LogPriority::INFO, "client %s unable to join %s\n", connection.peer, message.header.target);
+                break;
+            }
+            connection.rooms.emplace_back(room);
+            room_shard(room).join(member, room);
+            break;
+        case RoomOp::LEAVE:
+            if (joined != connection.rooms.end()) {
+                connection.rooms.erase(joined);
+                room_shard(room).leave(member, room);
+            }
+            break;
+        case RoomOp::LIST:
+            send_room_list(connection);
+            break;
+        default:
+            log(LogPriority::INFO, "ignoring unknown room request from client %s\n", connection.peer);
+            break;
+    }
+}
+
+////
+// @brief answer a LIST room frame with the rooms a client is in
+//
+// @param[in]   connection  client that asked
+//
+// @note names that do not fit in a single message are left out
+void Reactor::send_room_list(connection_t &connection)
+{
+    message_t reply{};
+    reply.header.type = MsgType::ROOM;
+    reply.header.time_stamp = time(nullptr);
+    reply.message[0] = static_cast<char>(RoomOp::LIST);
+    size_t len = 1;
+    for (const auto &room : connection.rooms) {
+        if (len + room.size() + 1 > MSG_DATA_MAX_SIZE) {
+            break;
+        }
+        memcpy(reply.message + len, room.data(), room.size());
+        len += room.size();
+        reply.message[len++] = '\n';
+    }
+    reply.header.msg_len = len;
+
+    auto frame = make_frame(reply);
+    if (frame == nullptr) {
+        log(LogPriority::ERROR, "Failed to encode room list for client %s\n", connection.peer);
+        return;
+    }
+    broadcaster_.send_frame(connection.fd, connection.id, frame);
+}
+
+////
+// @brief find the RoomShard that owns a room
+RoomShard &Reactor::room_shard(std::string_view room)
+{
+    return *room_shards_[RoomShard::shard_of(room, room_shards_.size())];
+}
+
+////
+// @brief handle the expiry of a client's idle timer
+//
+// @param[in]   connection  client whose timer expired
+//
+// @note a client that was active is given another timeout, a silent
+//       one is pinged and one that ignored the ping is disconnected
+void Reactor::handle_idle(connection_t &connection)
+{
+    if (connection.active) {
+        connection.active = false;
+        io_mplex_->start_timer(connection.idle_timer, idle_timeout_ms_);
+    } else if (!connection.pinged) {
+        connection.pinged = true;
+        broadcaster_.send_frame(connection.fd, connection.id, ping_);
+        io_mplex_->start_timer(connection.idle_timer, ping_timeout_ms_);
+    } else {
+        int client_fd = connection.fd;
+        log(LogPriority::INFO, "client %s did not answer ping -- disconnecting\n", connection.peer);
+        reactor_metrics().idle_timeouts.add();
+        if (shutdown(client_fd, SHUT_RDWR)) {
+            log(LogPriority::ERROR, "failed to shutdown client %d\n", client_fd);
+        }
+        drop_client(client_fd);
+    }
+}
+
+////
+// @brief stop watching a client and remove it from the broadcaster
+//
+// @param[in]   client_fd   client socket to drop
+//
+// @note the connection is erased once the batch of events it was
+//       dropped in has been handled
+void Reactor::drop_client(int client_fd)
+{
+    auto connection = connections_.find(client_fd);
+    if (connection == connections_.end() || !connection->second.open) {
+        return;
+    }
+    connection->second.open = false;
+    io_mplex_->stop_timer(connection->second.idle_timer);
+    room_member_t member{client_fd, connection->second.id, &broadcaster_};
+    for (const auto &room : connection->second.rooms) {
+        room_shard(room).leave(member, room);
+    }
+    connection->second.rooms.clear();
+    unlink(connection->second);
+    n_open_--;
+    reactor_metrics().closed.add();
+    reactor_metrics().open.sub();
+    dropped_.push_back(client_fd);
+    if (io_mplex_->remove(client_fd)) {
+        log(LogPriority::ERROR, "unable to remove client %d from multiplexor\n", client_fd);
+    }
+    broadcaster_.del_client(client_fd);
+}
+
+////
+// @brief disconnect the least recently active client to make room
+//
+// @note the socket is shut down so that the client sees end of file
+void Reactor::evict_client()
+{
+    if (lru_.prev == &lru_) {
+        return;
+    }
+    auto &connection = *static_cast<connection_t *>(lru_.prev);
+    int client_fd = connection.fd;
+    log(LogPriority::INFO, "at capacity -- evicting least recently active client %s\n", connection.peer);
+    reactor_metrics().evicted.add();
+    // shut down first, the broadcaster closes the socket once it is dropped
+    if (shutdown(client_fd, SHUT_RDWR)) {
+        log(LogPriority::ERROR, "failed to shutdown client %d\n", client_fd);
+    }
+    drop_client(client_fd);
+}
+
+////
+// @brief make a connection the most recently active
+void Reactor::touch(connection_t &connection)
+{
+    connection.active = true;
+    connection.pinged = false;
+    if (lru_.next == &connection) {
+        return;
+    }
+    if (connection.next != nullptr) {
+        unlink(connection);
+    }
+    connection.prev = &lru_;
+    connection.next = lru_.next;
+    lru_.next->prev = &connection;
+    lru_.next = &connection;
+}
+
+////
+// @brief take a connection out of the list of open connections
+void Reactor::unlink(connection_t &connection)
+{
+    connection.prev->next = connection.next;
+    connection.next->prev = connection.prev;
+    connection.prev = nullptr;
+    connection.next = nullptr;
+}
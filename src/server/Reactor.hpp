@@ -0,0 +1,153 @@
+// Reactor.hpp
+//
+// Event loop that accepts and reads a shard
+// of the server's connections.
+//
+// 17 October 2026
+
+#pragma once
+
+#include "BroadCaster.hpp"
+#include "MessageTrace.hpp"
+#include "Resolver.hpp"
+#include "RoomShard.hpp"
+#include "ServerConfig.hpp"
+
+#include <common/frame_reader.hpp>
+#include <common/mpsc_queue.hpp>
+#include <common/net_common.hpp>
+#include <common/utilities.hpp>
+#include <common/frame.hpp>
+#include <io_multiplexor/IoMultiplexor.hpp>
+#include <io_multiplexor/TimerWheel.hpp>
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+// Each reactor has its own listening socket, multiplexor and thread.
+// With several reactors the sockets share a port through SO_REUSEPORT
+// and the kernel spreads new connections across them. Clients accepted
+// by a reactor are written by that reactor's BroadCaster, and messages
+// it reads are handed to the BroadCaster of every shard. Messages to a
+// room go only to the RoomShard that owns it, and the reactor remembers
+// which rooms each of its clients joined so it can leave them all when
+// the client goes. A client may only send to rooms it is in.
+//
+// Clients are named by their numeric address as soon as they are
+// accepted. If there is a Resolver the host name is looked up in the
+// background and handed back to the reactor, which passes it on to the
+// BroadCaster if the connection is still the one it was looked up for.
+//
+// Open connections are kept in an intrusive list, most recently active
+// first, and a frame from a client moves it to the front. Once a shard
+// has max_conn connections each new one evicts the least recently
+// active, so descriptors and memory stay bounded under a flood.
+//
+// With an idle timeout every connection has a timer that is restarted
+// whenever it expires after the client has been active. A client that
+// was silent for a whole timeout is sent a ping, and one that has not
+// answered by the ping timeout is disconnected. TCP keepalive set on the
+// listening socket catches peers that vanished without a word.
+//
+// A sampled fraction of reads is traced. The first message decoded
+// from a traced read that is not to a room carries the time it was
+// read, and the time it was decoded, to the BroadCasters, which record
+// how long it waited and how long it took to fan out.
+//
+// On a completion multiplexor connections are accepted by a multishot
+// accept and read by a multishot recv into the multiplexor's buffers,
+// so neither costs a system call per readiness event.
+class Reactor final {
+public:
+    Reactor(const server_config_t &config, size_t shard,
+            const std::vector<BroadCaster *> &broadcasters, Resolver *resolver,
+            const std::vector<RoomShard *> &room_shards = {});
+    ~Reactor();
+
+    void stop();
+
+    Reactor(const Reactor &rhs) = delete;
+    Reactor(Reactor &&rhs) = delete;
+    Reactor& operator=(const Reactor &rhs) = delete;
+
+private:
+    struct lru_node_t {
+        lru_node_t *prev = nullptr;
+        lru_node_t *next = nullptr;     // null while not in the list
+    };
+
+    // registered with the multiplexor as the data for its socket
+    struct connection_t: lru_node_t {
+        int fd;
+        uint64_t id;                    // unique for the life of the server
+        bool open;                      // false once dropped
+        bool active;                    // sent a frame since the timer started
+        bool pinged;                    // waiting for a pong
+        mplex_timer_t idle_timer;       // data is the connection
+        FrameReader reader;
+        char peer[ADDRESS_MAX_SIZE];    // numeric host:port of the client
+        std::vector<std::string> rooms; // rooms joined
+    };
+
+    struct resolved_host_t {
+        int client_fd;
+        std::string peer;               // connection the lookup was for
+        std::string host;
+    };
+
+    void handle_clients();
+    void handle_resolved();
+    void accept_clients();
+    void handle_accepted(const io_mplex_event_t &event);
+    void add_client(int client_fd, struct sockaddr_storage &client_addr);
+    void read_client(connection_t &connection);
+    void handle_received(connection_t &connection, const io_mplex_event_t &event);
+    void dispatch_message(connection_t &connection, message_t &&message);
+    void handle_room_request(connection_t &connection, const message_t &message);
+    void send_room_list(connection_t &connection);
+    RoomShard &room_shard(std::string_view room);
+    void handle_idle(connection_t &connection);
+    void drop_client(int client_fd);
+    void evict_client();
+    void touch(connection_t &connection);
+    void unlink(connection_t &connection);
+
+    std::string address_;
+    std::string port_;
+    int server_socket_;
+    unsigned int max_conn_;
+    std::atomic<bool> is_running_;
+    bool completions_;                          // accept and recv through the multiplexor
+    uint64_t idle_timeout_ms_;                  // 0 if idle clients are kept
+    uint64_t ping_timeout_ms_;
+    frame_ptr_t ping_;                          // encoded once, sent to idle clients
+    frame_ptr_t pong_;                          // encoded once, answers pings
+    TraceSampler sampler_;
+    uint64_t trace_received_ns_;                // read being traced, 0 if none
+
+    BroadCaster &broadcaster_;                  // writes this shard's clients
+    std::vector<BroadCaster *> broadcasters_;   // every shard, including this one
+    std::vector<RoomShard *> room_shards_;      // owners of the rooms, may be empty
+    Resolver *resolver_;                        // may be null
+    std::unique_ptr<IoMultiplexor> io_mplex_;
+    std::unique_ptr<io_mplex_event_t []> events_;  // filled by each wait
+    Channel stop_channel_;
+    EventNotifier resolved_notifier_;
+    MpscQueue<resolved_host_t> resolved_;       // filled by resolver threads
+    // nodes never move, so a connection can be the multiplexor data
+    std::unordered_map<int, connection_t> connections_;
+    lru_node_t lru_;                            // sentinel of the open connections
+    unsigned int n_open_;                       // connections in the list
+    // dropped during the current batch of events, which may still
+    // refer to them
+    std::vector<int> dropped_;
+    // dropped connections whose descriptor was reused in this batch
+    std::vector<decltype(connections_)::node_type> replaced_;
+    std::thread handler_;
+};
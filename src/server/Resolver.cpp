@@ -0,0 +1,145 @@
+// Resolver.cpp
+//
+// Implementation of the background pool
+// resolving client host names.
+//
+// 17 October 2026
+
+#include "Resolver.hpp"
+
+#include <common/log_util.hpp>
+#include <common/net_common.hpp>
+
+#include <netdb.h>
+#include <netinet/in.h>
+
+////
+// @brief start the resolver's worker threads
+//
+// @param[in]   n_threads   number of lookups that can run at once
+// @param[in]   cache_size  number of results remembered
+Resolver::Resolver(unsigned int n_threads, size_t cache_size):
+    running_(true),
+    cache_size_(cache_size)
+{
+    for (unsigned int i = 0; i < n_threads; i++) {
+        workers_.emplace_back(&Resolver::process_requests, this);
+    }
+}
+
+////
+// @brief stop the workers, requests that have not started are dropped
+Resolver::~Resolver()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        running_ = false;
+        requests_.clear();
+    }
+    wake_.notify_all();
+    for (auto &worker : workers_) {
+        worker.join();
+    }
+}
+
+////
+// @brief look up the host name of addr in the background
+//
+// @param[in]   addr    address of the peer
+// @param[in]   done    called with the host name if one is found
+//
+// @return true if the lookup was answered from the cache or queued
+//         false if the address is unknown or the queue is full
+//
+// @note done is called on the calling thread when the answer is
+//       cached and on a worker thread otherwise
+bool Resolver::resolve(const struct sockaddr_storage &addr, callback_t done)
+{
+    char address[ADDRESS_MAX_SIZE];
+    if (format_address(&addr, address, sizeof(address), false) == -1) {
+        return false;
+    }
+
+    std::string host;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!find_cached(address, host)) {
+            if (requests_.size() >= RESOLVER_QUEUE_SIZE) {
+                return false;
+            }
+            requests_.push_back({addr, address, std::move(done)});
+            wake_.notify_one();
+            return true;
+        }
+    }
+    if (!host.empty()) {
+        done(host);
+    }
+    return true;
+}
+
+void Resolver::process_requests()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (running_) {
+        if (requests_.empty()) {
+            wake_.wait(lock);
+            continue;
+        }
+        request_t request = std::move(requests_.front());
+        requests_.pop_front();
+
+        // an earlier request may have resolved the same address
+        std::string host;
+        if (!find_cached(request.address, host)) {
+            lock.unlock();
+            socklen_t addrlen = request.addr.ss_family == AF_INET6 ?
+                                    sizeof(struct sockaddr_in6) : sizeof(struct sockaddr_in);
+            char name[NI_MAXHOST];
+            int rc = getnameinfo(reinterpret_cast<struct sockaddr *>(&request.addr), addrlen,
+                                 name, sizeof(name), nullptr, 0, NI_NAMEREQD);
+            if (rc == 0) {
+                host = name;
+            } else {
+                log(LogPriority::DEBUG, "No host name for %s: %s\n",
+                        request.address.c_str(), gai_strerror(rc));
+            }
+            lock.lock();
+            add_cached(request.address, host);
+        }
+
+        if (!host.empty()) {
+            lock.unlock();
+            request.done(host);
+            lock.lock();
+        }
+    }
+}
+
+// find a cached host name and mark it as recently used, mutex_ held
+//
+// @return true if address is cached, host is empty if it has no name
+bool Resolver::find_cached(const std::string &address, std::string &host)
+{
+    auto entry = cache_.find(address);
+    if (entry == cache_.end()) {
+        return false;
+    }
+    lru_.splice(lru_.begin(), lru_, entry->second);
+    host = entry->second->second;
+    return true;
+}
+
+// cache a result, evicting the least recently used one, mutex_ held
+void Resolver::add_cached(const std::string &address, const std::string &host)
+{
+    if (cache_size_ == 0 || cache_.count(address) != 0) {
+        return;
+    }
+    if (cache_.size() >= cache_size_) {
+        cache_.erase(lru_.back().first);
+        lru_.pop_back();
+    }
+    lru_.emplace_front(address, host);
+    cache_.emplace(address, lru_.begin());
+}
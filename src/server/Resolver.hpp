@@ -0,0 +1,69 @@
+// Resolver.hpp
+//
+// Background pool for resolving the host
+// names of clients.
+//
+// 17 October 2026
+
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <list>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <sys/socket.h>
+
+// Host names remembered, most recently used first
+constexpr size_t RESOLVER_CACHE_SIZE = 1024;
+
+// Lookups that can be waiting before new ones are dropped
+constexpr size_t RESOLVER_QUEUE_SIZE = 4096;
+
+// Reverse lookups can block for seconds, so they never run on an event
+// loop. Requests are handed to a few worker threads and results,
+// including failures, are kept in an LRU cache keyed by the numeric
+// address. Host names are optional so requests are dropped rather than
+// queued without bound when the resolver falls behind.
+class Resolver final {
+public:
+    // called with the host name once it is known
+    using callback_t = std::function<void(const std::string &host)>;
+
+    Resolver(unsigned int n_threads, size_t cache_size);
+    ~Resolver();
+
+    Resolver(const Resolver &rhs) = delete;
+    Resolver(Resolver &&rhs) = delete;
+    Resolver& operator=(const Resolver &rhs) = delete;
+
+    bool resolve(const struct sockaddr_storage &addr, callback_t done);
+
+private:
+    struct request_t {
+        struct sockaddr_storage addr;
+        std::string address;    // numeric address, the cache key
+        callback_t done;
+    };
+    using lru_list_t = std::list<std::pair<std::string, std::string>>;
+
+    void process_requests();
+    bool find_cached(const std::string &address, std::string &host);
+    void add_cached(const std::string &address, const std::string &host);
+
+    std::mutex mutex_;                  // guards everything below
+    std::condition_variable wake_;
+    bool running_;
+    std::deque<request_t> requests_;
+    size_t cache_size_;
+    lru_list_t lru_;                    // address and host, most recent first
+    std::unordered_map<std::string, lru_list_t::iterator> cache_;
+    std::vector<std::thread> workers_;
+};
@@ -0,0 +1,82 @@
+// RoomRegistry.cpp
+//
+// Implementation of the rooms owned
+// by a RoomShard.
+//
+// 17 October 2026
+
+#include "RoomRegistry.hpp"
+
+#include <algorithm>
+
+////
+// @brief add a member to a room, creating the room if it is new
+//
+// @param[in]   member  client joining the room
+// @param[in]   room    name of the room, including ROOM_PREFIX
+//
+// @return true if the client joined
+//         false if it is already a member or the name is not a room
+bool RoomRegistry::join(const room_member_t &member, std::string_view room)
+{
+    if (!is_room(room)) {
+        return false;
+    }
+    auto entry = rooms_.find(room);
+    if (entry == rooms_.end()) {
+        auto interned = strings_.intern(room);
+        if (interned.data() == nullptr) {
+            return false;
+        }
+        entry = rooms_.emplace(interned, members_t()).first;
+    }
+    auto &members = entry->second;
+    auto same = [&member](const room_member_t &other) { return other.id == member.id; };
+    if (std::find_if(members.begin(), members.end(), same) != members.end()) {
+        return false;
+    }
+    members.push_back(member);
+    return true;
+}
+
+////
+// @brief remove a member from a room, deleting the room once it is empty
+//
+// @param[in]   member_id   id of the client leaving the room
+// @param[in]   room        name of the room
+//
+// @return true if the client was a member
+bool RoomRegistry::leave(uint64_t member_id, std::string_view room)
+{
+    auto entry = rooms_.find(room);
+    if (entry == rooms_.end()) {
+        return false;
+    }
+    auto &members = entry->second;
+    auto same = [member_id](const room_member_t &other) { return other.id == member_id; };
+    auto member = std::find_if(members.begin(), members.end(), same);
+    if (member == members.end()) {
+        return false;
+    }
+    // order does not matter, so the last member fills the gap
+    *member = members.back();
+    members.pop_back();
+    if (members.empty()) {
+        auto interned = entry->first;
+        rooms_.erase(entry);
+        strings_.release(interned);
+    }
+    return true;
+}
+
+////
+// @brief find the members of a room
+//
+// @param[in]   room    name of the room
+//
+// @return the members, or nullptr if the room has none
+const RoomRegistry::members_t *RoomRegistry::members(std::string_view room) const
+{
+    auto entry = rooms_.find(room);
+    return entry == rooms_.end() ? nullptr : &entry->second;
+}
@@ -0,0 +1,66 @@
+// RoomRegistry.hpp
+//
+// Named rooms and their members for
+// fan-out by a RoomShard.
+//
+// 17 October 2026
+
+#pragma once
+
+#include "StringTable.hpp"
+
+#include <common/protocol.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+class BroadCaster;
+
+// Rooms a single client may be in at once
+constexpr size_t ROOM_MAX_JOINED = 16;
+
+// A member is named by its connection and the id the reactor gave it, so
+// that a descriptor reused by a later client is never mistaken for it
+struct room_member_t {
+    int fd;
+    uint64_t id;
+    BroadCaster *home;      // writes the member's connection
+};
+
+////
+// @brief check whether a target names a room
+inline bool is_room(std::string_view target)
+{
+    return target.size() > 1 && target.front() == ROOM_PREFIX;
+}
+
+// Each room keeps its members in a contiguous vector so that publishing
+// walks one array, costing O(members) however many clients and rooms
+// there are. A room exists while it has members and its name is interned
+// for as long as it exists.
+//
+// The registry belongs to a single RoomShard thread and is not locked.
+class RoomRegistry final {
+public:
+    using members_t = std::vector<room_member_t>;
+
+    RoomRegistry() = default;
+    ~RoomRegistry() = default;
+
+    RoomRegistry(const RoomRegistry &rhs) = delete;
+    RoomRegistry& operator=(const RoomRegistry &rhs) = delete;
+
+    bool join(const room_member_t &member, std::string_view room);
+    bool leave(uint64_t member_id, std::string_view room);
+    const members_t *members(std::string_view room) const;
+
+    size_t size() const { return rooms_.size(); }
+
+private:
+    // keys view the interned names
+    std::unordered_map<std::string_view, members_t> rooms_;
+    StringTable strings_;
+};
@@ -0,0 +1,174 @@
+// RoomShard.cpp
+//
+// Implementation of the worker owning
+// a share of the server's rooms.
+//
+// 17 October 2026
+
+#include "RoomShard.hpp"
+#include "BroadCaster.hpp"
+
+#include <common/log_util.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <exception>
+#include <utility>
+
+#include <poll.h>
+#include <pthread.h>
+#include <sched.h>
+
+// Maximum number of events handled before the queue is checked again
+constexpr size_t ROOM_SHARD_BATCH_SIZE = 1024;
+
+////
+// @brief create a RoomShard and start its processing thread
+//
+// @param[in]   cpu     core to pin the thread to, or ROOM_SHARD_NO_CPU
+//
+// @throws std::runtime_error if the notifier cannot be set up
+RoomShard::RoomShard(int cpu):
+    processing_(true),
+    sleeping_(false),
+    event_queue_(ROOM_SHARD_QUEUE_SIZE)
+{
+    process_ = std::thread(&RoomShard::process_events, std::ref(*this));
+    if (cpu != ROOM_SHARD_NO_CPU) {
+        pin(cpu);
+    }
+}
+
+RoomShard::~RoomShard()
+{
+    processing_ = false;
+    if (notifier_.notify() != 0) {
+        log(LogPriority::ERROR, "Failed to stop room shard -- aborting\n");
+        std::abort();
+    }
+    process_.join();
+}
+
+////
+// @brief keep the processing thread on one core
+//
+// @param[in]   cpu     core to run on
+//
+// @note failing to pin is not fatal, the thread just runs anywhere
+void RoomShard::pin(int cpu)
+{
+#if __linux__
+    cpu_set_t cpus;
+    CPU_ZERO(&cpus);
+    CPU_SET(cpu, &cpus);
+    int rc = pthread_setaffinity_np(process_.native_handle(), sizeof(cpus), &cpus);
+    if (rc) {
+        log(LogPriority::WARNING, "Unable to pin room shard to cpu %d: %s\n", cpu, strerror(rc));
+    }
+#else
+    (void)cpu;
+#endif
+}
+
+////
+// @brief add an event carrying a copy of a room name
+//
+// @param[in]   type    JOIN or LEAVE
+// @param[in]   member  client joining or leaving
+// @param[in]   room    name to copy, truncated to fit the event
+void RoomShard::add_named_event(RoomEventType type, const room_member_t &member, std::string_view room)
+{
+    room_event_t event{type, member, {}, {}};
+    size_t len = std::min(room.size(), sizeof(event.room) - 1);
+    memcpy(event.room, room.data(), len);
+    event.room[len] = '\0';
+    add_event(std::move(event));
+}
+
+////
+// @brief add an event to the RoomShard
+//
+// @note producers never take a lock. The processing thread is only
+//       notified when it has parked because the queue was empty.
+void RoomShard::add_event(room_event_t &&event)
+{
+    while (!event_queue_.try_push(std::move(event))) {
+        // queue is full -- let the processing thread catch up
+        std::this_thread::yield();
+    }
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (sleeping_.load(std::memory_order_relaxed) && sleeping_.exchange(false)) {
+        if (notifier_.notify() != 0) {
+            log(LogPriority::ERROR, "Failed to wake room shard\n");
+        }
+    }
+}
+
+////
+// @brief process events enqueued by the reactors
+//
+// @note the thread only parks on the notifier once the queue is empty
+void RoomShard::process_events()
+{
+    while (processing_) {
+        room_event_t event;
+        size_t handled = 0;
+        while (handled < ROOM_SHARD_BATCH_SIZE && event_queue_.try_pop(event)) {
+            handle_event(event);
+            handled++;
+        }
+        if (handled > 0) {
+            continue;
+        }
+
+        // announce that we are parking and then check the queue
+        // once more so that a concurrent producer is never missed
+        sleeping_.store(true, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (!event_queue_.empty()) {
+            sleeping_.store(false, std::memory_order_relaxed);
+            continue;
+        }
+        struct pollfd wake{notifier_.get_fd(), POLLIN, 0};
+        if (poll(&wake, 1, -1) == -1 && errno != EINTR) {
+            log(LogPriority::ERROR, "room shard poll error: %s\n", strerror(errno));
+        }
+        sleeping_.store(false, std::memory_order_relaxed);
+        notifier_.drain();
+    }
+    log(LogPriority::INFO, "Shutting down room shard -- rooms: %lu\n", rooms_.size());
+}
+
+////
+// @brief handle a single event from the queue
+//
+// @param[in]   event   event to handle
+void RoomShard::handle_event(const room_event_t &event)
+{
+    switch (event.type) {
+        case RoomEventType::JOIN:
+            if (!rooms_.join(event.member, event.room)) {
+                log(LogPriority::INFO, "Client %d unable to join %s\n", event.member.fd, event.room);
+            }
+            break;
+        case RoomEventType::LEAVE:
+            rooms_.leave(event.member.id, event.room);
+            break;
+        case RoomEventType::PUBLISH:
+        {
+            auto members = rooms_.members(event.frame->target());
+            if (members == nullptr) {
+                break;
+            }
+            for (const auto &member : *members) {
+                if (member.id != event.member.id) {
+                    member.home->send_frame(member.fd, member.id, event.frame);
+                }
+            }
+        }
+        break;
+        default:
+            log(LogPriority::ERROR, "Unknown room event type %d\n", static_cast<int>(event.type));
+            std::abort();
+    }
+}
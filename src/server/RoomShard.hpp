@@ -0,0 +1,119 @@
+// RoomShard.hpp
+//
+// Worker owning a share of the server's rooms
+// and fanning their messages out to members.
+//
+// 17 October 2026
+
+#pragma once
+
+#include "RoomRegistry.hpp"
+#include "StringTable.hpp"
+
+#include <common/frame.hpp>
+#include <common/mpsc_queue.hpp>
+#include <common/utilities.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+enum class RoomEventType : int {
+    JOIN,
+    LEAVE,
+    PUBLISH,
+};
+
+// Events that can be waiting for a RoomShard before producers
+// have to wait for it to catch up
+constexpr size_t ROOM_SHARD_QUEUE_SIZE = 16 * 1024;
+
+// Passed as the cpu of a RoomShard whose thread may run anywhere
+constexpr int ROOM_SHARD_NO_CPU = -1;
+
+struct room_event_t {
+    RoomEventType type;
+    room_member_t member;               // JOIN and LEAVE, the sender for PUBLISH
+    frame_ptr_t frame;                  // PUBLISH, its target is the room
+    char room[CLIENT_NAME_MAX_SIZE];    // JOIN and LEAVE
+};
+
+// Rooms are hashed across the server's RoomShards by name, so every
+// message to a room goes through the one queue and thread that owns it
+// and is delivered to all of its members in the order it was published.
+// Rooms on different shards never share a lock, a queue or a thread.
+//
+// A shard does not write to sockets itself. Each member's frame is
+// handed to the BroadCaster that writes its connection, which checks
+// the member's id so that a client that has since gone never receives
+// it on a reused descriptor.
+class RoomShard final {
+public:
+    RoomShard(int cpu);
+    ~RoomShard();
+
+    RoomShard(const RoomShard &rhs) = delete;
+    RoomShard(RoomShard &&rhs) = delete;
+    RoomShard& operator=(const RoomShard &rhs) = delete;
+
+    ////
+    // @brief pick the shard that owns a room
+    //
+    // @param[in]   room        name of the room
+    // @param[in]   n_shards    number of RoomShards
+    //
+    // @return index of the owning shard
+    static size_t shard_of(std::string_view room, size_t n_shards)
+    {
+        return std::hash<std::string_view>()(room) % n_shards;
+    }
+
+    ////
+    // @brief add a client to a room
+    //
+    // @param[in]   member  client joining the room
+    // @param[in]   room    name of the room, copied by the call
+    void join(const room_member_t &member, std::string_view room)
+    {
+        add_named_event(RoomEventType::JOIN, member, room);
+    }
+
+    ////
+    // @brief remove a client from a room
+    //
+    // @param[in]   member  client leaving the room
+    // @param[in]   room    name of the room, copied by the call
+    void leave(const room_member_t &member, std::string_view room)
+    {
+        add_named_event(RoomEventType::LEAVE, member, room);
+    }
+
+    ////
+    // @brief send an encoded message to every member of the room it
+    //        targets, other than its sender
+    //
+    // @param[in]   sender  client that sent the message
+    // @param[in]   frame   encoded message, its target is the room
+    void publish(const room_member_t &sender, const frame_ptr_t &frame)
+    {
+        add_event({RoomEventType::PUBLISH, sender, frame, {}});
+    }
+
+private:
+    void process_events();
+    void handle_event(const room_event_t &event);
+    void pin(int cpu);
+
+    void add_named_event(RoomEventType type, const room_member_t &member, std::string_view room);
+    void add_event(room_event_t &&event);
+
+    std::atomic<bool> processing_;
+    std::atomic<bool> sleeping_;    // parked waiting on the notifier
+    EventNotifier notifier_;
+    MpscQueue<room_event_t> event_queue_;
+    RoomRegistry rooms_;
+    std::thread process_;
+};
@@ -8,121 +8,59 @@
 #include "Server.hpp"
 
 #include <common/log_util.hpp>
-#include <common/net_common.hpp>
-#include <common/utilities.hpp>
-#include <io_multiplexor/IoMultiplexorFactory.hpp>
 
+#include <algorithm>
 #include <exception>
 #include <thread>
 
-#include <sys/socket.h>
-#include <netinet/in.h>
-#include <arpa/inet.h>
-#include <netdb.h>
-#include <unistd.h>
+////
+// @brief start a BroadCaster and Reactor for each shard and the
+//        RoomShards
+//
+// @param[in]   config  server configuration
+//
+// @throws std::runtime_error if any shard cannot be set up
+Server::Server(const server_config_t &config)
+{
+    if (config.n_threads == 0) {
+        throw std::runtime_error("Server needs at least one thread\n");
+    }
 
-Server::Server(std::string address, std::string port, unsigned int max_conn):
-        address_(address),
-        port_(port),
-        server_socket_(-1),
-        max_conn_(max_conn),
-        is_running_(false)
-{ 
-    server_socket_ = bind_socket(address_.c_str(), port_.c_str(), false);
-    if (server_socket_ == -1) {
-        throw std::runtime_error("Unable to bind socket\n");
+    std::vector<BroadCaster *> shards;
+    for (unsigned int i = 0; i < config.n_threads; i++) {
+        broadcasters_.push_back(std::make_unique<BroadCaster>(config.out_buffer_size,
+                                                              config.slow_consumer_policy,
+                                                              config.io_backend));
+        shards.push_back(broadcasters_.back().get());
     }
-    
-    int rc = listen_socket(server_socket_, 20);
-    if (rc) {
-        throw std::runtime_error("Unable to mark socket for listening\n");
+
+    unsigned int n_room_shards = config.room_shards == 0 ? config.n_threads : config.room_shards;
+    unsigned int n_cpus = std::max(1u, std::thread::hardware_concurrency());
+    std::vector<RoomShard *> room_shards;
+    for (unsigned int i = 0; i < n_room_shards; i++) {
+        room_shards_.push_back(std::make_unique<RoomShard>(i % n_cpus));
+        room_shards.push_back(room_shards_.back().get());
     }
-    
-    // Two additional entries can be returned -- the listening socket
-    // and the stop channel used for shutdown
-    io_mplex_ = IoMultiplexorFactory::get_multiplexor(max_conn_ + 2);
-    if (io_mplex_ == nullptr) {
-        throw std::runtime_error("Unable to allocate multiplexor\n");
+    if (config.resolver_threads > 0) {
+        resolver_ = std::make_unique<Resolver>(config.resolver_threads, RESOLVER_CACHE_SIZE);
     }
-    
-    rc = io_mplex_->add({0, MPLEX_IN, server_socket_});
-    if (rc != 0) {
-        throw std::runtime_error("Unable to setup listening socket\n");
+    for (size_t shard = 0; shard < shards.size(); shard++) {
+        reactors_.push_back(std::make_unique<Reactor>(config, shard, shards, resolver_.get(), room_shards));
     }
-
-    rc = io_mplex_->add({0, MPLEX_IN, stop_channel_.get_read_end()});
-    if (rc != 0) {
-        throw std::runtime_error("Unable to setup pipe\n");
+    if (!config.admin_socket.empty()) {
+        admin_ = std::make_unique<AdminServer>(config.admin_socket, MetricsRegistry::instance());
     }
-   
-    is_running_ = true;
-    handler_ = std::thread(&Server::handle_clients, std::ref(*this));
 }
 
 Server::~Server()
 {
-    is_running_ = false;
     log(LogPriority::INFO, "Shutting down server\n");
-    if (stop_channel_.write("0") != 1) {
-        log(LogPriority::ERROR, "Failed to stop server -- aborting\n");
-        std::abort(); 
-    }
-    handler_.join();
-}
-
-void Server::handle_clients()
-{
-    log(LogPriority::INFO, "Now handling clients at %s:%s\n", address_.c_str(), port_.c_str()); 
-    std::vector<io_mplex_fd_info_t> events;
-    while (is_running_) {
-        int n_events = io_mplex_->wait(nullptr, events);
-        if (n_events == -1) {
-            log(LogPriority::ERROR, "io_mplex wait error: %s\n", strerror(errno));
-            continue;
-        }
-        for (const auto &event : events) {
-            if (event.fd == server_socket_) {
-                struct sockaddr_storage client_addr;
-                socklen_t addrlen = sizeof(client_addr);
-                
-                memzero(&client_addr, sizeof(client_addr));
-                int client_fd = accept(event.fd, (struct sockaddr *)&client_addr, &addrlen); 
-                if (client_fd == -1) {
-                    log(LogPriority::ERROR, "accept error: %s\n", strerror(errno));
-                    continue;
-                }
-                auto hostinfo = get_hostname(&client_addr, sizeof(client_addr), NI_NUMERICHOST);
-                if (hostinfo.second == false) {
-                    log(LogPriority::ERROR, "get_hostname error\n");
-                    int err_rc = terminate_connection(client_fd, SHUT_WR);
-                    if (err_rc) {
-                        log(LogPriority::ERROR, "failed to terminate socket\n");
-                    }
-                    continue;
-                }
-                log(LogPriority::INFO, "received connection from %s\n", hostinfo.first.c_str());
-                broadcaster_.add_client(hostinfo.first.c_str(), client_fd);
-                
-                int rc = io_mplex_->add({0, MPLEX_IN | MPLEX_EOF, client_fd});
-                if (rc) {
-                    log(LogPriority::ERROR, "unable to add client (%s) to multiplexor", hostinfo.first.c_str());
-                    int err_rc = terminate_connection(client_fd, SHUT_WR);
-                    if (err_rc) {
-                        log(LogPriority::ERROR, "failed to terminate socket\n");
-                    }
-                } 
-            } else if (event.fd == stop_channel_.get_read_end()) {
-                log(LogPriority::INFO, "received shutdown\n");
-                break;
-            } else {
-                if (event.filters & MPLEX_IN) {
-                                        
-                } else if (event.filters & (MPLEX_EOF | MPLEX_ERR)) {
-                    // remove client and terminate connection
-                    broadcaster_.del_client(event.fd);
-                }
-            }
-        }
-        events.clear();
+    admin_.reset();
+    // the resolver hands results to the reactors so it is stopped
+    // after their event loops and before they are destroyed
+    for (auto &reactor : reactors_) {
+        reactor->stop();
     }
+    resolver_.reset();
+    reactors_.clear();
 }
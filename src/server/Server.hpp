@@ -5,36 +5,41 @@
 //
 // 22-April-2021
 
-#include "BroadCaster.hpp"
+#pragma once
 
-#include <common/utilities.hpp>
-#include <io_multiplexor/IoMultiplexor.hpp>
+#include "AdminServer.hpp"
+#include "BroadCaster.hpp"
+#include "Reactor.hpp"
+#include "Resolver.hpp"
+#include "RoomShard.hpp"
+#include "ServerConfig.hpp"
 
-#include <string>
 #include <memory>
-#include <thread>
-#include <atomic>
+#include <vector>
 
+// The server is split into n_threads shards. Each shard has a Reactor
+// that accepts and reads its connections and a BroadCaster that writes
+// to them. Messages are encoded once and handed to every shard's
+// BroadCaster. Rooms are spread over room_shards RoomShards, each pinned
+// to its own core, which hand room messages to the BroadCasters of the
+// members. Host names are resolved by a Resolver shared by all shards
+// when resolver_threads is not zero. With an admin socket the metrics
+// of every part of the server are served on it.
 class Server final {
 public:
-    Server(std::string address, std::string port, unsigned int max_conn);
+    Server(const server_config_t &config);
     ~Server();
     Server(const Server &rhs) = delete;
     Server(Server &&rhs) = delete;
     Server& operator()(const Server &rhs) = delete;
 
 private:
-    std::string address_;
-    std::string port_;
-    std::thread handler_;
-
-    int server_socket_;
-    unsigned int max_conn_;
-    std::atomic<bool> is_running_;
-    
-    std::unique_ptr<IoMultiplexor> io_mplex_;
-    BroadCaster broadcaster_;
-    Channel stop_channel_;
-
-    void handle_clients();
+    // reactors are declared last so that they are stopped before the
+    // room shards and broadcasters they hand messages to, and room
+    // shards are stopped before the broadcasters
+    std::vector<std::unique_ptr<BroadCaster>> broadcasters_;
+    std::vector<std::unique_ptr<RoomShard>> room_shards_;
+    std::unique_ptr<Resolver> resolver_;
+    std::vector<std::unique_ptr<Reactor>> reactors_;
+    std::unique_ptr<AdminServer> admin_;
 };
@@ -0,0 +1,53 @@
+// ServerConfig.hpp
+//
+// Settings shared by the server and
+// its reactors.
+//
+// 17 October 2026
+
+#pragma once
+
+#include "BroadCaster.hpp"
+#include "MessageTrace.hpp"
+
+#include <io_multiplexor/IoMultiplexor.hpp>
+
+#include <cstdint>
+#include <string>
+
+#include <sys/socket.h>
+
+// Connections the kernel may hold for each listening socket before
+// they are accepted. Reconnect storms need far more than a handful.
+constexpr int DEFAULT_LISTEN_BACKLOG = SOMAXCONN;
+
+// Connections each reactor keeps before it evicts the least recently
+// active one
+constexpr unsigned int DEFAULT_MAX_CONN = 1024;
+
+// A client that sends nothing for the idle timeout is pinged and is
+// disconnected if it is still silent after the ping timeout. The idle
+// timeout is off unless it is configured.
+constexpr uint64_t DEFAULT_PING_TIMEOUT_MS = 10 * 1000;
+
+// Seconds a connection may be silent before the kernel starts probing
+// it with TCP keepalives, 0 to leave keepalive off
+constexpr int DEFAULT_KEEPALIVE_S = 60;
+
+struct server_config_t {
+    std::string address;
+    std::string port;
+    unsigned int max_conn;                      // connections kept by each thread
+    size_t out_buffer_size;                     // bytes queued per client
+    SlowConsumerPolicy slow_consumer_policy;
+    unsigned int n_threads;                     // number of reactors
+    int backlog;                                // listen backlog of each reactor
+    unsigned int resolver_threads;              // host name lookups, 0 to disable
+    MplexBackend io_backend;                    // multiplexor for reactors and broadcasters
+    uint64_t idle_timeout_ms = 0;               // silence before a ping, 0 to disable
+    uint64_t ping_timeout_ms = DEFAULT_PING_TIMEOUT_MS;
+    int keepalive_s = DEFAULT_KEEPALIVE_S;      // TCP keepalive idle time, 0 to disable
+    unsigned int room_shards = 0;               // room owning threads, 0 for one per reactor
+    std::string admin_socket{};                 // path serving metrics, empty to disable
+    double trace_sample = DEFAULT_TRACE_SAMPLE; // fraction of reads traced, 0 to disable
+};
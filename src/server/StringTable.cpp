@@ -0,0 +1,97 @@
+// StringTable.cpp
+//
+// Implementation of the table of interned
+// client names.
+//
+// 17 October 2026
+
+#include "StringTable.hpp"
+
+#include <cstring>
+
+static_assert(CLIENT_NAME_MAX_SIZE % 16 == 0, "names must fill whole slots");
+
+// size of the slot holding a string of len bytes and its null
+static inline size_t slot_size(size_t len)
+{
+    return (len + 1 + 15) & ~static_cast<size_t>(15);
+}
+
+StringTable::StringTable():
+    chunk_used_(CHUNK_SIZE)
+{
+}
+
+////
+// @brief take a reference to a copy of str owned by the table
+//
+// @param[in]   str     string to intern
+//
+// @return view of the interned, null terminated copy
+//         an empty view with a null data() if str is too long
+std::string_view StringTable::intern(std::string_view str)
+{
+    if (str.size() >= CLIENT_NAME_MAX_SIZE) {
+        return {};
+    }
+
+    auto entry = strings_.find(str);
+    if (entry != strings_.end()) {
+        entry->second++;
+        return entry->first;
+    }
+
+    char *slot = allocate(slot_size(str.size()));
+    memcpy(slot, str.data(), str.size());
+    slot[str.size()] = '\0';
+
+    std::string_view interned(slot, str.size());
+    strings_.emplace(interned, 1);
+    return interned;
+}
+
+////
+// @brief drop a reference taken by intern
+//
+// @param[in]   str     view returned by intern
+//
+// @return true if str was interned
+//
+// @note the string's slot is reused once its last reference is dropped
+bool StringTable::release(std::string_view str)
+{
+    auto entry = strings_.find(str);
+    if (entry == strings_.end()) {
+        return false;
+    }
+    if (--entry->second == 0) {
+        char *slot = const_cast<char *>(entry->first.data());
+        size_t size = slot_size(entry->first.size());
+        strings_.erase(entry);
+        deallocate(slot, size);
+    }
+    return true;
+}
+
+char *StringTable::allocate(size_t slot_size)
+{
+    auto &free_list = free_[slot_size / SLOT_ALIGN - 1];
+    if (!free_list.empty()) {
+        char *slot = free_list.back();
+        free_list.pop_back();
+        return slot;
+    }
+
+    if (CHUNK_SIZE - chunk_used_ < slot_size) {
+        chunks_.emplace_back(new char[CHUNK_SIZE]);
+        chunk_used_ = 0;
+    }
+    char *slot = chunks_.back().get() + chunk_used_;
+    chunk_used_ += slot_size;
+    return slot;
+}
+
+void StringTable::deallocate(char *slot, size_t slot_size)
+{
+    free_[slot_size / SLOT_ALIGN - 1].push_back(slot);
+}
@@ -0,0 +1,55 @@
+// StringTable.hpp
+//
+// Interned, reference counted strings with stable
+// addresses for client names.
+//
+// 17 October 2026
+
+#pragma once
+
+#include <common/protocol.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// Longest name that can be stored including the terminating null. A
+// client is only reachable if its name fits in a message target.
+constexpr size_t CLIENT_NAME_MAX_SIZE = MSG_TARGET_MAX_SIZE;
+
+// Strings are copied into large arena chunks that are never moved or
+// freed until the table is destroyed, so a view returned by intern
+// stays valid until its last reference is released. Space is handed
+// out in a few size classes and freed slots are reused by the next
+// string of the same class, which keeps names packed together.
+class StringTable final {
+public:
+    StringTable();
+    ~StringTable() = default;
+
+    StringTable(const StringTable &rhs) = delete;
+    StringTable& operator=(const StringTable &rhs) = delete;
+
+    std::string_view intern(std::string_view str);
+    bool release(std::string_view str);
+
+    size_t size() const { return strings_.size(); }
+    size_t n_chunks() const { return chunks_.size(); }
+
+private:
+    static constexpr size_t SLOT_ALIGN = 16;
+    static constexpr size_t N_CLASSES = CLIENT_NAME_MAX_SIZE / SLOT_ALIGN;
+    static constexpr size_t CHUNK_SIZE = 4096;
+
+    char *allocate(size_t slot_size);
+    void deallocate(char *slot, size_t slot_size);
+
+    std::vector<std::unique_ptr<char []>> chunks_;
+    size_t chunk_used_;                     // bytes handed out from the last chunk
+    std::vector<char *> free_[N_CLASSES];   // released slots by size class
+    // views of the interned strings to their reference counts
+    std::unordered_map<std::string_view, uint32_t> strings_;
+};
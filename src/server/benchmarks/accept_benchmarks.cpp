@@ -0,0 +1,195 @@
+// Benchmarks for accepting connections
+//
+// A storm of clients connect at once, as they would when
+// reconnecting after a deploy. A connection only completes
+// once the kernel has room for it in the accept queue, so
+// a small backlog or a slow accept loop shows up as SYN
+// retries in the time it takes every client to connect.
+//
+// 17 October 2026
+
+#include "../Reactor.hpp"
+#include "../ServerConfig.hpp"
+
+#include <common/metrics.hpp>
+#include <common/net_common.hpp>
+#include <common/test_util.hpp>
+#include <io_multiplexor/IoMultiplexorFactory.hpp>
+
+#include <catch2/catch_all.hpp>
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <errno.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+const static int STORM_SIZE = 10000;
+
+struct storm_result_t {
+    int failed;             // connects that were refused or timed out
+};
+
+// start n_clients non-blocking connects and wait for all of them
+static storm_result_t connect_storm(const std::string &port, int n_clients)
+{
+    storm_result_t result{0};
+    struct sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(std::stoi(port));
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+    auto io_mplex = IoMultiplexorFactory::get_multiplexor(1024);
+    std::vector<int> clients;
+    std::vector<io_mplex_fd_info_t> events;
+    int pending = 0;
+
+    for (int i = 0; i < n_clients; i++) {
+        int sock_fd = socket(AF_INET, SOCK_STREAM, 0);
+        if (sock_fd == -1 || set_nonblocking(sock_fd)) {
+            result.failed++;
+            continue;
+        }
+        clients.push_back(sock_fd);
+        if (connect(sock_fd, reinterpret_cast<struct sockaddr *>(&addr), sizeof(addr)) == 0) {
+            continue;
+        }
+        if (errno != EINPROGRESS || io_mplex->add({0, MPLEX_OUT | MPLEX_ONESHOT, sock_fd})) {
+            result.failed++;
+            continue;
+        }
+        pending++;
+    }
+    while (pending > 0) {
+        int n_events = io_mplex->wait(nullptr, events);
+        if (n_events == -1) {
+            continue;
+        }
+        for (const auto &event : events) {
+            int err = 0;
+            socklen_t len = sizeof(err);
+            if (getsockopt(event.fd, SOL_SOCKET, SO_ERROR, &err, &len) || err != 0) {
+                result.failed++;
+            }
+            pending--;
+        }
+        events.clear();
+    }
+    for (int sock_fd : clients) {
+        close(sock_fd);
+    }
+    return result;
+}
+
+// process that runs the storms, so that they and the server each have
+// the whole descriptor limit
+struct storm_worker_t {
+    pid_t pid;
+    int request_fd;         // a byte written here starts a storm
+    int result_fd;          // and its storm_result_t is read from here
+};
+
+// fork a worker that runs a storm against port for every request. The
+// child of a threaded process may only make async-signal-safe calls, so
+// it must be started before any of the server's threads.
+static storm_worker_t start_storm_worker(const std::string &port)
+{
+    int requests[2];
+    int results[2];
+    REQUIRE(pipe(requests) == 0);
+    REQUIRE(pipe(results) == 0);
+    pid_t pid = fork();
+    REQUIRE(pid != -1);
+    if (pid == 0) {
+        close(requests[1]);
+        close(results[0]);
+        int rc = 0;
+        char request;
+        while (rc == 0 && read(requests[0], &request, 1) == 1) {
+            storm_result_t result = connect_storm(port, STORM_SIZE);
+            rc = write(results[1], &result, sizeof(result)) == sizeof(result) ? 0 : 1;
+        }
+        _exit(rc);
+    }
+    close(requests[0]);
+    close(results[1]);
+    return {pid, requests[1], results[0]};
+}
+
+// run a storm in the worker and wait for it to finish
+static storm_result_t run_storm(const storm_worker_t &worker)
+{
+    char request = 0;
+    REQUIRE(write(worker.request_fd, &request, 1) == 1);
+    storm_result_t result{0};
+    REQUIRE(read(worker.result_fd, &result, sizeof(result)) == sizeof(result));
+    return result;
+}
+
+// end the worker by closing its requests
+static void stop_storm_worker(const storm_worker_t &worker)
+{
+    close(worker.request_fd);
+    int status = 0;
+    REQUIRE(waitpid(worker.pid, &status, 0) == worker.pid);
+    close(worker.result_fd);
+    REQUIRE(WIFEXITED(status));
+    REQUIRE(WEXITSTATUS(status) == 0);
+}
+
+TEST_CASE("reactor connect storm", "[!benchmark][accept]") {
+    auto backlog = GENERATE(20, DEFAULT_LISTEN_BACKLOG);
+    auto port = free_port();
+    auto worker = start_storm_worker(port);
+
+    BroadCaster broadcaster;
+    std::vector<BroadCaster *> shards{&broadcaster};
+    // room for the whole storm so that nothing is evicted
+    server_config_t config{"127.0.0.1", port, STORM_SIZE, DEFAULT_OUT_BUFFER_SIZE,
+                           SlowConsumerPolicy::DROP_OLDEST, 1, backlog, 0, MplexBackend::NATIVE};
+    auto reactor = std::make_unique<Reactor>(config, 0, shards, nullptr);
+
+    // kept by the reactor as it accepts and drops clients
+    auto &registry = MetricsRegistry::instance();
+    auto &accepted = registry.counter("chat_connections_accepted_total", "Client connections accepted.");
+    auto &open = registry.gauge("chat_connections_open", "Client connections open.");
+    int64_t open_before = open.value();
+    uint64_t storms = 0;
+    uint64_t failed = 0;
+
+    // a run is one storm, which closes its clients once all are connected
+    auto storm = [&]() {
+        storm_result_t result = run_storm(worker);
+        storms++;
+        failed += result.failed;
+    };
+
+    BENCHMARK_ADVANCED(std::to_string(STORM_SIZE) + " connects with backlog " +
+                       std::to_string(backlog))(Catch::Benchmark::Chronometer meter) {
+        meter.measure(storm);
+    };
+    WARN(failed << " of " << storms * STORM_SIZE << " connects failed with backlog " << backlog);
+    stop_storm_worker(worker);
+
+    // the storms closed every client. Wait until the reactor
+    // has dropped all it accepted and finds no more on the accept queue,
+    // where a small backlog leaves connections it never accepts.
+    uint64_t last_accepted = UINT64_MAX;
+    for (int i = 0; i < 1000; i++) {
+        uint64_t now_accepted = accepted.value();
+        if (open.value() == open_before && now_accepted == last_accepted) {
+            break;
+        }
+        last_accepted = now_accepted;
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    REQUIRE(open.value() == open_before);
+    reactor.reset();
+}
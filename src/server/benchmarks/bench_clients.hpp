@@ -0,0 +1,54 @@
+// bench_clients.hpp
+//
+// Clients of a BroadCaster for its benchmarks. They write to
+// /dev/null, so only the broadcaster's work is measured, and
+// a sentinel written to a pipe tells when a run is done.
+//
+// 17 October 2026
+
+#pragma once
+
+#include "../BroadCaster.hpp"
+
+#include <common/frame.hpp>
+#include <common/net_common.hpp>
+#include <common/utilities.hpp>
+
+#include <catch2/catch_all.hpp>
+
+#include <cstdint>
+#include <string>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+// clients writing to /dev/null and a sentinel written to a pipe. The
+// broadcaster closes their descriptors, so it must go first.
+struct bench_clients_t {
+    Channel sentinel;
+    uint64_t sentinel_id;
+    frame_ptr_t done;
+};
+
+////
+// @brief add n_clients named client0.. on /dev/null and the sentinel
+inline void add_clients(BroadCaster &broadcaster, int n_clients, bench_clients_t &clients)
+{
+    for (int i = 0; i < n_clients; i++) {
+        int fd = open("/dev/null", O_WRONLY | O_CLOEXEC);
+        REQUIRE(fd != -1);
+        broadcaster.add_client("client" + std::to_string(i), fd, i + 1);
+    }
+    clients.sentinel_id = n_clients + 1;
+    broadcaster.add_client("sentinel", clients.sentinel.get_write_end(), clients.sentinel_id);
+    clients.done = make_frame(message_t{{4, 1, ""}, "done"});
+}
+
+////
+// @brief queue the sentinel's frame and wait until it is written
+inline void wait_written(BroadCaster &broadcaster, bench_clients_t &clients)
+{
+    broadcaster.send_frame(clients.sentinel.get_write_end(), clients.sentinel_id, clients.done);
+    message_t received_msg;
+    REQUIRE(read_message(clients.sentinel.get_read_end(), received_msg) == 0);
+}
@@ -0,0 +1,65 @@
+// Benchmarks for BroadCaster class
+//
+// Frames are queued from the benchmark thread and written by
+// the broadcaster's own thread to clients on /dev/null, so
+// only the broadcaster's work is measured. Each run ends with
+// a frame to a pipe that is read to know that everything
+// queued before it was written. A direct message should cost
+// the same and a broadcast the same per recipient however many
+// clients there are.
+//
+// 17 October 2026
+
+#include "bench_clients.hpp"
+
+#include <common/frame.hpp>
+
+#include <catch2/catch_all.hpp>
+
+#include <algorithm>
+#include <cstdio>
+#include <string>
+
+const static int EVENTS_PER_RUN = 1000;
+
+TEST_CASE("broadcaster direct message throughput", "[!benchmark][broadcaster]") {
+    auto n_clients = GENERATE(1, 10, 100, 1000, 10000, 100000);
+
+    // every client is a descriptor, leave some for the broadcaster
+    if (raise_fd_limit() < static_cast<size_t>(n_clients) + 64) {
+        WARN("not enough descriptors for " << n_clients << " clients");
+        return;
+    }
+
+    bench_clients_t clients;
+    BroadCaster broadcaster;
+    add_clients(broadcaster, n_clients, clients);
+    message_t message{{5, 1, ""}, "hello"};
+    snprintf(message.header.target, sizeof(message.header.target), "client%d", n_clients / 2);
+    auto frame = make_frame(message);
+
+    BENCHMARK(std::to_string(EVENTS_PER_RUN) + " direct messages with " + std::to_string(n_clients) + " clients") {
+        for (int i = 0; i < EVENTS_PER_RUN; i++) {
+            broadcaster.direct_frame(-1, frame);
+        }
+        wait_written(broadcaster, clients);
+    };
+}
+
+TEST_CASE("broadcaster fan-out by client count", "[!benchmark][broadcaster]") {
+    auto n_clients = GENERATE(1, 10, 100, 1000);
+    bench_clients_t clients;
+    BroadCaster broadcaster;
+    add_clients(broadcaster, n_clients, clients);
+    auto frame = make_frame(message_t{{5, 1, ""}, "hello"});
+
+    // sent by the sentinel, so only the other clients get a copy
+    int sender_fd = clients.sentinel.get_write_end();
+    int n_broadcasts = std::max(1, EVENTS_PER_RUN / n_clients);
+    BENCHMARK(std::to_string(n_broadcasts) + " x broadcast to " + std::to_string(n_clients) + " clients") {
+        for (int i = 0; i < n_broadcasts; i++) {
+            broadcaster.broadcast_frame(sender_fd, frame);
+        }
+        wait_written(broadcaster, clients);
+    };
+}
@@ -0,0 +1,42 @@
+// Benchmarks for ClientTable class
+//
+// Direct messages look up their recipient by name so the
+// cost of a lookup should not grow with the number of
+// connected clients.
+//
+// 17 October 2026
+
+#define CATCH_CONFIG_MAIN
+
+#include "../ClientTable.hpp"
+
+#include <catch2/catch_all.hpp>
+
+#include <string>
+#include <vector>
+
+const static size_t BENCH_BUFFER_SIZE = 1024;
+
+TEST_CASE("client table direct message lookup", "[!benchmark][client-table]") {
+    auto n_clients = GENERATE(10, 100, 1000, 10000, 100000);
+
+    // fake connections, nothing is written to them
+    ClientTable table(BENCH_BUFFER_SIZE);
+    std::vector<std::string> names;
+    names.reserve(n_clients);
+    for (int fd = 0; fd < n_clients; fd++) {
+        names.push_back("client" + std::to_string(fd));
+        REQUIRE(table.add(fd, names.back().c_str()) != nullptr);
+    }
+
+    // walk the clients so every lookup hits a different name
+    size_t next = 0;
+    BENCHMARK("find by name with " + std::to_string(n_clients) + " clients") {
+        next = (next + 7919) % names.size();
+        return table.find(names[next]);
+    };
+
+    BENCHMARK("miss by name with " + std::to_string(n_clients) + " clients") {
+        return table.find("nobody");
+    };
+}
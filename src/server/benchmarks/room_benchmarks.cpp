@@ -0,0 +1,124 @@
+// Benchmarks for room fan-out
+//
+// Many small, independent rooms are published to by one
+// producer per room shard. Each room shard hands its members'
+// frames to a BroadCaster of its own, so with enough cores
+// the aggregate rate should grow close to linearly with the
+// number of shards. Every shard publishes the same number of
+// messages in a run, so a run should take about as long with
+// any number of shards. Members write to /dev/null so only
+// the server's own work is measured.
+//
+// 17 October 2026
+
+#include "../BroadCaster.hpp"
+#include "../RoomShard.hpp"
+
+#include <common/net_common.hpp>
+#include <common/utilities.hpp>
+
+#include <catch2/catch_all.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+const static int ROOMS_PER_SHARD = 256;
+const static int MEMBERS_PER_ROOM = 4;
+const static int MESSAGES_PER_SHARD = 20000;
+
+// rooms whose names hash to the given shard
+static std::vector<std::string> rooms_of(size_t shard, size_t n_shards, int n_rooms)
+{
+    std::vector<std::string> rooms;
+    for (int i = 0; rooms.size() < static_cast<size_t>(n_rooms); i++) {
+        std::string room = "#room" + std::to_string(i);
+        if (RoomShard::shard_of(room, n_shards) == shard) {
+            rooms.push_back(room);
+        }
+    }
+    return rooms;
+}
+
+TEST_CASE("room fan-out scales with room shards", "[!benchmark][rooms]") {
+    auto n_shards = GENERATE(1, 2, 4, 8);
+    unsigned int n_cpus = std::max(1u, std::thread::hardware_concurrency());
+
+    std::vector<std::unique_ptr<BroadCaster>> broadcasters;
+    std::vector<std::unique_ptr<RoomShard>> room_shards;
+    std::vector<std::vector<std::string>> rooms;
+    std::vector<Channel> sentinels(n_shards);
+    uint64_t next_id = 1;
+    for (int shard = 0; shard < n_shards; shard++) {
+        broadcasters.push_back(std::make_unique<BroadCaster>());
+        room_shards.push_back(std::make_unique<RoomShard>(shard % n_cpus));
+        auto &broadcaster = *broadcasters.back();
+        auto &room_shard = *room_shards.back();
+
+        // the last room of each shard has a member that is read to know
+        // when everything before it was delivered
+        rooms.push_back(rooms_of(shard, n_shards, ROOMS_PER_SHARD + 1));
+        for (int room = 0; room < ROOMS_PER_SHARD; room++) {
+            for (int member = 0; member < MEMBERS_PER_ROOM; member++) {
+                int fd = open("/dev/null", O_WRONLY | O_CLOEXEC);
+                REQUIRE(fd != -1);
+                broadcaster.add_client("member" + std::to_string(next_id), fd, next_id);
+                room_shard.join({fd, next_id, &broadcaster}, rooms.back()[room]);
+                next_id++;
+            }
+        }
+        int sentinel_fd = sentinels[shard].get_write_end();
+        broadcaster.add_client("sentinel" + std::to_string(shard), sentinel_fd, next_id);
+        room_shard.join({sentinel_fd, next_id, &broadcaster}, rooms.back().back());
+        next_id++;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+    std::vector<std::vector<frame_ptr_t>> frames(n_shards);
+    for (int shard = 0; shard < n_shards; shard++) {
+        for (const auto &room : rooms[shard]) {
+            message_t message{{5, 1, ""}, "hello"};
+            snprintf(message.header.target, sizeof(message.header.target), "%s", room.c_str());
+            frames[shard].push_back(make_frame(message));
+        }
+    }
+
+    // each run publishes MESSAGES_PER_SHARD to every shard and waits
+    // until every shard's sentinel was written
+    auto publish_all = [&]() {
+        std::vector<std::thread> producers;
+        for (int shard = 0; shard < n_shards; shard++) {
+            producers.emplace_back([&, shard]() {
+                auto &room_shard = *room_shards[shard];
+                room_member_t sender{-1, 0, nullptr};
+                for (int i = 0; i < MESSAGES_PER_SHARD; i++) {
+                    room_shard.publish(sender, frames[shard][i % ROOMS_PER_SHARD]);
+                }
+                room_shard.publish(sender, frames[shard].back());
+            });
+        }
+        for (auto &producer : producers) {
+            producer.join();
+        }
+        for (auto &sentinel : sentinels) {
+            message_t received_msg;
+            REQUIRE(read_message(sentinel.get_read_end(), received_msg) == 0);
+        }
+    };
+
+    BENCHMARK_ADVANCED(std::to_string(n_shards) + " room shards publishing " +
+                       std::to_string(MESSAGES_PER_SHARD) + " messages each")(Catch::Benchmark::Chronometer meter) {
+        meter.measure(publish_all);
+    };
+
+    room_shards.clear();
+    // the broadcasters close their clients' descriptors
+    broadcasters.clear();
+}
@@ -27,21 +27,156 @@ static void sigint_handler(int sig) {
     (void)sig;
 }
 
+// @brief parse the name of a slow consumer policy
+//
+// @param[in]   name    drop-oldest, drop-newest or disconnect
+// @param[out]  policy  parsed policy
+//
+// @return true if name is a known policy
+static bool parse_policy(const std::string &name, SlowConsumerPolicy &policy)
+{
+    if (name == "drop-oldest") {
+        policy = SlowConsumerPolicy::DROP_OLDEST;
+    } else if (name == "drop-newest") {
+        policy = SlowConsumerPolicy::DROP_NEWEST;
+    } else if (name == "disconnect") {
+        policy = SlowConsumerPolicy::DISCONNECT;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+// @brief parse the name of a multiplexor backend
+//
+// @param[in]   name        epoll or uring
+// @param[out]  backend     parsed backend
+//
+// @return true if name is a known backend
+static bool parse_backend(const std::string &name, MplexBackend &backend)
+{
+    if (name == "epoll") {
+        backend = MplexBackend::NATIVE;
+    } else if (name == "uring") {
+        backend = MplexBackend::URING;
+    } else {
+        return false;
+    }
+    return true;
+}
+
 // @brief Server main argument processing and thread creation 
 int main(int argc, char *argv[])
 {
     std::string port;
     std::string address;
+    std::string out_buffer_size;
+    std::string slow_consumer;
+    std::string threads;
+    std::string backlog;
+    std::string resolver_threads;
+    std::string io_backend;
+    std::string max_conn;
+    std::string idle_timeout;
+    std::string ping_timeout;
+    std::string keepalive;
+    std::string room_shards;
+    std::string admin_socket;
+    std::string trace_sample;
 
     ParseFlags parser;
     parser.add_flag("port", port, "port for server to use");
     parser.add_flag("address", address, "address for server");
+    parser.add_flag("out-buffer", out_buffer_size, "bytes queued per client before it is a slow consumer");
+    parser.add_flag("slow-consumer", slow_consumer, "drop-oldest, drop-newest or disconnect");
+    parser.add_flag("threads", threads, "number of event loop threads sharing the port");
+    parser.add_flag("backlog", backlog, "connections queued by each listening socket before accept");
+    parser.add_flag("resolver-threads", resolver_threads, "threads resolving client host names, 0 to disable");
+    parser.add_flag("max-conn", max_conn, "connections per thread before the least recently active is evicted");
+    parser.add_flag("io-backend", io_backend, "epoll or uring, uring falls back to epoll if unavailable");
+    parser.add_flag("idle-timeout", idle_timeout, "seconds of silence before a client is pinged, 0 to disable");
+    parser.add_flag("ping-timeout", ping_timeout, "seconds a pinged client has to answer");
+    parser.add_flag("keepalive", keepalive, "seconds of silence before TCP keepalive probes, 0 to disable");
+    parser.add_flag("room-shards", room_shards, "threads owning rooms, each pinned to a core, 0 for one per thread");
+    parser.add_flag("admin-socket", admin_socket, "unix socket path serving metrics in the Prometheus text format");
+    parser.add_flag("trace-sample", trace_sample, "fraction of reads whose message latency is traced, 0 to disable");
 
     int rc = parser.parse_args(argc, argv);
     if (rc) {
         log(LogPriority::ERROR, "Unable to parse arguments: %d\n", rc);
         exit(EXIT_FAILURE);
     }
+
+    server_config_t config{address, port, DEFAULT_MAX_CONN, DEFAULT_OUT_BUFFER_SIZE,
+                           SlowConsumerPolicy::DROP_OLDEST, 1, DEFAULT_LISTEN_BACKLOG, 0,
+                           MplexBackend::NATIVE};
+    if (!max_conn.empty()) {
+        config.max_conn = std::strtoul(max_conn.c_str(), nullptr, 10);
+        if (config.max_conn == 0) {
+            log(LogPriority::ERROR, "max-conn must be at least 1\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+    if (!out_buffer_size.empty()) {
+        config.out_buffer_size = std::strtoul(out_buffer_size.c_str(), nullptr, 10);
+        if (config.out_buffer_size < MSG_FRAME_MAX_SIZE) {
+            log(LogPriority::ERROR, "out-buffer must be at least %lu bytes\n", MSG_FRAME_MAX_SIZE);
+            exit(EXIT_FAILURE);
+        }
+    }
+    if (!slow_consumer.empty() && !parse_policy(slow_consumer, config.slow_consumer_policy)) {
+        log(LogPriority::ERROR, "Unknown slow consumer policy: %s\n", slow_consumer.c_str());
+        exit(EXIT_FAILURE);
+    }
+    if (!threads.empty()) {
+        config.n_threads = std::strtoul(threads.c_str(), nullptr, 10);
+        if (config.n_threads == 0) {
+            log(LogPriority::ERROR, "threads must be at least 1\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+    if (!backlog.empty()) {
+        config.backlog = std::atoi(backlog.c_str());
+        if (config.backlog <= 0) {
+            log(LogPriority::ERROR, "backlog must be at least 1\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+    if (!resolver_threads.empty()) {
+        config.resolver_threads = std::strtoul(resolver_threads.c_str(), nullptr, 10);
+    }
+    if (!io_backend.empty() && !parse_backend(io_backend, config.io_backend)) {
+        log(LogPriority::ERROR, "Unknown io backend: %s\n", io_backend.c_str());
+        exit(EXIT_FAILURE);
+    }
+    if (!idle_timeout.empty()) {
+        config.idle_timeout_ms = std::strtoull(idle_timeout.c_str(), nullptr, 10) * 1000;
+    }
+    if (!ping_timeout.empty()) {
+        config.ping_timeout_ms = std::strtoull(ping_timeout.c_str(), nullptr, 10) * 1000;
+        if (config.ping_timeout_ms == 0) {
+            log(LogPriority::ERROR, "ping-timeout must be at least 1\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+    if (!room_shards.empty()) {
+        config.room_shards = std::strtoul(room_shards.c_str(), nullptr, 10);
+    }
+    config.admin_socket = admin_socket;
+    if (!trace_sample.empty()) {
+        config.trace_sample = std::strtod(trace_sample.c_str(), nullptr);
+        if (config.trace_sample < 0 || config.trace_sample > 1) {
+            log(LogPriority::ERROR, "trace-sample must be between 0 and 1\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+    if (!keepalive.empty()) {
+        config.keepalive_s = std::atoi(keepalive.c_str());
+        if (config.keepalive_s < 0) {
+            log(LogPriority::ERROR, "keepalive must not be negative\n");
+            exit(EXIT_FAILURE);
+        }
+    }
     
     // ignore SIGPIPE to allow for possible EPIPE on writes to 
     // closed/shutdown sockets
@@ -50,7 +185,7 @@ int main(int argc, char *argv[])
     // handle SIGINT so that clean shutdown is possible
     signal(SIGINT, sigint_handler); 
    
-    Server server(address, port, 20);
+    Server server(config);
 
     rc = pause();
     if (rc && errno != EINTR) {
@@ -0,0 +1,64 @@
+// Test cases for AdminServer class
+//
+// 17 October 2026
+
+#include "../AdminServer.hpp"
+
+#include <catch2/catch_all.hpp>
+
+#include <memory>
+#include <string>
+
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+// connect to the admin socket, send request and read until it closes
+static std::string query(const std::string &path, const std::string &request)
+{
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    REQUIRE(fd != -1);
+    struct sockaddr_un addr{};
+    addr.sun_family = AF_UNIX;
+    snprintf(addr.sun_path, sizeof(addr.sun_path), "%s", path.c_str());
+    REQUIRE(connect(fd, reinterpret_cast<struct sockaddr *>(&addr), sizeof(addr)) == 0);
+    if (!request.empty()) {
+        REQUIRE(write(fd, request.data(), request.size()) == static_cast<ssize_t>(request.size()));
+    }
+    std::string response;
+    char buffer[4096];
+    ssize_t n = 0;
+    while ((n = read(fd, buffer, sizeof(buffer))) > 0) {
+        response.append(buffer, n);
+    }
+    close(fd);
+    return response;
+}
+
+TEST_CASE("admin server serves metrics on a local socket", "[admin-server]") {
+    std::string path = "/tmp/cpp_chat_admin_test." + std::to_string(getpid());
+    MetricsRegistry registry;
+    registry.counter("test_messages_total", "Messages.").add(7);
+    auto admin = std::make_unique<AdminServer>(path, registry);
+
+    SECTION("a plain connection gets the text") {
+        auto response = query(path, "");
+        REQUIRE(response.rfind("# HELP test_messages_total Messages.\n", 0) == 0);
+        REQUIRE(response.find("test_messages_total 7\n") != std::string::npos);
+    }
+
+    SECTION("an HTTP request gets an HTTP response") {
+        auto response = query(path, "GET /metrics HTTP/1.1\r\nHost: localhost\r\n\r\n");
+        REQUIRE(response.rfind("HTTP/1.0 200 OK\r\n", 0) == 0);
+        REQUIRE(response.find("Content-Type: text/plain; version=0.0.4\r\n") != std::string::npos);
+        REQUIRE(response.find("\r\n\r\n# HELP test_messages_total Messages.\n") != std::string::npos);
+
+        response = query(path, "GET /other HTTP/1.1\r\n\r\n");
+        REQUIRE(response.rfind("HTTP/1.0 404 Not Found\r\n", 0) == 0);
+    }
+
+    SECTION("the socket is removed on shutdown") {
+        admin.reset();
+        REQUIRE(access(path.c_str(), F_OK) == -1);
+    }
+}
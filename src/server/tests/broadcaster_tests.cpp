@@ -12,12 +12,15 @@
 
 #include <catch2/catch_all.hpp>
 
+#include <chrono>
 #include <iostream>
 #include <memory>
 #include <string>
 #include <vector>
+#include <thread>
 #include <utility>
 
+#include <sys/socket.h>
 #include <unistd.h>
 
 const static int TEST_FD = 10;
@@ -60,7 +63,7 @@ TEST_CASE("broadcaster broadcast message", "[broadcast-msg]") {
     auto &sending_client = test_clients.at(2);
     REQUIRE(io_mplex->remove(sending_client.second.get_read_end()) == 0);
 
-    message_t message{{4, 2, nullptr}, "moo"};
+    message_t message{{4, 2, ""}, "moo"};
     broad_caster.broadcast_msg(sending_client.second.get_write_end(), std::move(message));
 
     event_container_t  test_events(NUM_CLIENTS);
@@ -112,3 +115,166 @@ TEST_CASE("broadcaster direct message", "[direct-msg]") {
     REQUIRE(strncmp(received_msg.message, "test", strlen("moo")) == 0);
     REQUIRE(close(event.fd) == 0);
 }
+
+TEST_CASE("broadcaster direct message matches the whole name", "[direct-msg-exact]") {
+    Channel sender;
+    Channel bob;
+    Channel bobby;
+    auto broad_caster = BroadCaster();
+
+    broad_caster.add_client("sender", sender.get_write_end());
+    broad_caster.add_client("bobby", bobby.get_write_end());
+    broad_caster.add_client("bob", bob.get_write_end());
+
+    // neither is a name, so neither is delivered
+    broad_caster.direct_msg(sender.get_write_end(), {{3, 1, "bo"}, "one"});
+    broad_caster.direct_msg(sender.get_write_end(), {{3, 2, "bobbyx"}, "two"});
+    broad_caster.direct_msg(sender.get_write_end(), {{5, 3, "bobby"}, "three"});
+    broad_caster.direct_msg(sender.get_write_end(), {{4, 4, "bob"}, "four"});
+
+    message_t received_msg;
+    REQUIRE(read_message(bobby.get_read_end(), received_msg) == 0);
+    REQUIRE(received_msg.header.time_stamp == 3);
+    REQUIRE(read_message(bob.get_read_end(), received_msg) == 0);
+    REQUIRE(received_msg.header.time_stamp == 4);
+}
+
+TEST_CASE("broadcaster keeps its own copy of client names", "[client-name-copy]") {
+    Channel sender;
+    Channel receiver;
+    auto broad_caster = BroadCaster();
+
+    {
+        std::string name = "receiver";
+        broad_caster.add_client(name, receiver.get_write_end());
+        broad_caster.add_client(std::string("sender"), sender.get_write_end());
+        name.assign("overwritten");
+    }
+
+    broad_caster.direct_msg(sender.get_write_end(), {{4, 2, "receiver"}, "test"});
+
+    message_t received_msg;
+    REQUIRE(read_message(receiver.get_read_end(), received_msg) == 0);
+    REQUIRE(std::string(received_msg.message, received_msg.header.msg_len) == "test");
+}
+
+TEST_CASE("broadcaster keeps a burst of messages in order", "[broadcast-burst]") {
+    auto backend = GENERATE(MplexBackend::NATIVE, MplexBackend::URING);
+    Channel sender;
+    Channel receiver;
+    BroadCaster broad_caster(DEFAULT_OUT_BUFFER_SIZE, SlowConsumerPolicy::DROP_OLDEST, backend);
+
+    broad_caster.add_client("sender", sender.get_write_end());
+    broad_caster.add_client("receiver", receiver.get_write_end());
+
+    const int burst_size = 20;
+    for (int i = 0; i < burst_size; i++) {
+        message_t message{{0, static_cast<uint64_t>(i), ""}, ""};
+        message.header.msg_len = snprintf(message.message, MSG_DATA_MAX_SIZE, "msg %d", i);
+        broad_caster.broadcast_msg(sender.get_write_end(), std::move(message));
+    }
+
+    for (int i = 0; i < burst_size; i++) {
+        message_t received_msg;
+        REQUIRE(read_message(receiver.get_read_end(), received_msg) == 0);
+        REQUIRE(received_msg.header.time_stamp == static_cast<uint64_t>(i));
+        REQUIRE(std::string(received_msg.message, received_msg.header.msg_len) ==
+                    "msg " + std::to_string(i));
+    }
+}
+
+// Client socket for the broadcaster that fills up quickly. fds[0] is
+// handed to the broadcaster and fds[1] is read by the test.
+struct SlowClient {
+    SlowClient()
+    {
+        REQUIRE(socketpair(AF_UNIX, SOCK_STREAM, 0, fds) == 0);
+        REQUIRE(set_nonblocking(fds[0]) == 0);
+        int size = 4096;
+        REQUIRE(setsockopt(fds[0], SOL_SOCKET, SO_SNDBUF, &size, sizeof(size)) == 0);
+    }
+    ~SlowClient()
+    {
+        close(fds[0]);
+        close(fds[1]);
+    }
+    int fds[2];
+};
+
+static void broadcast_burst(BroadCaster &broad_caster, int sender_fd, int burst_size)
+{
+    for (int i = 0; i < burst_size; i++) {
+        message_t message{{MSG_DATA_MAX_SIZE, static_cast<uint64_t>(i), ""}, ""};
+        broad_caster.broadcast_msg(sender_fd, std::move(message));
+    }
+}
+
+TEST_CASE("broadcaster finishes flushing a stalled client", "[slow-consumer-flush]") {
+    auto backend = GENERATE(MplexBackend::NATIVE, MplexBackend::URING);
+    Channel sender;
+    SlowClient receiver;
+    const int burst_size = 200;
+    BroadCaster broad_caster(burst_size * MSG_FRAME_MAX_SIZE, SlowConsumerPolicy::DISCONNECT, backend);
+
+    broad_caster.add_client("sender", sender.get_write_end());
+    broad_caster.add_client("receiver", receiver.fds[0]);
+    broadcast_burst(broad_caster, sender.get_write_end(), burst_size);
+
+    // give the broadcaster time to fill the socket before reading
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    for (int i = 0; i < burst_size; i++) {
+        message_t received_msg;
+        REQUIRE(read_message(receiver.fds[1], received_msg) == 0);
+        REQUIRE(received_msg.header.time_stamp == static_cast<uint64_t>(i));
+    }
+}
+
+TEST_CASE("broadcaster applies the slow consumer policy", "[slow-consumer-policy]") {
+    Channel sender;
+    SlowClient receiver;
+    const int burst_size = 200;
+
+    SECTION("disconnect") {
+        BroadCaster broad_caster(4 * MSG_FRAME_MAX_SIZE, SlowConsumerPolicy::DISCONNECT);
+        broad_caster.add_client("sender", sender.get_write_end());
+        broad_caster.add_client("receiver", receiver.fds[0]);
+        broadcast_burst(broad_caster, sender.get_write_end(), burst_size);
+
+        // the receiver sees end of file once what was written is read
+        int received = 0;
+        message_t received_msg;
+        int rc = 0;
+        while ((rc = read_message(receiver.fds[1], received_msg)) == 0) {
+            REQUIRE(received_msg.header.time_stamp == static_cast<uint64_t>(received));
+            received++;
+        }
+        REQUIRE(rc == EOF);
+        REQUIRE(received < burst_size);
+    }
+
+    SECTION("drop oldest and drop newest") {
+        auto policy = GENERATE(SlowConsumerPolicy::DROP_OLDEST, SlowConsumerPolicy::DROP_NEWEST);
+        BroadCaster broad_caster(4 * MSG_FRAME_MAX_SIZE, policy);
+        broad_caster.add_client("sender", sender.get_write_end());
+        broad_caster.add_client("receiver", receiver.fds[0]);
+        broadcast_burst(broad_caster, sender.get_write_end(), burst_size);
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+        // a marker sent once the burst is processed always arrives
+        message_t marker{{0, burst_size, ""}, ""};
+        broad_caster.broadcast_msg(sender.get_write_end(), std::move(marker));
+
+        int received = 0;
+        uint64_t last = 0;
+        message_t received_msg;
+        do {
+            REQUIRE(read_message(receiver.fds[1], received_msg) == 0);
+            if (received > 0) {
+                REQUIRE(received_msg.header.time_stamp > last);
+            }
+            last = received_msg.header.time_stamp;
+            received++;
+        } while (received_msg.header.time_stamp != burst_size);
+        REQUIRE(received < burst_size);
+    }
+}
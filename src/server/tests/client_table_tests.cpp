@@ -0,0 +1,73 @@
+// Test cases for ClientTable class
+//
+// 17 October 2026
+
+#include "../ClientTable.hpp"
+
+#include <catch2/catch_all.hpp>
+
+#include <string>
+
+const static size_t TEST_BUFFER_SIZE = 1024;
+
+TEST_CASE("client table finds clients by exact name", "[client-table-find]") {
+    ClientTable table(TEST_BUFFER_SIZE);
+    REQUIRE(table.add(10, "bob") != nullptr);
+    REQUIRE(table.add(11, "bobby") != nullptr);
+
+    REQUIRE(table.size() == 2);
+    REQUIRE(table.find("bob") == 10);
+    REQUIRE(table.find("bobby") == 11);
+    REQUIRE(table.find("bo") == -1);
+    REQUIRE(table.find("bobb") == -1);
+    REQUIRE(table.find("") == -1);
+}
+
+TEST_CASE("client table keeps the index in sync", "[client-table-sync]") {
+    ClientTable table(TEST_BUFFER_SIZE);
+    REQUIRE(table.add(10, "alice") != nullptr);
+
+    SECTION("a connection is only added once") {
+        REQUIRE(table.add(10, "carol") == nullptr);
+        REQUIRE(table.find("carol") == -1);
+        REQUIRE(table.find("alice") == 10);
+    }
+
+    SECTION("removing a client removes its name") {
+        REQUIRE(table.remove(10));
+        REQUIRE_FALSE(table.remove(10));
+        REQUIRE(table.find(10) == nullptr);
+        REQUIRE(table.find("alice") == -1);
+        REQUIRE(table.size() == 0);
+
+        REQUIRE(table.add(12, "alice") != nullptr);
+        REQUIRE(table.find("alice") == 12);
+    }
+
+    SECTION("a taken name keeps pointing at its owner") {
+        auto client = table.add(11, "alice");
+        REQUIRE(client != nullptr);
+        REQUIRE_FALSE(client->indexed);
+        REQUIRE(table.find("alice") == 10);
+
+        REQUIRE(table.remove(11));
+        REQUIRE(table.find("alice") == 10);
+    }
+}
+
+TEST_CASE("client table attaches host names", "[client-table-host]") {
+    ClientTable table(TEST_BUFFER_SIZE);
+    auto client = table.add(10, "127.0.0.1:4000");
+    REQUIRE(client != nullptr);
+    REQUIRE(client->host.empty());
+
+    REQUIRE(table.set_host(10, "localhost"));
+    REQUIRE(client->host == "localhost");
+    REQUIRE(table.set_host(10, "localhost.localdomain"));
+    REQUIRE(client->host == "localhost.localdomain");
+
+    REQUIRE_FALSE(table.set_host(11, "localhost"));
+    REQUIRE_FALSE(table.set_host(10, ""));
+    REQUIRE(client->host == "localhost.localdomain");
+    REQUIRE(table.remove(10));
+}
@@ -0,0 +1,159 @@
+// Test cases for OutBuffer class
+//
+// 17 October 2026
+
+#include "../OutBuffer.hpp"
+
+#include <common/net_common.hpp>
+
+#include <catch2/catch_all.hpp>
+
+#include <cstring>
+#include <string>
+
+#include <sys/socket.h>
+#include <unistd.h>
+
+static frame_ptr_t make_message(int id, size_t msg_len)
+{
+    message_t message{};
+    message.header.msg_len = msg_len;
+    message.header.time_stamp = id;
+    memset(message.message, 'a' + (id % 26), msg_len);
+    auto frame = make_frame(message);
+    REQUIRE(frame != nullptr);
+    return frame;
+}
+
+// non-blocking socketpair with a small send buffer on the writing end
+struct OutSocketPair {
+    OutSocketPair()
+    {
+        REQUIRE(socketpair(AF_UNIX, SOCK_STREAM, 0, fds) == 0);
+        REQUIRE(set_nonblocking(fds[0]) == 0);
+        int size = 4096;
+        REQUIRE(setsockopt(fds[0], SOL_SOCKET, SO_SNDBUF, &size, sizeof(size)) == 0);
+    }
+    ~OutSocketPair()
+    {
+        close(fds[0]);
+        close(fds[1]);
+    }
+    int fds[2];
+};
+
+TEST_CASE("out buffer flushes queued messages", "[out-flush]") {
+    OutSocketPair sockets;
+    OutBuffer out(4 * MSG_FRAME_MAX_SIZE);
+
+    for (int i = 0; i < 3; i++) {
+        REQUIRE(out.push(make_message(i, 10)));
+    }
+    REQUIRE(out.size() == 3 * (WIRE_HEADER_SIZE + 10));
+    REQUIRE(out.flush(sockets.fds[0]) == FlushStatus::DONE);
+    REQUIRE(out.empty());
+
+    for (int i = 0; i < 3; i++) {
+        message_t received;
+        REQUIRE(read_message(sockets.fds[1], received) == 0);
+        REQUIRE(received.header.time_stamp == static_cast<uint64_t>(i));
+    }
+}
+
+TEST_CASE("out buffer is bounded", "[out-bounded]") {
+    OutBuffer out(2 * (WIRE_HEADER_SIZE + 100));
+
+    REQUIRE(out.push(make_message(0, 100)));
+    REQUIRE(out.push(make_message(1, 100)));
+    REQUIRE(out.available() == 0);
+    REQUIRE_FALSE(out.push(make_message(2, 1)));
+
+    REQUIRE(out.drop_oldest(WIRE_HEADER_SIZE + 1) == 1);
+    REQUIRE(out.push(make_message(2, 1)));
+}
+
+TEST_CASE("out buffer reports a full socket and wraps", "[out-again]") {
+    OutSocketPair sockets;
+    OutBuffer out(8 * MSG_FRAME_MAX_SIZE);
+
+    // keep the ring full until the socket stops taking data
+    int sent = 0;
+    FlushStatus status = FlushStatus::DONE;
+    while (status != FlushStatus::AGAIN) {
+        while (out.push(make_message(sent, MSG_DATA_MAX_SIZE))) {
+            sent++;
+        }
+        status = out.flush(sockets.fds[0]);
+        REQUIRE(status != FlushStatus::ERROR);
+    }
+
+    // drain the peer while flushing what is left
+    int received_count = 0;
+    while (received_count < sent) {
+        message_t received;
+        REQUIRE(read_message(sockets.fds[1], received) == 0);
+        REQUIRE(received.header.time_stamp == static_cast<uint64_t>(received_count));
+        REQUIRE(received.header.msg_len == MSG_DATA_MAX_SIZE);
+        received_count++;
+        REQUIRE(out.flush(sockets.fds[0]) != FlushStatus::ERROR);
+    }
+    REQUIRE(out.empty());
+}
+
+TEST_CASE("out buffer never drops a partially written message", "[out-drop-partial]") {
+    OutSocketPair sockets;
+    OutBuffer out(8 * MSG_FRAME_MAX_SIZE);
+
+    // fill the socket so that the head of the ring is only partly written
+    int sent = 0;
+    while (out.flush(sockets.fds[0]) != FlushStatus::AGAIN) {
+        REQUIRE(out.push(make_message(sent, MSG_DATA_MAX_SIZE - 7)));
+        sent++;
+    }
+    int first_dropped = sent;
+    for (int i = 0; i < 3; i++) {
+        REQUIRE(out.push(make_message(sent, MSG_DATA_MAX_SIZE - 7)));
+        sent++;
+    }
+    out.drop_oldest(out.capacity());
+    REQUIRE(out.push(make_message(sent, 5)));
+
+    // everything up to the partial message arrives intact followed
+    // by the message pushed after the drop
+    bool found_last = false;
+    int expected = 0;
+    while (!found_last) {
+        message_t received;
+        REQUIRE(out.flush(sockets.fds[0]) != FlushStatus::ERROR);
+        REQUIRE(read_message(sockets.fds[1], received) == 0);
+        if (received.header.time_stamp == static_cast<uint64_t>(sent)) {
+            found_last = true;
+        } else {
+            REQUIRE(received.header.time_stamp == static_cast<uint64_t>(expected));
+            REQUIRE(expected < first_dropped);
+            expected++;
+        }
+    }
+}
+
+TEST_CASE("out buffer shares frames between clients", "[out-shared]") {
+    OutSocketPair first;
+    OutSocketPair second;
+    OutBuffer first_out(MSG_FRAME_MAX_SIZE);
+    OutBuffer second_out(MSG_FRAME_MAX_SIZE);
+
+    auto frame = make_message(7, 10);
+    REQUIRE(first_out.push(frame));
+    REQUIRE(second_out.push(frame));
+    REQUIRE(frame.use_count() == 3);
+
+    REQUIRE(first_out.flush(first.fds[0]) == FlushStatus::DONE);
+    REQUIRE(second_out.flush(second.fds[0]) == FlushStatus::DONE);
+    REQUIRE(frame.use_count() == 1);
+
+    for (int fd : {first.fds[1], second.fds[1]}) {
+        message_t received;
+        REQUIRE(read_message(fd, received) == 0);
+        REQUIRE(received.header.time_stamp == 7);
+    }
+}
@@ -0,0 +1,462 @@
+// Test cases for Reactor class
+//
+// 17 October 2026
+
+#include "../Reactor.hpp"
+
+#include <common/frame.hpp>
+#include <common/net_common.hpp>
+#include <common/test_util.hpp>
+#include <common/utilities.hpp>
+
+#include <catch2/catch_all.hpp>
+
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <errno.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+// name the server gives to the client connected on sock_fd
+static std::string client_name(int sock_fd)
+{
+    struct sockaddr_storage addr{};
+    socklen_t addrlen = sizeof(addr);
+    REQUIRE(getsockname(sock_fd, reinterpret_cast<struct sockaddr *>(&addr), &addrlen) == 0);
+    char name[ADDRESS_MAX_SIZE];
+    REQUIRE(format_address(&addr, name, sizeof(name), true) > 0);
+    return name;
+}
+
+// ping the server and read its pong. The reactor answers on the
+// client's broadcaster, after adding the client to it and after
+// handling everything the client sent before the ping, so nothing
+// may be waiting to be read on sock_fd.
+static void sync_client(int sock_fd)
+{
+    message_t ping{};
+    ping.header.type = MsgType::PING;
+    REQUIRE(write_message(sock_fd, ping) == 0);
+    message_t pong;
+    REQUIRE(read_message(sock_fd, pong) == 0);
+    REQUIRE(pong.header.type == MsgType::PONG);
+}
+
+// wait until a broadcaster has flushed, and recorded the traces of,
+// everything queued on it so far. A batch's traces are recorded after
+// it is flushed, so the second frame to a sentinel, queued once the
+// first was written, is always in a later batch.
+static void drain_broadcaster(BroadCaster &broadcaster)
+{
+    const uint64_t sentinel_id = UINT64_MAX;
+    Channel sentinel;
+    int sentinel_fd = dup(sentinel.get_write_end());
+    REQUIRE(sentinel_fd != -1);
+    broadcaster.add_client("sentinel", sentinel_fd, sentinel_id);
+    auto done = make_frame(message_t{{4, 1, ""}, "done"});
+    for (int i = 0; i < 2; i++) {
+        broadcaster.send_frame(sentinel_fd, sentinel_id, done);
+        message_t received_msg;
+        REQUIRE(read_message(sentinel.get_read_end(), received_msg) == 0);
+    }
+    broadcaster.del_client(sentinel_fd);
+}
+
+TEST_CASE("sockets share a port with SO_REUSEPORT", "[bind-reuse-port]") {
+    auto port = free_port();
+
+    int first = bind_socket("127.0.0.1", port.c_str(), false, true);
+    REQUIRE(first != -1);
+    int second = bind_socket("127.0.0.1", port.c_str(), false, true);
+    REQUIRE(second != -1);
+    REQUIRE(bind_socket("127.0.0.1", port.c_str(), false, false) == -1);
+
+    close(first);
+    close(second);
+}
+
+TEST_CASE("accepted sockets are non-blocking and close on exec", "[accept-socket]") {
+    auto port = free_port();
+    int listen_fd = bind_socket("127.0.0.1", port.c_str(), false, false);
+    REQUIRE(listen_fd != -1);
+    REQUIRE(listen_socket(listen_fd, DEFAULT_LISTEN_BACKLOG) == 0);
+
+    struct sockaddr_storage addr;
+    socklen_t addrlen = sizeof(addr);
+    REQUIRE(accept_socket(listen_fd, &addr, &addrlen) == -1);
+    REQUIRE((errno == EAGAIN || errno == EWOULDBLOCK));
+
+    int client_fd = connect_socket("127.0.0.1", port.c_str(), true);
+    REQUIRE(client_fd > 0);
+    addrlen = sizeof(addr);
+    int accepted_fd = accept_socket(listen_fd, &addr, &addrlen);
+    REQUIRE(accepted_fd != -1);
+    REQUIRE((fcntl(accepted_fd, F_GETFL) & O_NONBLOCK) != 0);
+    REQUIRE((fcntl(accepted_fd, F_GETFD) & FD_CLOEXEC) != 0);
+
+    close(accepted_fd);
+    close(client_fd);
+    close(listen_fd);
+}
+
+TEST_CASE("reactors deliver messages across shards", "[reactor-shards]") {
+    // io_uring falls back to epoll where it is unavailable
+    auto backend = GENERATE(MplexBackend::NATIVE, MplexBackend::URING);
+    const unsigned int n_shards = 4;
+    const unsigned int n_clients = 16;
+    auto port = free_port();
+
+    std::vector<std::unique_ptr<BroadCaster>> broadcasters;
+    std::vector<BroadCaster *> shards;
+    for (size_t i = 0; i < n_shards; i++) {
+        broadcasters.push_back(std::make_unique<BroadCaster>(DEFAULT_OUT_BUFFER_SIZE,
+                                                             SlowConsumerPolicy::DROP_OLDEST, backend));
+        shards.push_back(broadcasters.back().get());
+    }
+    server_config_t config{"127.0.0.1", port, n_clients, DEFAULT_OUT_BUFFER_SIZE,
+                           SlowConsumerPolicy::DROP_OLDEST, n_shards, DEFAULT_LISTEN_BACKLOG, 0, backend};
+    std::vector<std::unique_ptr<Reactor>> reactors;
+    for (size_t i = 0; i < n_shards; i++) {
+        reactors.push_back(std::make_unique<Reactor>(config, i, shards, nullptr));
+    }
+
+    std::vector<int> clients;
+    for (unsigned int i = 0; i < n_clients; i++) {
+        int sock_fd = connect_socket("127.0.0.1", port.c_str(), true);
+        REQUIRE(sock_fd > 0);
+        clients.push_back(sock_fd);
+    }
+
+    // clients are added to their shard asynchronously
+    for (int sock_fd : clients) {
+        sync_client(sock_fd);
+    }
+
+    int sender = clients.front();
+    message_t message{{3, 1000, ""}, "moo"};
+    REQUIRE(write_message(sender, message) == 0);
+    for (size_t i = 1; i < clients.size(); i++) {
+        message_t received_msg;
+        REQUIRE(read_message(clients[i], received_msg) == 0);
+        REQUIRE(received_msg.header.time_stamp == 1000);
+    }
+
+    reactors.clear();
+    for (int sock_fd : clients) {
+        close(sock_fd);
+    }
+}
+
+TEST_CASE("reactor evicts the least recently active client at capacity", "[reactor-evict]") {
+    auto backend = GENERATE(MplexBackend::NATIVE, MplexBackend::URING);
+    auto port = free_port();
+
+    BroadCaster broadcaster(DEFAULT_OUT_BUFFER_SIZE, SlowConsumerPolicy::DROP_OLDEST, backend);
+    std::vector<BroadCaster *> shards{&broadcaster};
+    server_config_t config{"127.0.0.1", port, 2, DEFAULT_OUT_BUFFER_SIZE,
+                           SlowConsumerPolicy::DROP_OLDEST, 1, DEFAULT_LISTEN_BACKLOG, 0, backend};
+    auto reactor = std::make_unique<Reactor>(config, 0, shards, nullptr);
+
+    int first = connect_socket("127.0.0.1", port.c_str(), true);
+    REQUIRE(first > 0);
+    sync_client(first);
+    int second = connect_socket("127.0.0.1", port.c_str(), true);
+    REQUIRE(second > 0);
+    sync_client(second);
+
+    // the first client becomes the most recently active
+    message_t message{{2, 1, ""}, "hi"};
+    REQUIRE(write_message(first, message) == 0);
+    message_t received_msg;
+    REQUIRE(read_message(second, received_msg) == 0);
+
+    int third = connect_socket("127.0.0.1", port.c_str(), true);
+    REQUIRE(third > 0);
+    char byte;
+    REQUIRE(recv(second, &byte, 1, 0) == 0);
+
+    message.header.time_stamp = 2;
+    REQUIRE(write_message(first, message) == 0);
+    REQUIRE(read_message(third, received_msg) == 0);
+    REQUIRE(received_msg.header.time_stamp == 2);
+
+    reactor.reset();
+    close(first);
+    close(second);
+    close(third);
+}
+
+TEST_CASE("reactor pings idle clients and drops silent ones", "[reactor-idle]") {
+    auto backend = GENERATE(MplexBackend::NATIVE, MplexBackend::URING);
+    auto port = free_port();
+
+    BroadCaster broadcaster(DEFAULT_OUT_BUFFER_SIZE, SlowConsumerPolicy::DROP_OLDEST, backend);
+    std::vector<BroadCaster *> shards{&broadcaster};
+    server_config_t config{"127.0.0.1", port, 4, DEFAULT_OUT_BUFFER_SIZE,
+                           SlowConsumerPolicy::DROP_OLDEST, 1, DEFAULT_LISTEN_BACKLOG, 0, backend};
+    config.idle_timeout_ms = 50;
+    config.ping_timeout_ms = 100;
+    auto reactor = std::make_unique<Reactor>(config, 0, shards, nullptr);
+
+    int silent = connect_socket("127.0.0.1", port.c_str(), true);
+    REQUIRE(silent > 0);
+    int answering = connect_socket("127.0.0.1", port.c_str(), true);
+    REQUIRE(answering > 0);
+
+    message_t ping;
+    REQUIRE(read_message(silent, ping) == 0);
+    REQUIRE(ping.header.type == MsgType::PING);
+    REQUIRE(read_message(answering, ping) == 0);
+    REQUIRE(ping.header.type == MsgType::PING);
+
+    message_t pong{};
+    pong.header.type = MsgType::PONG;
+    REQUIRE(write_message(answering, pong) == 0);
+
+    // pings are answered by the server and never forwarded
+    REQUIRE(write_message(answering, ping) == 0);
+    message_t reply;
+    REQUIRE(read_message(answering, reply) == 0);
+    REQUIRE(reply.header.type == MsgType::PONG);
+
+    char byte;
+    REQUIRE(recv(silent, &byte, 1, 0) == 0);
+
+    // still connected, so it is pinged again once it goes quiet
+    REQUIRE(read_message(answering, ping) == 0);
+    REQUIRE(ping.header.type == MsgType::PING);
+
+    reactor.reset();
+    close(silent);
+    close(answering);
+}
+
+// build a room frame for op on room
+static message_t room_request(RoomOp op, const std::string &room)
+{
+    message_t message{};
+    message.header.type = MsgType::ROOM;
+    message.header.msg_len = 1;
+    snprintf(message.header.target, sizeof(message.header.target), "%s", room.c_str());
+    message.message[0] = static_cast<char>(op);
+    return message;
+}
+
+TEST_CASE("reactors publish to room members on every shard", "[reactor-rooms]") {
+    const unsigned int n_shards = 2;
+    auto port = free_port();
+
+    std::vector<std::unique_ptr<BroadCaster>> broadcasters;
+    std::vector<BroadCaster *> shards;
+    std::vector<std::unique_ptr<RoomShard>> room_shards;
+    std::vector<RoomShard *> rooms;
+    for (size_t i = 0; i < n_shards; i++) {
+        broadcasters.push_back(std::make_unique<BroadCaster>());
+        shards.push_back(broadcasters.back().get());
+        room_shards.push_back(std::make_unique<RoomShard>(ROOM_SHARD_NO_CPU));
+        rooms.push_back(room_shards.back().get());
+    }
+    server_config_t config{"127.0.0.1", port, 8, DEFAULT_OUT_BUFFER_SIZE,
+                           SlowConsumerPolicy::DROP_OLDEST, n_shards, DEFAULT_LISTEN_BACKLOG, 0,
+                           MplexBackend::NATIVE};
+    config.trace_sample = 1;
+    std::vector<std::unique_ptr<Reactor>> reactors;
+    for (size_t i = 0; i < n_shards; i++) {
+        reactors.push_back(std::make_unique<Reactor>(config, i, shards, nullptr, rooms));
+    }
+
+    // the first three join #games, the last one is elsewhere
+    std::vector<int> clients;
+    for (int i = 0; i < 4; i++) {
+        int sock_fd = connect_socket("127.0.0.1", port.c_str(), true);
+        REQUIRE(sock_fd > 0);
+        clients.push_back(sock_fd);
+    }
+    for (int i = 0; i < 3; i++) {
+        REQUIRE(write_message(clients[i], room_request(RoomOp::JOIN, "#games")) == 0);
+    }
+    REQUIRE(write_message(clients[3], room_request(RoomOp::JOIN, "#news")) == 0);
+
+    // once a client has its pong its join is queued on the room's
+    // shard, ahead of anything published to the room from now on
+    for (int sock_fd : clients) {
+        sync_client(sock_fd);
+    }
+
+    // a room's messages are never traced, as no shard would finish it
+    uint64_t decoded = trace_metrics().read_decode.count();
+    message_t message{{3, 1, "#games"}, "moo"};
+    REQUIRE(write_message(clients[0], message) == 0);
+    message_t received_msg;
+    for (int i = 1; i < 3; i++) {
+        REQUIRE(read_message(clients[i], received_msg) == 0);
+        REQUIRE(received_msg.header.time_stamp == 1);
+        REQUIRE(std::string(received_msg.header.target) == "#games");
+    }
+    REQUIRE(trace_metrics().read_decode.count() == decoded);
+
+    // the first message the outsider sees is the next broadcast
+    message_t broadcast{{3, 2, ""}, "all"};
+    REQUIRE(write_message(clients[0], broadcast) == 0);
+    for (int i = 1; i < 4; i++) {
+        REQUIRE(read_message(clients[i], received_msg) == 0);
+        REQUIRE(received_msg.header.time_stamp == 2);
+    }
+
+    REQUIRE(write_message(clients[1], room_request(RoomOp::LIST, "")) == 0);
+    REQUIRE(read_message(clients[1], received_msg) == 0);
+    REQUIRE(received_msg.header.type == MsgType::ROOM);
+    REQUIRE(std::string(received_msg.message, received_msg.header.msg_len) ==
+            std::string(1, static_cast<char>(RoomOp::LIST)) + "#games\n");
+
+    // once it leaves a member no longer hears the room
+    REQUIRE(write_message(clients[2], room_request(RoomOp::LEAVE, "#games")) == 0);
+    sync_client(clients[2]);
+    message.header.time_stamp = 3;
+    REQUIRE(write_message(clients[0], message) == 0);
+    REQUIRE(read_message(clients[1], received_msg) == 0);
+    REQUIRE(received_msg.header.time_stamp == 3);
+    broadcast.header.time_stamp = 4;
+    REQUIRE(write_message(clients[0], broadcast) == 0);
+    REQUIRE(read_message(clients[2], received_msg) == 0);
+    REQUIRE(received_msg.header.time_stamp == 4);
+
+    // a client that is not in a room cannot send to it. Anything they
+    // published would reach the room's shard before the member's
+    // message that follows their pongs, and be delivered first.
+    REQUIRE(read_message(clients[1], received_msg) == 0);
+    REQUIRE(received_msg.header.time_stamp == 4);
+    REQUIRE(read_message(clients[3], received_msg) == 0);
+    REQUIRE(received_msg.header.time_stamp == 4);
+    message.header.time_stamp = 5;
+    REQUIRE(write_message(clients[3], message) == 0);
+    message.header.time_stamp = 6;
+    REQUIRE(write_message(clients[2], message) == 0);
+    sync_client(clients[3]);
+    sync_client(clients[2]);
+    message.header.time_stamp = 7;
+    REQUIRE(write_message(clients[0], message) == 0);
+    REQUIRE(read_message(clients[1], received_msg) == 0);
+    REQUIRE(received_msg.header.time_stamp == 7);
+
+    reactors.clear();
+    room_shards.clear();
+    for (int sock_fd : clients) {
+        close(sock_fd);
+    }
+}
+
+TEST_CASE("trace sampler picks a fixed share of reads", "[trace-sampler]") {
+    TraceSampler every_fourth(0.25);
+    int sampled = 0;
+    for (int i = 0; i < 100; i++) {
+        sampled += every_fourth.sample() ? 1 : 0;
+    }
+    REQUIRE(sampled == 25);
+
+    TraceSampler off(0);
+    TraceSampler all(1);
+    for (int i = 0; i < 10; i++) {
+        REQUIRE_FALSE(off.sample());
+        REQUIRE(all.sample());
+    }
+}
+
+TEST_CASE("reactor traces the stages of sampled messages", "[reactor-trace]") {
+    auto backend = GENERATE(MplexBackend::NATIVE, MplexBackend::URING);
+    const int n_messages = 10;
+    auto port = free_port();
+    auto &metrics = trace_metrics();
+    uint64_t decoded = metrics.read_decode.count();
+    uint64_t delivered = metrics.delivery.count();
+
+    BroadCaster broadcaster(DEFAULT_OUT_BUFFER_SIZE, SlowConsumerPolicy::DROP_OLDEST, backend);
+    std::vector<BroadCaster *> shards{&broadcaster};
+    server_config_t config{"127.0.0.1", port, 4, DEFAULT_OUT_BUFFER_SIZE,
+                           SlowConsumerPolicy::DROP_OLDEST, 1, DEFAULT_LISTEN_BACKLOG, 0, backend};
+    config.trace_sample = 1;
+    auto reactor = std::make_unique<Reactor>(config, 0, shards, nullptr);
+
+    int sender = connect_socket("127.0.0.1", port.c_str(), true);
+    REQUIRE(sender > 0);
+    int receiver = connect_socket("127.0.0.1", port.c_str(), true);
+    REQUIRE(receiver > 0);
+    sync_client(sender);
+    sync_client(receiver);
+
+    // the epoll reactor keeps reading until the socket is drained, so a
+    // message written while it reads is part of the same, traced, read
+    for (int i = 0; i < n_messages; i++) {
+        message_t message{{2, static_cast<uint64_t>(i), ""}, "hi"};
+        REQUIRE(write_message(sender, message) == 0);
+        message_t received_msg;
+        REQUIRE(read_message(receiver, received_msg) == 0);
+    }
+    uint64_t traced = metrics.read_decode.count() - decoded;
+    REQUIRE(traced > 0);
+    REQUIRE(traced <= static_cast<uint64_t>(n_messages));
+
+    drain_broadcaster(broadcaster);
+    REQUIRE(metrics.delivery.count() - delivered == traced);
+    REQUIRE(metrics.delivery.percentile(100) >= metrics.fan_out.percentile(0));
+
+    reactor.reset();
+    close(sender);
+    close(receiver);
+}
+
+TEST_CASE("only the shard that delivers a direct message traces it", "[reactor-trace]") {
+    const int n_messages = 10;
+    auto port = free_port();
+    auto &metrics = trace_metrics();
+    uint64_t decoded = metrics.read_decode.count();
+    uint64_t queued = metrics.queue_wait.count();
+    uint64_t delivered = metrics.delivery.count();
+
+    // both clients are on the reactor's own shard, the other one has
+    // no clients and misses every lookup
+    BroadCaster broadcaster;
+    BroadCaster other;
+    std::vector<BroadCaster *> shards{&broadcaster, &other};
+    server_config_t config{"127.0.0.1", port, 4, DEFAULT_OUT_BUFFER_SIZE,
+                           SlowConsumerPolicy::DROP_OLDEST, 2, DEFAULT_LISTEN_BACKLOG, 0,
+                           MplexBackend::NATIVE};
+    config.trace_sample = 1;
+    auto reactor = std::make_unique<Reactor>(config, 0, shards, nullptr);
+
+    int sender = connect_socket("127.0.0.1", port.c_str(), true);
+    REQUIRE(sender > 0);
+    int receiver = connect_socket("127.0.0.1", port.c_str(), true);
+    REQUIRE(receiver > 0);
+    auto target = client_name(receiver);
+    sync_client(sender);
+    sync_client(receiver);
+
+    for (int i = 0; i < n_messages; i++) {
+        message_t message{{2, static_cast<uint64_t>(i), ""}, "hi"};
+        snprintf(message.header.target, sizeof(message.header.target), "%s", target.c_str());
+        REQUIRE(write_message(sender, message) == 0);
+        message_t received_msg;
+        REQUIRE(read_message(receiver, received_msg) == 0);
+    }
+    uint64_t traced = metrics.read_decode.count() - decoded;
+    REQUIRE(traced > 0);
+
+    // once the sender has its pong every message is queued on both
+    // shards, and once they are drained both have recorded their traces
+    sync_client(sender);
+    drain_broadcaster(broadcaster);
+    drain_broadcaster(other);
+    REQUIRE(metrics.queue_wait.count() - queued == traced);
+    REQUIRE(metrics.delivery.count() - delivered == traced);
+
+    reactor.reset();
+    close(sender);
+    close(receiver);
+}
@@ -0,0 +1,81 @@
+// Test cases for Resolver class
+//
+// 17 October 2026
+
+#include "../Resolver.hpp"
+
+#include <catch2/catch_all.hpp>
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+
+static struct sockaddr_storage loopback()
+{
+    struct sockaddr_storage storage{};
+    auto addr = reinterpret_cast<struct sockaddr_in *>(&storage);
+    addr->sin_family = AF_INET;
+    addr->sin_port = htons(4000);
+    addr->sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    return storage;
+}
+
+// records the result of a lookup so it can be checked by the test
+struct lookup_t {
+    std::mutex mutex;
+    std::condition_variable done;
+    bool finished = false;
+    std::string host;
+    std::thread::id thread;
+
+    Resolver::callback_t callback()
+    {
+        return [this](const std::string &name) {
+            std::lock_guard<std::mutex> lock(mutex);
+            host = name;
+            thread = std::this_thread::get_id();
+            finished = true;
+            done.notify_all();
+        };
+    }
+
+    bool wait()
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        return done.wait_for(lock, std::chrono::seconds(10), [this] { return finished; });
+    }
+};
+
+TEST_CASE("resolver looks up hosts in the background and caches them", "[resolver]") {
+    Resolver resolver(2, RESOLVER_CACHE_SIZE);
+    auto addr = loopback();
+
+    lookup_t first;
+    REQUIRE(resolver.resolve(addr, first.callback()));
+    REQUIRE(first.wait());
+    REQUIRE_FALSE(first.host.empty());
+    REQUIRE(first.thread != std::this_thread::get_id());
+
+    // the same host on another port is answered from the cache
+    reinterpret_cast<struct sockaddr_in *>(&addr)->sin_port = htons(4001);
+    lookup_t second;
+    REQUIRE(resolver.resolve(addr, second.callback()));
+    REQUIRE(second.finished);
+    REQUIRE(second.host == first.host);
+    REQUIRE(second.thread == std::this_thread::get_id());
+}
+
+TEST_CASE("resolver drops requests it has not started on shutdown", "[resolver-shutdown]") {
+    auto addr = loopback();
+    lookup_t lookup;
+    {
+        Resolver resolver(0, RESOLVER_CACHE_SIZE);
+        REQUIRE(resolver.resolve(addr, lookup.callback()));
+    }
+    REQUIRE_FALSE(lookup.finished);
+}
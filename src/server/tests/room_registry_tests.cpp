@@ -0,0 +1,100 @@
+// Test cases for RoomRegistry and RoomShard classes
+//
+// 17 October 2026
+
+#include "../BroadCaster.hpp"
+#include "../RoomRegistry.hpp"
+#include "../RoomShard.hpp"
+
+#include <common/net_common.hpp>
+#include <common/utilities.hpp>
+
+#include <catch2/catch_all.hpp>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+static bool is_member(const RoomRegistry &rooms, std::string_view room, uint64_t id)
+{
+    auto members = rooms.members(room);
+    if (members == nullptr) {
+        return false;
+    }
+    auto same = [id](const room_member_t &member) { return member.id == id; };
+    return std::count_if(members->begin(), members->end(), same) == 1;
+}
+
+TEST_CASE("room registry tracks members of each room", "[room-registry]") {
+    room_member_t alice{10, 1, nullptr};
+    room_member_t bob{11, 2, nullptr};
+
+    RoomRegistry rooms;
+    REQUIRE(rooms.join(alice, "#games"));
+    REQUIRE(rooms.join(bob, "#games"));
+    REQUIRE(rooms.join(bob, "#news"));
+    REQUIRE(rooms.size() == 2);
+    REQUIRE(rooms.members("#games")->size() == 2);
+    REQUIRE(is_member(rooms, "#games", alice.id));
+    REQUIRE(is_member(rooms, "#news", bob.id));
+    REQUIRE_FALSE(is_member(rooms, "#news", alice.id));
+
+    SECTION("a client joins a room only once") {
+        REQUIRE_FALSE(rooms.join(alice, "#games"));
+        REQUIRE(rooms.members("#games")->size() == 2);
+    }
+
+    SECTION("targets that are not rooms are rejected") {
+        REQUIRE_FALSE(rooms.join(alice, "games"));
+        REQUIRE_FALSE(rooms.join(alice, "#"));
+        REQUIRE_FALSE(rooms.join(alice, ""));
+        REQUIRE(rooms.size() == 2);
+    }
+
+    SECTION("an empty room is deleted") {
+        REQUIRE(rooms.leave(bob.id, "#news"));
+        REQUIRE_FALSE(rooms.leave(bob.id, "#news"));
+        REQUIRE(rooms.members("#news") == nullptr);
+        REQUIRE(rooms.size() == 1);
+    }
+
+    SECTION("a later client on the same descriptor is someone else") {
+        room_member_t reused{alice.fd, 3, nullptr};
+        REQUIRE_FALSE(rooms.leave(reused.id, "#games"));
+        REQUIRE(rooms.join(reused, "#games"));
+        REQUIRE(rooms.leave(alice.id, "#games"));
+        REQUIRE(is_member(rooms, "#games", reused.id));
+    }
+}
+
+TEST_CASE("room shard delivers a room's messages in order", "[room-shard-order]") {
+    const int n_messages = 200;
+    BroadCaster broadcaster;
+    Channel member;
+    Channel sender;
+    broadcaster.add_client("member", member.get_write_end(), 1);
+    broadcaster.add_client("sender", sender.get_write_end(), 2);
+
+    auto shard = std::make_unique<RoomShard>(ROOM_SHARD_NO_CPU);
+    shard->join({member.get_write_end(), 1, &broadcaster}, "#ordered");
+    shard->join({sender.get_write_end(), 2, &broadcaster}, "#ordered");
+
+    for (int i = 0; i < n_messages; i++) {
+        message_t message{{1, static_cast<uint64_t>(i), "#ordered"}, "x"};
+        shard->publish({sender.get_write_end(), 2, nullptr}, make_frame(message));
+    }
+    for (int i = 0; i < n_messages; i++) {
+        message_t received_msg;
+        REQUIRE(read_message(member.get_read_end(), received_msg) == 0);
+        REQUIRE(received_msg.header.time_stamp == static_cast<uint64_t>(i));
+    }
+
+    // a frame for an id the broadcaster does not know is dropped
+    broadcaster.send_frame(member.get_write_end(), 7, make_frame({{1, 0, ""}, "y"}));
+    message_t last{{1, 1000, "#ordered"}, "z"};
+    shard->publish({sender.get_write_end(), 2, nullptr}, make_frame(last));
+    message_t received_msg;
+    REQUIRE(read_message(member.get_read_end(), received_msg) == 0);
+    REQUIRE(received_msg.header.time_stamp == 1000);
+    shard.reset();
+}
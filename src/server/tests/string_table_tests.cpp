@@ -0,0 +1,76 @@
+// Test cases for StringTable class
+//
+// 17 October 2026
+
+#include "../StringTable.hpp"
+
+#include <catch2/catch_all.hpp>
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+TEST_CASE("string table owns interned strings", "[string-table-intern]") {
+    StringTable table;
+    std::string name = "127.0.0.1";
+    auto interned = table.intern(name);
+
+    REQUIRE(interned == "127.0.0.1");
+    REQUIRE(interned.data() != name.data());
+    REQUIRE(interned.data()[interned.size()] == '\0');
+
+    // the copy outlives the string it was made from
+    name.assign("somebody else");
+    REQUIRE(interned == "127.0.0.1");
+    REQUIRE(table.size() == 1);
+}
+
+TEST_CASE("string table shares equal strings", "[string-table-share]") {
+    StringTable table;
+    auto first = table.intern("alice");
+    auto second = table.intern(std::string("alice"));
+    REQUIRE(first.data() == second.data());
+    REQUIRE(table.size() == 1);
+
+    // the string is only freed with its last reference
+    REQUIRE(table.release(first));
+    REQUIRE(table.size() == 1);
+    REQUIRE(second == "alice");
+    REQUIRE(table.release(second));
+    REQUIRE(table.size() == 0);
+    REQUIRE_FALSE(table.release(second));
+}
+
+TEST_CASE("string table reuses released space", "[string-table-reuse]") {
+    StringTable table;
+    auto first = table.intern("bob");
+    const char *slot = first.data();
+    REQUIRE(table.release(first));
+
+    auto second = table.intern("eve");
+    REQUIRE(second.data() == slot);
+    REQUIRE(second == "eve");
+}
+
+TEST_CASE("string table keeps addresses stable as it grows", "[string-table-stable]") {
+    StringTable table;
+    std::vector<std::string_view> interned;
+    for (int i = 0; i < 10000; i++) {
+        interned.push_back(table.intern("client" + std::to_string(i)));
+    }
+    REQUIRE(table.size() == 10000);
+    REQUIRE(table.n_chunks() > 1);
+    for (int i = 0; i < 10000; i++) {
+        REQUIRE(interned[i] == "client" + std::to_string(i));
+    }
+}
+
+TEST_CASE("string table rejects strings that are too long", "[string-table-long]") {
+    StringTable table;
+    std::string longest(CLIENT_NAME_MAX_SIZE - 1, 'a');
+    REQUIRE(table.intern(longest) == longest);
+
+    std::string too_long(CLIENT_NAME_MAX_SIZE, 'a');
+    REQUIRE(table.intern(too_long).data() == nullptr);
+    REQUIRE(table.size() == 1);
+}